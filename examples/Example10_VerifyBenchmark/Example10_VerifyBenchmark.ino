@@ -0,0 +1,107 @@
+/*
+  Using the SparkFun Cryptographic Co-processor Breakout ATECC508a (Qwiic)
+  SparkFun Electronics
+  License: This code is public domain but you can buy me a beer if you use this and we meet someday (Beerware license).
+
+  Feel like supporting our work? Please buy a board from SparkFun!
+  https://www.sparkfun.com/products/15573
+
+  This example compares signature verification on the IC with verification in software on your microcontroller.
+
+  Verifying a signature only needs public data (message, signature and public key), so it does not have to
+  run on the IC. On the IC, it takes two commands (NONCE and VERIFY), ~65ms of execution time and
+  ~160 bytes of I2C traffic. On a fast microcontroller, software can be quicker, and it leaves the IC free.
+
+  setI2CClock() speeds up the I2C transfers, see setup().
+
+  verifySignature() chooses automatically (VERIFY_POLICY_AUTO), based on the measured time of each.
+  You can force one or the other with setVerifyPolicy().
+
+  Note, on slow 8-bit boards (e.g. Uno), a software verify takes several seconds.
+
+  Hardware Connections and initial setup:
+  Plug in your controller board (e.g. Artemis Redboard, Nano, ATP) into your computer with USB cable.
+  Connect your Cryptographic Co-processor to your controller board via a qwiic cable.
+  Select TOOLS>>BOARD>>"SparkFun Redboard Artemis"
+  Select TOOLS>>PORT>> "COM 3" (note, yours may be different)
+  Click upload, and follow along on serial monitor at 115200.
+
+*/
+
+#include <SparkFun_ATECCX08a_Arduino_Library.h> //Click here to get the library: http://librarymanager/All#SparkFun_ATECCX08a
+#include <Wire.h>
+
+ATECCX08A atecc;
+
+#define ROUNDS 5
+
+uint8_t message[32] = {
+  0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0A, 0x0B, 0x0C, 0x0D, 0x0E, 0x0F,
+  0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18, 0x19, 0x1A, 0x1B, 0x1C, 0x1D, 0x1E, 0x1F
+};
+
+void setup() {
+  Wire.begin();
+  Serial.begin(115200);
+  if (atecc.begin() == true)
+  {
+    Serial.println("Successful wakeUp(). I2C connections are good.");
+  }
+  else
+  {
+    Serial.println("Device not found. Check wiring.");
+    while (1); // stall out forever
+  }
+
+  // Data transfers at 400kHz (the IC supports up to 1MHz), only the wake pulse runs at 100kHz.
+  // This makes the 128-byte VERIFY frame about 4x quicker on the bus.
+  atecc.setI2CClock(400000);
+
+  atecc.readConfigZone(false); // Debug argument false (OFF)
+
+  // check to see if Config, Data and Slot 0 are locked (see Example1)
+  if (!(atecc.configLockStatus && atecc.dataOTPLockStatus && atecc.slot0LockStatus))
+  {
+    Serial.print("Device not configured. Please use the configuration sketch.");
+    while (1); // stall out forever.
+  }
+
+  // Something to verify: sign the message with the private key in slot 0
+  atecc.generatePublicKey(0, false);
+  atecc.createSignature(message);
+
+  benchmark("IC (verifySignatureDevice)", false);
+  benchmark("Software (verifySignatureSoftware)", true);
+
+  Serial.print("verifySignature() will use: ");
+  if (atecc.softwareVerifyPreferred()) Serial.println("software");
+  else Serial.println("the IC");
+}
+
+void loop()
+{
+  // do nothing.
+}
+
+void benchmark(const char *label, bool software)
+{
+  bool allValid = true;
+  unsigned long startMicros = micros();
+
+  for (int i = 0; i < ROUNDS; i++)
+  {
+    bool valid;
+    if (software) valid = atecc.verifySignatureSoftware(message, atecc.signature, atecc.publicKey64Bytes);
+    else valid = atecc.verifySignatureDevice(message, atecc.signature, atecc.publicKey64Bytes);
+    allValid = allValid && valid;
+  }
+
+  unsigned long averageMicros = (micros() - startMicros) / ROUNDS;
+
+  Serial.print(label);
+  Serial.print(": ");
+  Serial.print(averageMicros);
+  Serial.print(" us per verify, signature ");
+  if (allValid) Serial.println("valid.");
+  else Serial.println("NOT valid.");
+}
@@ -0,0 +1,154 @@
+/*
+  Using the SparkFun Cryptographic Co-processor Breakout ATECC508a (Qwiic)
+  SparkFun Electronics
+  License: This code is public domain but you can buy me a beer if you use this and we meet someday (Beerware license).
+
+  Feel like supporting our work? Please buy a board from SparkFun!
+  https://www.sparkfun.com/products/15573
+
+  This example shares one Cryptographic Co-processor between several FreeRTOS tasks (ESP32 only).
+
+  Without a lock, two tasks calling the library at the same time mix up their commands on the I2C bus,
+  and overwrite each other's results in inputBuffer[], signature[] and so on.
+  With atecc.setLock(&lock), every library call is atomic against the IC.
+
+  It also shows the request queue: a worker task owns the IC and runs requests for the other tasks.
+  A task submits a request and is free to do other work, then picks up the result.
+
+  The tasks check every result, so this doubles as a stress test: leave it running, and the
+  error count should stay at 0. Comment out setLock() to see what happens without it.
+
+  Note, this requires that your device be configured with SparkFun Standard Configuration settings.
+  If you haven't already, configure your device using Example1_Configuration.
+
+  Hardware Connections and initial setup:
+  Plug in your ESP32 board (e.g. SparkFun Thing Plus ESP32) into your computer with USB cable.
+  Connect your Cryptographic Co-processor to your controller board via a qwiic cable.
+  Select TOOLS>>BOARD>>"SparkFun ESP32 Thing Plus"
+  Select TOOLS>>PORT>> "COM 3" (note, yours may be different)
+  Click upload, and follow along on serial monitor at 115200.
+
+*/
+
+#include <SparkFun_ATECCX08a_Arduino_Library.h> //Click here to get the library: http://librarymanager/All#SparkFun_ATECCX08a
+#include <SparkFun_ATECCX08a_Concurrency.h>
+#include <SparkFun_ATECCX08a_SHA256.h>
+#include <Wire.h>
+
+#if !defined(ESP32)
+#error "This example needs FreeRTOS tasks, please select an ESP32 board"
+#endif
+
+ATECCX08A atecc;
+ATECCX08A_FreeRTOSLock lock;
+ATECCX08A_Queue queue(atecc);
+
+uint8_t publicKey[PUBLIC_KEY_SIZE];
+
+volatile unsigned long operations = 0;
+volatile unsigned long errors = 0;
+
+// inputs and outputs of a queued signing job
+typedef struct {
+  uint8_t message[32];
+  uint8_t signature[SIGNATURE_SIZE];
+} SignJob;
+
+bool signJob(ATECCX08A &device, void *context)
+{
+  SignJob *job = (SignJob *)context;
+  return device.createSignature(job->message, 0, job->signature);
+}
+
+void setup() {
+  Wire.begin();
+  Serial.begin(115200);
+  if (atecc.begin() == true)
+  {
+    Serial.println("Successful wakeUp(). I2C connections are good.");
+  }
+  else
+  {
+    Serial.println("Device not found. Check wiring.");
+    while (1); // stall out forever
+  }
+
+  atecc.readConfigZone(false); // Debug argument false (OFF)
+
+  // check to see if Config, Data and Slot 0 are locked (see Example1)
+  if (!(atecc.configLockStatus && atecc.dataOTPLockStatus && atecc.slot0LockStatus))
+  {
+    Serial.print("Device not configured. Please use the configuration sketch.");
+    while (1); // stall out forever.
+  }
+
+  atecc.generatePublicKey(0, false, publicKey);
+
+  atecc.setLock(&lock); // before any other task uses the IC
+
+  xTaskCreate(workerTask, "worker", 4096, NULL, 2, NULL);
+  xTaskCreate(hashTask, "hash1", 4096, (void *)1, 1, NULL);
+  xTaskCreate(hashTask, "hash2", 4096, (void *)2, 1, NULL);
+  xTaskCreate(signTask, "sign", 8192, NULL, 1, NULL);
+}
+
+void loop()
+{
+  Serial.print("operations: ");
+  Serial.print(operations);
+  Serial.print(", errors: ");
+  Serial.println(errors);
+  delay(1000);
+}
+
+// owns the IC for queued requests
+void workerTask(void *parameter)
+{
+  while (1)
+  {
+    if (!queue.process())
+      vTaskDelay(1); // nothing queued
+  }
+}
+
+// calls the library directly, compares the IC's SHA-256 with the software one
+void hashTask(void *parameter)
+{
+  uint8_t id = (uintptr_t)parameter;
+  uint8_t data[100];
+  uint8_t hash[SHA256_SIZE];
+  uint8_t expected[SHA256_SIZE];
+
+  for (uint32_t round = 0; ; round++)
+  {
+    size_t length = 1 + (round % sizeof(data));
+    for (size_t i = 0; i < length; i++) data[i] = id + round + i;
+
+    bool ok = atecc.sha256(data, length, hash);
+    ATECCX08A_SHA256::hash(data, length, expected);
+
+    if (!ok || (memcmp(hash, expected, SHA256_SIZE) != 0)) errors++;
+    operations++;
+  }
+}
+
+// queues signatures for the worker, and does other work while they are being made
+void signTask(void *parameter)
+{
+  SignJob job;
+  ATECCX08A_Request request;
+
+  while (1)
+  {
+    atecc.updateRandom32Bytes(false, job.message);
+
+    while (!queue.submit(&request, signJob, &job))
+      vTaskDelay(1); // queue full
+
+    while (!ATECCX08A_Queue::done(&request))
+      vTaskDelay(1); // free to do other things here
+
+    if (!request.result || !atecc.verifySignatureSoftware(job.message, job.signature, publicKey)) errors++;
+    operations++;
+  }
+}
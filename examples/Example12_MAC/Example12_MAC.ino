@@ -0,0 +1,157 @@
+/*
+  Using the SparkFun Cryptographic Co-processor Breakout ATECC508a (Qwiic)
+  SparkFun Electronics
+  License: This code is public domain but you can buy me a beer if you use this and we meet someday (Beerware license).
+
+  Feel like supporting our work? Please buy a board from SparkFun!
+  https://www.sparkfun.com/products/15573
+
+  This example shows symmetric challenge-response authentication with the MAC and CheckMac commands.
+
+  A signature based handshake (Example6) takes ~70ms for SIGN plus ~58ms for VERIFY.
+  With a shared secret key, the prover answers a challenge with mac() and the verifier
+  checks it with checkMac(), each taking only a few ms. The key never leaves either IC.
+  This suits frequent messages, like heartbeats from a device to a hub.
+
+  mac(slot, challenge, digest);     // prover: 32-byte digest of the key in slot and the challenge
+  checkMac(slot, challenge, digest); // verifier: true if the digest was made with the same key
+
+  Both ICs hold the same key in the same slot. Here, one IC plays both roles.
+  A hub without an IC can check digests in software with ATECCX08A::calculateMac().
+
+  Key setup happens during configuration, before the data zone is locked:
+  macSlotConfig() sets up the slot in a config image (written with provisionConfig()),
+  then writeMacKey() stores the key.
+
+  Hardware Connections and initial setup:
+  This requires a NEW (unconfigured) Cryptographic Co-processor, as the MAC key slot
+  must be set up before the config and data zones are locked. It is configured with the
+  SparkFun Standard settings (as in Example1), plus a MAC key in slot 9.
+  Plug in your controller board (e.g. Artemis Redboard, Nano, ATP) into your computer with USB cable.
+  Connect your Cryptographic Co-processor to your controller board via a qwiic cable.
+  Select TOOLS>>BOARD>>"SparkFun Redboard Artemis"
+  Select TOOLS>>PORT>> "COM 3" (note, yours may be different)
+  Click upload, and follow prompts on serial monitor at 115200.
+
+*/
+
+#include <SparkFun_ATECCX08a_Arduino_Library.h> //Click here to get the library: http://librarymanager/All#SparkFun_ATECCX08a
+#include <Wire.h>
+
+ATECCX08A atecc;
+
+#define MAC_SLOT 9
+
+// Use your own random key, and keep it secret. Every device that authenticates with it needs the same key.
+uint8_t macKey[MAC_KEY_SIZE] = {
+  0x2B, 0x7E, 0x15, 0x16, 0x28, 0xAE, 0xD2, 0xA6, 0xAB, 0xF7, 0x15, 0x88, 0x09, 0xCF, 0x4F, 0x3C,
+  0x76, 0x2E, 0x71, 0x60, 0xF3, 0x8B, 0x4D, 0xA5, 0x6A, 0x78, 0x4D, 0x90, 0x45, 0x19, 0x0C, 0xFE
+};
+
+void setup() {
+  Wire.begin();
+  Serial.begin(115200);
+  if (atecc.begin() == true)
+  {
+    Serial.println("Successful wakeUp(). I2C connections are good.");
+  }
+  else
+  {
+    Serial.println("Device not found. Check wiring.");
+    while (1); // stall out forever
+  }
+
+  atecc.readConfigZone(false); // Debug argument false (OFF)
+
+  if (!atecc.configLockStatus)
+    configure();
+
+  if (!atecc.slotAllows(MAC_SLOT, SLOT_ALLOW_MAC))
+  {
+    Serial.println("Slot 9 is not set up for a MAC key. This example needs a new device.");
+    while (1); // stall out forever.
+  }
+}
+
+void loop()
+{
+  uint8_t challenge[MAC_CHALLENGE_SIZE];
+  uint8_t digest[RESPONSE_MAC_SIZE];
+
+  // verifier: a fresh challenge for every heartbeat
+  atecc.updateRandom32Bytes(false, challenge);
+
+  // prover: answer the challenge
+  unsigned long startMicros = micros();
+  bool made = atecc.mac(MAC_SLOT, challenge, digest);
+  unsigned long macMicros = micros() - startMicros;
+
+  // verifier: check the answer
+  startMicros = micros();
+  bool valid = made && atecc.checkMac(MAC_SLOT, challenge, digest);
+  unsigned long checkMicros = micros() - startMicros;
+
+  Serial.print("mac(): ");
+  Serial.print(macMicros);
+  Serial.print(" us, checkMac(): ");
+  Serial.print(checkMicros);
+  Serial.print(" us, heartbeat ");
+  if (valid) Serial.println("authentic.");
+  else Serial.println("NOT authentic.");
+
+  // a digest from a device with a different key, or for another challenge, is rejected
+  digest[0] ^= 0x01;
+  Serial.print("Tampered digest: ");
+  if (atecc.checkMac(MAC_SLOT, challenge, digest)) Serial.println("accepted (unexpected!)");
+  else Serial.println("rejected.");
+
+  delay(1000);
+}
+
+void configure()
+{
+  uint8_t config[CONFIG_ZONE_SIZE];
+
+  Serial.println("Would you like to configure your Cryptographic Co-processor with SparkFun Standard settings and a MAC key in slot 9? (y/n)");
+  Serial.println("***Note, this is PERMANENT and cannot be changed later***");
+  Serial.println("***If you do not want to do this, type an 'n' or unplug now.***");
+
+  while (Serial.available() == 0); // wait for user input
+
+  if (Serial.read() != 'y')
+  {
+    Serial.println("Unfortunately, you cannot use any features of the ATECCX08A without configuration and locking.");
+    while (1); // stall out forever.
+  }
+
+  Serial.print("Write Config: \t");
+  if (atecc.writeConfigSparkFun() == true) Serial.println("Success!");
+  else Serial.println("Failure.");
+
+  // SparkFun Standard settings (now in configZone[]), plus the MAC key slot
+  memcpy(config, atecc.configZone, CONFIG_ZONE_SIZE);
+  ATECCX08A::macSlotConfig(config, MAC_SLOT);
+
+  Serial.print("MAC Slot, Lock Config: \t");
+  if (atecc.provisionConfig(config) == true) Serial.println("Success!");
+  else Serial.println("Failure.");
+
+  Serial.print("Key Creation: \t");
+  if (atecc.createNewKeyPair() == true) Serial.println("Success!");
+  else Serial.println("Failure.");
+
+  // must happen before the data zone is locked
+  Serial.print("MAC Key: \t");
+  if (atecc.writeMacKey(MAC_SLOT, macKey) == true) Serial.println("Success!");
+  else Serial.println("Failure.");
+
+  Serial.print("Lock Data-OTP: \t");
+  if (atecc.lockDataAndOTP() == true) Serial.println("Success!");
+  else Serial.println("Failure.");
+
+  Serial.print("Lock Slot 0: \t");
+  if (atecc.lockDataSlot0() == true) Serial.println("Success!");
+  else Serial.println("Failure.");
+
+  atecc.readConfigZone(false);
+}
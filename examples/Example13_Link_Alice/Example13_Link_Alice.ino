@@ -0,0 +1,114 @@
+/*
+  Using the SparkFun Cryptographic Co-processor Breakout ATECC508a (Qwiic)
+  SparkFun Electronics
+  License: This code is public domain but you can buy me a beer if you use this and we meet someday (Beerware license).
+
+  Feel like supporting our work? Please buy a board from SparkFun!
+  https://www.sparkfun.com/products/15573
+
+  This example is the challenge-response of Example6, over the framed link (ATECCX08A_Link).
+
+  Example6 sends raw bytes, and waits for a fixed number of them to arrive. One lost or extra
+  byte, and the handshake hangs or verifies garbage. Here every message is a frame with a
+  length, a sequence number and a CRC. Bad frames are dropped, the parser finds the next one,
+  and Alice just asks again. Nothing blocks: loop() keeps running while the messages travel.
+
+  Alice (this sketch) is the prover. Every 2 seconds she asks Bob for a challenge,
+  signs it with the private key in slot 0, and sends the signature back.
+  Bob (Example13_Link_Bob) verifies it and sends back the result.
+
+  Hardware Connections and initial setup:
+  Same as Example6: two boards, each with a Cryptographic Co-processor configured with
+  SparkFun Standard settings (Example1_Configuration). Connect:
+  Alice's TX1 pin -->> Bob's RX1 pin.
+  Alice's RX1 pin -->> Bob's TX1 pin.
+  Alice's GND pin -->> Bob's GND pin.
+  Upload this sketch, then copy the public key it prints into the top of Example13_Link_Bob.
+  Open the serial monitor at 115200.
+*/
+
+#include <SparkFun_ATECCX08a_Arduino_Library.h> //Click here to get the library: http://librarymanager/All#SparkFun_ATECCX08a
+#include <SparkFun_ATECCX08a_Link.h>
+#include <Wire.h>
+
+ATECCX08A atecc;
+ATECCX08A_Link link(atecc, Serial1);
+
+uint8_t requestSequence; // sequence number of our last request
+unsigned long requestMillis = 0;
+
+void setup() {
+  Wire.begin();
+  Serial.begin(115200);   // debug
+  Serial1.begin(115200);  // Alice's TX1/RX1 <<-->> Bob's TX1/RX1
+
+  if (atecc.begin() == true)
+  {
+    Serial.println("Successful wakeUp(). I2C connections are good.");
+  }
+  else
+  {
+    Serial.println("Device not found. Check wiring.");
+    while (1); // stall out forever
+  }
+
+  atecc.readConfigZone(false); // Debug argument false (OFF)
+
+  // check for configuration
+  if (!(atecc.configLockStatus && atecc.dataOTPLockStatus && atecc.slot0LockStatus))
+  {
+    Serial.print("Device not configured. Please use the configuration sketch.");
+    while (1); // stall out forever.
+  }
+
+  atecc.generatePublicKey(0, false);
+  printAlicesPublicKey();
+}
+
+void loop()
+{
+  ATECCX08A_LinkFrame frame;
+
+  // ask for a new challenge every 2 seconds
+  if ((requestMillis == 0) || (millis() - requestMillis > 2000))
+  {
+    link.sendRequest(&requestSequence);
+    requestMillis = millis();
+  }
+
+  if (link.receive(&frame))
+  {
+    if ((frame.type == LINK_TYPE_CHALLENGE) && (frame.sequence == requestSequence))
+    {
+      // sign the challenge (in a single wake of the IC), and send the signature to Bob
+      if (!link.sendResponse(&frame)) Serial.println("Signing failed.");
+    }
+    else if (frame.type == LINK_TYPE_RESULT)
+    {
+      Serial.print("Bob says: ");
+      if (frame.payload[0] == 1) Serial.println("authenticated.");
+      else Serial.println("NOT authenticated.");
+    }
+  }
+
+  // other work goes here, nothing above waits for the link
+}
+
+// print out this devices public key (Alice's Public Key)
+// with the array named perfectly for copy/pasting: "AlicesPublicKey"
+void printAlicesPublicKey()
+{
+  Serial.println("**Copy/paste the following public key (alice's) into the top of Example13_Link_Bob sketch.**");
+  Serial.println();
+  Serial.println("uint8_t AlicesPublicKey[64] = {");
+  for (int i = 0; i < sizeof(atecc.publicKey64Bytes) ; i++)
+  {
+    Serial.print("0x");
+    if ((atecc.publicKey64Bytes[i] >> 4) == 0) Serial.print("0"); // print preceeding high nibble if it's zero
+    Serial.print(atecc.publicKey64Bytes[i], HEX);
+    if (i != 63) Serial.print(", ");
+    if ((63 - i) % 16 == 0) Serial.println();
+  }
+  Serial.println("};");
+  Serial.println();
+}
@@ -0,0 +1,91 @@
+/*
+  Using the SparkFun Cryptographic Co-processor Breakout ATECC508a (Qwiic)
+  SparkFun Electronics
+  License: This code is public domain but you can buy me a beer if you use this and we meet someday (Beerware license).
+
+  Feel like supporting our work? Please buy a board from SparkFun!
+  https://www.sparkfun.com/products/15573
+
+  This example is the challenge-response of Example6, over the framed link (ATECCX08A_Link).
+
+  Bob (this sketch) is the verifier. For every request from Alice (Example13_Link_Alice),
+  he creates a fresh random challenge on his IC and sends it. When her signature comes back,
+  he verifies it with her public key, and tells her the result.
+
+  Each challenge can be answered once, and only within 500 ms (setChallengeTimeout()).
+  Up to LINK_PENDING_CHALLENGES challenges can be in flight at once, each matched to its
+  answer by sequence number, so a slow or lost answer never blocks the next exchange.
+
+  Hardware Connections and initial setup:
+  See Example13_Link_Alice. Paste Alice's public key below, then upload.
+  Open the serial monitor at 115200.
+*/
+
+#include <SparkFun_ATECCX08a_Arduino_Library.h> //Click here to get the library: http://librarymanager/All#SparkFun_ATECCX08a
+#include <SparkFun_ATECCX08a_Link.h>
+#include <Wire.h>
+
+ATECCX08A atecc;
+ATECCX08A_Link link(atecc, Serial1);
+
+// Delete this "blank" public key,
+// copy/paste Alice's true unique public key from her terminal printout in Example13_Link_Alice.
+
+uint8_t AlicesPublicKey[64] = {
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00
+};
+
+void setup() {
+  Wire.begin();
+  Serial.begin(115200);   // debug
+  Serial1.begin(115200);  // Alice's TX1/RX1 <<-->> Bob's TX1/RX1
+
+  if (atecc.begin() == true)
+  {
+    Serial.println("Successful wakeUp(). I2C connections are good.");
+  }
+  else
+  {
+    Serial.println("Device not found. Check wiring.");
+    while (1); // stall out forever
+  }
+
+  atecc.readConfigZone(false); // Debug argument false (OFF)
+
+  // check for configuration
+  if (!(atecc.configLockStatus && atecc.dataOTPLockStatus && atecc.slot0LockStatus))
+  {
+    Serial.print("Device not configured. Please use the configuration sketch.");
+    while (1); // stall out forever.
+  }
+
+  link.setChallengeTimeout(500);
+
+  Serial.println("Hi I'm Bob, I'm listening for requests from Alice on my RX1 pin.");
+  Serial.println();
+}
+
+void loop()
+{
+  ATECCX08A_LinkFrame frame;
+
+  if (link.receive(&frame))
+  {
+    if (frame.type == LINK_TYPE_REQUEST)
+    {
+      if (!link.sendChallenge(frame.sequence)) Serial.println("Too many challenges in flight.");
+    }
+    else if (frame.type == LINK_TYPE_RESPONSE)
+    {
+      Serial.print("Response ");
+      Serial.print(frame.sequence);
+      if (link.checkResponse(&frame, AlicesPublicKey)) Serial.print(": verified.");
+      else Serial.print(": NOT verified (bad signature, expired or unknown challenge).");
+      Serial.print(" Dropped frames so far: ");
+      Serial.println(link.droppedFrames());
+    }
+  }
+}
@@ -0,0 +1,117 @@
+/*
+  Using the SparkFun Cryptographic Co-processor Breakout ATECC508a (Qwiic)
+  SparkFun Electronics
+  License: This code is public domain but you can buy me a beer if you use this and we meet someday (Beerware license).
+
+  Feel like supporting our work? Please buy a board from SparkFun!
+  https://www.sparkfun.com/products/15573
+
+  This example shows how to fit crypto into the slack time of a fixed-rate control loop,
+  with setDeadline().
+
+  Every CONTROL_PERIOD_MS, the control step runs first. The time left until the next step
+  is the deadline for the crypto work. Before each command, the library checks that the
+  command can finish before the deadline. If it cannot, the command is not sent, the IC
+  goes to idle, and the call returns false with ATECC_STATUS_DEADLINE. The work is then
+  tried again in the next period. A command is never cut off half way.
+
+  Here, the work is signing a message once (NONCE and SIGN take up to ~120ms together),
+  and reading 32 random bytes (~23ms) every period. The signature waits for a period with
+  enough time left after the random bytes.
+
+  cancel() stops a call at its next command, e.g. from a button interrupt.
+
+  Note, this requires that your device be configured with SparkFun Standard Configuration settings.
+
+  Hardware Connections and initial setup:
+  Plug in your controller board (e.g. Artemis Redboard, Nano, ATP) into your computer with USB cable.
+  Connect your Cryptographic Co-processor to your controller board via a qwiic cable.
+  Select TOOLS>>BOARD>>"SparkFun Redboard Artemis"
+  Select TOOLS>>PORT>> "COM 3" (note, yours may be different)
+  Click upload, and follow prompts on serial monitor at 115200.
+
+*/
+
+#include <SparkFun_ATECCX08a_Arduino_Library.h> //Click here to get the library: http://librarymanager/All#SparkFun_ATECCX08a
+#include <Wire.h>
+
+ATECCX08A atecc;
+
+#define CONTROL_PERIOD_MS 200
+#define CONTROL_STEP_MS 5 // stand-in for the real control work
+
+uint8_t message[32] = {
+  0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0A, 0x0B, 0x0C, 0x0D, 0x0E, 0x0F,
+  0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18, 0x19, 0x1A, 0x1B, 0x1C, 0x1D, 0x1E, 0x1F
+};
+
+unsigned long nextPeriodMicros;
+unsigned long periods = 0;
+unsigned long missed = 0; // should stay 0
+unsigned long deferred = 0;
+bool signedMessage = false;
+
+void setup() {
+  Wire.begin();
+  Serial.begin(115200);
+  if (atecc.begin() == true)
+  {
+    Serial.println("Successful wakeUp(). I2C connections are good.");
+  }
+  else
+  {
+    Serial.println("Device not found. Check wiring.");
+    while (1); // stall out forever
+  }
+
+  atecc.readConfigZone(false); // Debug argument false (OFF)
+
+  if (!(atecc.configLockStatus && atecc.dataOTPLockStatus && atecc.slot0LockStatus))
+  {
+    Serial.print("Device not configured. Please use the configuration sketch.");
+    while (1); // stall out forever.
+  }
+
+  nextPeriodMicros = micros();
+}
+
+void loop()
+{
+  // wait for the start of the next period
+  while ((long)(micros() - nextPeriodMicros) < 0);
+  if ((long)(micros() - nextPeriodMicros) > 1000)
+    missed++;
+  nextPeriodMicros += CONTROL_PERIOD_MS * 1000UL;
+  periods++;
+
+  delay(CONTROL_STEP_MS); // the control step
+
+  // crypto in the time that is left
+  atecc.setDeadline(nextPeriodMicros);
+
+  if (atecc.updateRandom32Bytes() == false)
+    deferred++;
+
+  if (!signedMessage)
+  {
+    if (atecc.createSignature(message))
+      signedMessage = true;
+    else if (atecc.lastStatus() == ATECC_STATUS_DEADLINE)
+      deferred++; // not enough time left in this period, try again in the next one
+  }
+
+  atecc.clearDeadline();
+
+  if ((periods % 100) == 0)
+  {
+    Serial.print("periods: ");
+    Serial.print(periods);
+    Serial.print(", missed: ");
+    Serial.print(missed);
+    Serial.print(", deferred: ");
+    Serial.print(deferred);
+    Serial.print(", signed: ");
+    Serial.println(signedMessage ? "yes" : "no");
+    nextPeriodMicros = micros(); // printing took time, start a new period
+  }
+}
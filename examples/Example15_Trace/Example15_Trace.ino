@@ -0,0 +1,122 @@
+/*
+  Using the SparkFun Cryptographic Co-processor Breakout ATECC508a (Qwiic)
+  SparkFun Electronics
+  License: This code is public domain but you can buy me a beer if you use this and we meet someday (Beerware license).
+
+  Feel like supporting our work? Please buy a board from SparkFun!
+  https://www.sparkfun.com/products/15573
+
+  This example shows how to record the I2C traffic between the library and the IC,
+  and how to replay it without the IC.
+
+  ATECCX08A_Trace sits between the library and Wire (atecc.setBus(&trace)), and records
+  every transaction (wake, command, response, idle) with its timing into a ring buffer.
+  When a board in the field shows an intermittent count or CRC error, record() from
+  begin() on, and dump the trace with printArray() once the error shows up.
+
+  replay() then feeds the recorded transactions back into the library, in place of the IC.
+  The library runs through the exact same bytes (and the same error), so the bug can be
+  reproduced on the bench, or on a PC. The replay also checks that the library writes the
+  same bytes as it did while recording (mismatches()), and keeps the same timing
+  (timingError(), timingDrift()), so a trace of a good run is a regression fixture too.
+
+  Here, the sketch records begin() and a signature, prints the trace, and replays it.
+
+  Note, this requires that your device be configured with SparkFun Standard Configuration settings.
+
+  Hardware Connections and initial setup:
+  Plug in your controller board (e.g. Artemis Redboard, Nano, ATP) into your computer with USB cable.
+  Connect your Cryptographic Co-processor to your controller board via a qwiic cable.
+  Select TOOLS>>BOARD>>"SparkFun Redboard Artemis"
+  Select TOOLS>>PORT>> "COM 3" (note, yours may be different)
+  Click upload, and follow prompts on serial monitor at 115200.
+
+*/
+
+#include <SparkFun_ATECCX08a_Arduino_Library.h> //Click here to get the library: http://librarymanager/All#SparkFun_ATECCX08a
+#include <SparkFun_ATECCX08a_Trace.h>
+#include <Wire.h>
+
+ATECCX08A atecc;
+
+uint8_t traceBuffer[1024]; // ring buffer, the oldest transactions are dropped when it is full
+ATECCX08A_Trace trace(traceBuffer, sizeof(traceBuffer));
+
+uint8_t recorded[sizeof(traceBuffer)];
+size_t recordedLength;
+
+uint8_t message[32] = {
+  0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0A, 0x0B, 0x0C, 0x0D, 0x0E, 0x0F,
+  0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18, 0x19, 0x1A, 0x1B, 0x1C, 0x1D, 0x1E, 0x1F
+};
+
+void setup() {
+  Wire.begin();
+  Serial.begin(115200);
+
+  // record everything from begin() on
+  atecc.setBus(&trace);
+  trace.record();
+
+  if (atecc.begin() == true)
+  {
+    Serial.println("Successful wakeUp(). I2C connections are good.");
+  }
+  else
+  {
+    Serial.println("Device not found. Check wiring.");
+    while (1); // stall out forever
+  }
+
+  bool signedMessage = atecc.createSignature(message);
+  trace.stop();
+
+  Serial.print("Recorded ");
+  Serial.print(trace.transactions());
+  Serial.print(" transactions in ");
+  Serial.print(trace.length());
+  Serial.println(" bytes:");
+  trace.print(Serial);
+  Serial.println();
+  trace.printArray(Serial, "recorded"); // paste this into a sketch or a test, and replay() it there
+  Serial.println();
+
+  recordedLength = trace.copy(recorded, sizeof(recorded));
+
+  // replay: the same calls, served from the trace (the IC is not used)
+  ATECCX08A replayed;
+  ATECCX08A_Trace replay(NULL, 0);
+  replayed.setBus(&replay);
+  replay.replay(recorded, recordedLength);
+
+  bool replayBegin = replayed.begin();
+  bool replaySigned = replayed.createSignature(message);
+
+  Serial.print("Replay: begin() ");
+  Serial.print(replayBegin ? "ok" : "failed");
+  Serial.print(", createSignature() ");
+  Serial.print(replaySigned ? "ok" : "failed");
+  Serial.print(" (recorded: ");
+  Serial.print(signedMessage ? "ok" : "failed");
+  Serial.println(")");
+
+  Serial.print("Same signature: ");
+  Serial.println((memcmp(atecc.signature, replayed.signature, SIGNATURE_SIZE) == 0) ? "yes" : "no");
+  Serial.print("Whole trace used: ");
+  Serial.println(replay.replayFinished() ? "yes" : "no");
+  Serial.print("Went off the trace: ");
+  Serial.println(replay.diverged() ? "yes" : "no");
+  Serial.print("Writes that differ: ");
+  Serial.println(replay.mismatches());
+  Serial.print("Worst timing difference: ");
+  Serial.print(replay.timingError());
+  Serial.println(" us");
+  Serial.print("Replay time - recorded time: ");
+  Serial.print(replay.timingDrift());
+  Serial.println(" us");
+}
+
+void loop()
+{
+  // do nothing.
+}
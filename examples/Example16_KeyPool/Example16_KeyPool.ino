@@ -0,0 +1,121 @@
+/*
+  Using the SparkFun Cryptographic Co-processor Breakout ATECC508a (Qwiic)
+  SparkFun Electronics
+  License: This code is public domain but you can buy me a beer if you use this and we meet someday (Beerware license).
+
+  Feel like supporting our work? Please buy a board from SparkFun!
+  https://www.sparkfun.com/products/15573
+
+  This example shows how to keep fresh key pairs ready for protocols that use a new key
+  for every session, with ATECCX08A_KeyPool.
+
+  createNewKeyPair() takes up to 115ms, which a handshake would pay up front.
+  The pool generates the keys ahead of time instead: pool.take() hands out a slot with a
+  fresh key and its public key right away, without talking to the IC. After the session,
+  pool.release() gives the slot back, and pool.service() (called every loop()) generates
+  a new key in it, without making loop() wait for the IC.
+
+  Here, every "session" takes a key from the pool, and signs a message with it.
+
+  The pool slots must hold ECC private keys that GENKEY may replace after the data zone is
+  locked (SlotConfig.WriteConfig GenKey bit). With the SparkFun Standard settings, that is
+  slot 1 (slot 0 is locked). For more slots, or for ECDH, set up more slots like slot 1
+  before locking the config zone (KeyConfig 0x0033, SlotConfig 0x2083, or 0x2087 to also allow ECDH).
+
+  Hardware Connections and initial setup:
+  Plug in your controller board (e.g. Artemis Redboard, Nano, ATP) into your computer with USB cable.
+  Connect your Cryptographic Co-processor to your controller board via a qwiic cable.
+  Select TOOLS>>BOARD>>"SparkFun Redboard Artemis"
+  Select TOOLS>>PORT>> "COM 3" (note, yours may be different)
+  Click upload, and follow prompts on serial monitor at 115200.
+
+*/
+
+#include <SparkFun_ATECCX08a_Arduino_Library.h> //Click here to get the library: http://librarymanager/All#SparkFun_ATECCX08a
+#include <SparkFun_ATECCX08a_KeyPool.h>
+#include <Wire.h>
+
+ATECCX08A atecc;
+ATECCX08A_KeyPool pool(atecc);
+
+uint16_t poolSlots[] = { 1 }; // add your own ephemeral key slots here
+
+#define SESSION_INTERVAL_MS 500
+
+uint8_t message[32] = {
+  0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0A, 0x0B, 0x0C, 0x0D, 0x0E, 0x0F,
+  0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18, 0x19, 0x1A, 0x1B, 0x1C, 0x1D, 0x1E, 0x1F
+};
+
+unsigned long lastSession = 0;
+
+void setup() {
+  Wire.begin();
+  Serial.begin(115200);
+  if (atecc.begin() == true)
+  {
+    Serial.println("Successful wakeUp(). I2C connections are good.");
+  }
+  else
+  {
+    Serial.println("Device not found. Check wiring.");
+    while (1); // stall out forever
+  }
+
+  atecc.readConfigZone(false); // Debug argument false (OFF)
+
+  if (!(atecc.configLockStatus && atecc.dataOTPLockStatus))
+  {
+    Serial.print("Device not configured. Please use the configuration sketch.");
+    while (1); // stall out forever.
+  }
+
+  if (!pool.begin(poolSlots, sizeof(poolSlots) / sizeof(poolSlots[0])))
+  {
+    Serial.println("The pool slots can not take new keys, see the notes at the top of this sketch.");
+    while (1); // stall out forever.
+  }
+
+  unsigned long startMicros = micros();
+  pool.fill(); // the first keys, the wait is in setup()
+  Serial.print("Filled the pool in ");
+  Serial.print(micros() - startMicros);
+  Serial.println(" us.");
+}
+
+void loop()
+{
+  pool.service(); // never waits for the IC
+
+  if ((millis() - lastSession) < SESSION_INTERVAL_MS)
+    return;
+  lastSession = millis();
+
+  // new session: a fresh key, right away
+  uint8_t publicKey[PUBLIC_KEY_SIZE];
+  unsigned long startMicros = micros();
+  int8_t slot = pool.take(publicKey);
+  unsigned long takeMicros = micros() - startMicros;
+
+  if (slot < 0)
+  {
+    Serial.println("No key ready yet (sessions come faster than GENKEY, add slots to the pool).");
+    return;
+  }
+
+  Serial.print("Session key from slot ");
+  Serial.print(slot);
+  Serial.print(" in ");
+  Serial.print(takeMicros);
+  Serial.print(" us (slot used ");
+  Serial.print(pool.generations(slot));
+  Serial.println(" times)");
+
+  // the peer gets publicKey, and we sign with the matching private key
+  if (atecc.createSignature(message, slot))
+    Serial.println("Signed with the session key.");
+  else
+    Serial.println("Signing failed.");
+
+  pool.release(slot); // the key is replaced by service(), from the next loop() on
+}
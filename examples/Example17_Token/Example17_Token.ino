@@ -0,0 +1,105 @@
+/*
+  Using the SparkFun Cryptographic Co-processor Breakout ATECC508a (Qwiic)
+  SparkFun Electronics
+  License: This code is public domain but you can buy me a beer if you use this and we meet someday (Beerware license).
+
+  Feel like supporting our work? Please buy a board from SparkFun!
+  https://www.sparkfun.com/products/15573
+
+  This example shows how to sign ES256 tokens for a cloud backend: a JWT, and a COSE_Sign1
+  (the CBOR equivalent, for small uplinks), with the private key in slot 0.
+
+  ATECCX08A_Token writes the token out as it is built, and sends the signed part through
+  the IC's SHA engine on the way. No buffer for the whole token is needed: the token can
+  go straight to the network client (here, to Serial). There is also a version that
+  writes into a char buffer, if you need the token as a string.
+
+  Check the JWT at https://jwt.io with the public key printed below (as a PEM, see
+  Example9_Certificate), or with any JWT library.
+
+  Note, this requires that your device be configured with SparkFun Standard Configuration settings.
+
+  Hardware Connections and initial setup:
+  Plug in your controller board (e.g. Artemis Redboard, Nano, ATP) into your computer with USB cable.
+  Connect your Cryptographic Co-processor to your controller board via a qwiic cable.
+  Select TOOLS>>BOARD>>"SparkFun Redboard Artemis"
+  Select TOOLS>>PORT>> "COM 3" (note, yours may be different)
+  Click upload, and follow prompts on serial monitor at 115200.
+
+*/
+
+#include <SparkFun_ATECCX08a_Arduino_Library.h> //Click here to get the library: http://librarymanager/All#SparkFun_ATECCX08a
+#include <SparkFun_ATECCX08a_Token.h>
+#include <Wire.h>
+
+ATECCX08A atecc;
+ATECCX08A_Token token(atecc);
+
+void setup() {
+  Wire.begin();
+  Serial.begin(115200);
+  if (atecc.begin() == true)
+  {
+    Serial.println("Successful wakeUp(). I2C connections are good.");
+  }
+  else
+  {
+    Serial.println("Device not found. Check wiring.");
+    while (1); // stall out forever
+  }
+
+  atecc.readConfigZone(false); // Debug argument false (OFF)
+
+  if (!(atecc.configLockStatus && atecc.dataOTPLockStatus && atecc.slot0LockStatus))
+  {
+    Serial.print("Device not configured. Please use the configuration sketch.");
+    while (1); // stall out forever.
+  }
+
+  atecc.generatePublicKey(0, false);
+  atecc.printHexDump("publicKey64Bytes", atecc.publicKey64Bytes, PUBLIC_KEY_SIZE);
+  Serial.println();
+
+  // JWT, streamed to Serial. The claims can be written in as many pieces as you like.
+  char temperature[16];
+  snprintf(temperature, sizeof(temperature), "%d", 21);
+
+  Serial.println("JWT:");
+  token.beginJWT(Serial, 0);
+  token.print("{\"iss\":\"sparkfun-device\",\"iat\":");
+  token.print("1700000000");
+  token.print(",\"temp\":");
+  token.print(temperature);
+  token.print("}");
+  bool signedJwt = token.end();
+  Serial.println();
+  Serial.print("Signed: ");
+  Serial.print(signedJwt ? "yes" : "no");
+  Serial.print(", ");
+  Serial.print(token.length());
+  Serial.println(" characters");
+  Serial.println();
+
+  // the same into a char buffer
+  char jwt[256];
+  if (token.beginJWT(jwt, sizeof(jwt), 0) && token.print("{\"iss\":\"sparkfun-device\"}") && token.end())
+  {
+    Serial.println("JWT in a buffer:");
+    Serial.println(jwt);
+    Serial.println();
+  }
+
+  // COSE_Sign1: CBOR needs the payload length up front
+  uint8_t payload[] = { 0xA1, 0x64, 't', 'e', 'm', 'p', 0x15 }; // {"temp": 21}
+  uint8_t cose[128];
+
+  if (token.beginCOSE(cose, sizeof(cose), sizeof(payload), 0) && token.write(payload, sizeof(payload)) && token.end())
+    atecc.printHexDump("coseSign1", cose, token.length());
+  else
+    Serial.println("COSE signing failed.");
+}
+
+void loop()
+{
+  // do nothing.
+}
@@ -0,0 +1,126 @@
+/*
+  Using the SparkFun Cryptographic Co-processor Breakout ATECC508a (Qwiic)
+  SparkFun Electronics
+  License: This code is public domain but you can buy me a beer if you use this and we meet someday (Beerware license).
+
+  Feel like supporting our work? Please buy a board from SparkFun!
+  https://www.sparkfun.com/products/15573
+
+  This example shows the verifier side of challenge-response authentication for a hub
+  that talks to many nodes at once, with ATECCX08A_ChallengeTable.
+
+  Example6_Challenge_Bob keeps a single challenge. The table keeps one per node (peer id),
+  each with its own timeout, and takes it out as soon as the node answers, so a replayed
+  answer is rejected. Challenges are read from the RNG a few at a time, in one wake.
+
+  To keep this sketch on one board, the "nodes" are simulated here: each one answers after
+  its own delay, signing with slot 0 of this same IC. In a real hub, the challenge goes out
+  over your radio or bus, and the node signs it with respondToChallenge() on its own IC.
+  Node 3 answers too late, and node 4 sends its answer twice.
+
+  Note, this requires that your device be configured with SparkFun Standard Configuration settings.
+
+  Hardware Connections and initial setup:
+  Plug in your controller board (e.g. Artemis Redboard, Nano, ATP) into your computer with USB cable.
+  Connect your Cryptographic Co-processor to your controller board via a qwiic cable.
+  Select TOOLS>>BOARD>>"SparkFun Redboard Artemis"
+  Select TOOLS>>PORT>> "COM 3" (note, yours may be different)
+  Click upload, and follow prompts on serial monitor at 115200.
+
+*/
+
+#include <SparkFun_ATECCX08a_Arduino_Library.h> //Click here to get the library: http://librarymanager/All#SparkFun_ATECCX08a
+#include <SparkFun_ATECCX08a_Challenges.h>
+#include <Wire.h>
+
+ATECCX08A atecc;
+ATECCX08A_ChallengeTable challenges(atecc);
+
+#define NODES 5
+#define CHALLENGE_TIMEOUT 500 // ms
+
+unsigned long answerDelay[NODES] = { 50, 120, 200, 900, 300 }; // node 3 is too slow
+
+uint8_t nodeChallenge[NODES][32]; // what each simulated node received
+unsigned long issuedMillis;
+bool answered[NODES];
+uint8_t publicKey[PUBLIC_KEY_SIZE]; // all the simulated nodes share slot 0's key
+
+void setup() {
+  Wire.begin();
+  Serial.begin(115200);
+  if (atecc.begin() == true)
+  {
+    Serial.println("Successful wakeUp(). I2C connections are good.");
+  }
+  else
+  {
+    Serial.println("Device not found. Check wiring.");
+    while (1); // stall out forever
+  }
+
+  atecc.readConfigZone(false); // Debug argument false (OFF)
+
+  if (!(atecc.configLockStatus && atecc.dataOTPLockStatus && atecc.slot0LockStatus))
+  {
+    Serial.print("Device not configured. Please use the configuration sketch.");
+    while (1); // stall out forever.
+  }
+
+  atecc.generatePublicKey(0, false);
+  memcpy(publicKey, atecc.publicKey64Bytes, PUBLIC_KEY_SIZE);
+
+  // one challenge per node, all outstanding at once
+  for (uint8_t node = 0; node < NODES; node++)
+  {
+    if (!challenges.issue(node, nodeChallenge[node], CHALLENGE_TIMEOUT))
+      Serial.println("Could not issue a challenge.");
+    answered[node] = false;
+  }
+  issuedMillis = millis();
+
+  Serial.print(challenges.outstanding());
+  Serial.println(" challenges outstanding.");
+}
+
+void loop()
+{
+  challenges.refill(); // read the next challenges from the RNG while nothing else is going on
+
+  for (uint8_t node = 0; node < NODES; node++)
+  {
+    if (answered[node] || ((millis() - issuedMillis) < answerDelay[node]))
+      continue;
+    answered[node] = true;
+
+    // the node's answer
+    uint8_t signature[SIGNATURE_SIZE];
+    atecc.respondToChallenge(nodeChallenge[node], 0, signature);
+
+    // the hub's check
+    Serial.print("Node ");
+    Serial.print(node);
+    Serial.print(" answered after ");
+    Serial.print(millis() - issuedMillis);
+    Serial.print(" ms: ");
+    Serial.println(challenges.checkResponse(node, signature, publicKey) ? "authenticated" : "rejected");
+
+    if (node == 4)
+    {
+      Serial.print("Node 4 replayed its answer: ");
+      Serial.println(challenges.checkResponse(node, signature, publicKey) ? "authenticated" : "rejected");
+    }
+  }
+
+  static bool reported = false;
+  if (!reported && ((millis() - issuedMillis) > 1000))
+  {
+    reported = true;
+    Serial.print("Expired: ");
+    Serial.print(challenges.expiredChallenges());
+    Serial.print(", rejected: ");
+    Serial.print(challenges.rejectedResponses());
+    Serial.print(", outstanding: ");
+    Serial.println(challenges.outstanding());
+  }
+}
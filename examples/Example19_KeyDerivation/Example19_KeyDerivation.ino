@@ -0,0 +1,142 @@
+/*
+  Using the SparkFun Cryptographic Co-processor Breakout ATECC508a (Qwiic)
+  SparkFun Electronics
+  License: This code is public domain but you can buy me a beer if you use this and we meet someday (Beerware license).
+
+  Feel like supporting our work? Please buy a board from SparkFun!
+  https://www.sparkfun.com/products/15573
+
+  This example shows how to derive per-session keys from a master key, on the IC.
+
+  deriveKey() turns the master key in a slot, and an "info" string that names the key
+  (e.g. session number and direction), into a new 32-byte key. On an ATECC608 this is
+  HKDF-Expand (RFC 5869) with the KDF command: the master key never leaves the IC, and a
+  hub that holds the same master key gets the same session key with calculateDerivedKey().
+  The new key can stay on the IC (in TempKey or a slot), or come back to the host,
+  in the clear or encrypted with the IO protection key.
+
+  deriveKeys() derives several keys in one wake, here the tx and rx keys of a new session.
+
+  Every few seconds, this sketch starts a new session:
+  - the tx and rx keys come back to the host (for a software cipher), in one batch
+  - a third key goes into TempKey, and encrypts a block with the IC's AES engine
+  and the hub side checks the keys with calculateDerivedKey().
+
+  Hardware Connections and initial setup:
+  This needs an ATECC608, with the MAC key of Example12_MAC in slot 9 as the master key
+  (run Example12_MAC on a new device first). On an ATECC508A, deriveKey() works through
+  TempKey (GenDig/DeriveKey) and can not return the key, so only the TempKey part applies.
+  Plug in your controller board (e.g. Artemis Redboard, Nano, ATP) into your computer with USB cable.
+  Connect your Cryptographic Co-processor to your controller board via a qwiic cable.
+  Select TOOLS>>BOARD>>"SparkFun Redboard Artemis"
+  Select TOOLS>>PORT>> "COM 3" (note, yours may be different)
+  Click upload, and follow prompts on serial monitor at 115200.
+
+*/
+
+#include <SparkFun_ATECCX08a_Arduino_Library.h> //Click here to get the library: http://librarymanager/All#SparkFun_ATECCX08a
+#include <Wire.h>
+
+ATECCX08A atecc;
+
+#define MASTER_SLOT 9
+#define REKEY_INTERVAL_MS 5000
+
+// the hub's copy of the master key (the same key as in Example12_MAC)
+uint8_t masterKey[MAC_KEY_SIZE] = {
+  0x2B, 0x7E, 0x15, 0x16, 0x28, 0xAE, 0xD2, 0xA6, 0xAB, 0xF7, 0x15, 0x88, 0x09, 0xCF, 0x4F, 0x3C,
+  0x76, 0x2E, 0x71, 0x60, 0xF3, 0x8B, 0x4D, 0xA5, 0x6A, 0x78, 0x4D, 0x90, 0x45, 0x19, 0x0C, 0xFE
+};
+
+unsigned long session = 0;
+unsigned long lastRekey = 0;
+
+void setup() {
+  Wire.begin();
+  Serial.begin(115200);
+  if (atecc.begin() == true)
+  {
+    Serial.println("Successful wakeUp(). I2C connections are good.");
+  }
+  else
+  {
+    Serial.println("Device not found. Check wiring.");
+    while (1); // stall out forever
+  }
+
+  atecc.readConfigZone(false); // Debug argument false (OFF)
+
+  if (!atecc.hasFeature(ATECC_FEATURE_KDF))
+  {
+    Serial.println("This example needs an ATECC608.");
+    while (1); // stall out forever.
+  }
+}
+
+void loop()
+{
+  if ((session > 0) && ((millis() - lastRekey) < REKEY_INTERVAL_MS))
+    return;
+  lastRekey = millis();
+  session++;
+
+  char txInfo[32];
+  char rxInfo[32];
+  char aesInfo[32];
+  snprintf(txInfo, sizeof(txInfo), "session %lu, tx", session);
+  snprintf(rxInfo, sizeof(rxInfo), "session %lu, rx", session);
+  snprintf(aesInfo, sizeof(aesInfo), "session %lu, aes", session);
+
+  // tx and rx keys, returned to the host, in one wake
+  uint8_t txKey[KDF_OUTPUT_SIZE];
+  uint8_t rxKey[KDF_OUTPUT_SIZE];
+  ATECCX08A_KeyDerivation keys[2] = {
+    { MASTER_SLOT, (const uint8_t *)txInfo, (uint8_t)strlen(txInfo), KDF_TARGET_OUTPUT, 0, txKey, NULL },
+    { MASTER_SLOT, (const uint8_t *)rxInfo, (uint8_t)strlen(rxInfo), KDF_TARGET_OUTPUT, 0, rxKey, NULL },
+  };
+
+  unsigned long startMicros = micros();
+  bool derived = atecc.deriveKeys(keys, 2);
+  unsigned long batchMicros = micros() - startMicros;
+
+  Serial.print("Session ");
+  Serial.print(session);
+  Serial.print(": ");
+  if (!derived)
+  {
+    Serial.println("key derivation failed (is the master key in slot 9?)");
+    return;
+  }
+  Serial.print("tx and rx keys in ");
+  Serial.print(batchMicros);
+  Serial.println(" us");
+
+  // the hub derives the same keys in software
+  uint8_t hubKey[KDF_OUTPUT_SIZE];
+  ATECCX08A::calculateDerivedKey(masterKey, (const uint8_t *)txInfo, strlen(txInfo), hubKey);
+  Serial.print("  hub tx key matches: ");
+  Serial.println(memcmp(hubKey, txKey, KDF_OUTPUT_SIZE) == 0 ? "yes" : "no");
+  ATECCX08A::calculateDerivedKey(masterKey, (const uint8_t *)rxInfo, strlen(rxInfo), hubKey);
+  Serial.print("  hub rx key matches: ");
+  Serial.println(memcmp(hubKey, rxKey, KDF_OUTPUT_SIZE) == 0 ? "yes" : "no");
+
+  // a key that stays on the IC: derived into TempKey, and used by AES right away
+  // (in one session, as TempKey is lost when the IC goes idle)
+  ATECCX08A_KeyDerivation onChip = { MASTER_SLOT, (const uint8_t *)aesInfo, (uint8_t)strlen(aesInfo), KDF_TARGET_TEMPKEY, 0, NULL, NULL };
+  uint8_t block[AES_BLOCK_SIZE] = { 'h', 'e', 'l', 'l', 'o', ' ', 'f', 'r', 'o', 'm', ' ', 'n', 'o', 'd', 'e', '!' };
+  uint8_t encrypted[AES_BLOCK_SIZE];
+
+  atecc.beginSession();
+  bool encryptedOk = atecc.deriveKey(&onChip) && atecc.aesEncrypt(AES_KEYID_TEMPKEY, 0, block, encrypted);
+  atecc.endSession();
+
+  if (encryptedOk)
+    atecc.printHexDump("  encrypted with the TempKey key", encrypted, AES_BLOCK_SIZE);
+  else
+    Serial.println("  AES with the derived key failed.");
+
+  // wipe the keys once the session is over
+  memset(txKey, 0, sizeof(txKey));
+  memset(rxKey, 0, sizeof(rxKey));
+  memset(hubKey, 0, sizeof(hubKey));
+}
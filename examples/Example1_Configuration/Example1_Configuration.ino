@@ -58,8 +58,9 @@ void setup() {
     if (atecc.writeConfigSparkFun() == true) Serial.println("Success!");
     else Serial.println("Failure.");
 
+    // Only locks if the device holds exactly the config we just wrote (checked with a CRC of the whole zone)
     Serial.print("Lock Config: \t");
-    if (atecc.lockConfig() == true) Serial.println("Success!");
+    if (atecc.lockConfigChecked() == true) Serial.println("Success!");
     else Serial.println("Failure.");
 
     Serial.print("Key Creation: \t");
@@ -129,10 +130,16 @@ void printInfo()
 
   Serial.println();
 
+  // What each slot allows, decoded from its SlotConfig and KeyConfig.
+  // Calls that a slot does not allow (e.g. signing with slot 8) fail right away, without using the IC.
+  atecc.printSlotPermissions();
+
+  Serial.println();
+
   // if everything is locked up, then configuration is complete, so let's print the public key
   if (atecc.configLockStatus && atecc.dataOTPLockStatus && atecc.slot0LockStatus) 
   {
-    if(atecc.generatePublicKey() == false)
+    if(atecc.generatePublicKey(0, true) == false) // slot 0, debug true (prints this device's public key)
     {
       Serial.println("Failure to generate This device's Public Key");
       Serial.println();
@@ -0,0 +1,120 @@
+/*
+  Using the SparkFun Cryptographic Co-processor Breakout ATECC508a (Qwiic)
+  SparkFun Electronics
+  License: This code is public domain but you can buy me a beer if you use this and we meet someday (Beerware license).
+
+  Feel like supporting our work? Please buy a board from SparkFun!
+  https://www.sparkfun.com/products/15573
+
+  This example compares the power policies, to pick one for a battery powered device.
+
+  Between calls, the IC can idle (800uA, TempKey kept, quick to wake) or sleep (150nA).
+  An idle IC does not go to sleep on its own: the watchdog only runs while it is awake.
+  So with the default policy (ATECC_POWER_IDLE), a device that wakes the IC once a minute
+  pays the idle current all the time in between.
+  - ATECC_POWER_IDLE: idle after every call
+  - ATECC_POWER_SLEEP: sleep after every call
+  - ATECC_POWER_TIMED: idle after every call, sleep once idle for a while (powerService())
+
+  The library counts the time the IC spends awake, executing, idle and asleep, and
+  estimates the energy from the datasheet currents (see setPowerModel() to use your own).
+  This sketch runs the same workload (a random number every 100 ms, 1 s and 5 s) with each policy
+  for a while, and prints the energy per operation and the average current.
+  The figures are estimates from the max execution times, not measurements.
+
+  Hardware Connections and initial setup:
+  Plug in your controller board (e.g. Artemis Redboard, Nano, ATP) into your computer with USB cable.
+  Connect your Cryptographic Co-processor to your controller board via a qwiic cable.
+  Select TOOLS>>BOARD>>"SparkFun Redboard Artemis"
+  Select TOOLS>>PORT>> "COM 3" (note, yours may be different)
+  Click upload, and follow prompts on serial monitor at 115200.
+
+*/
+
+#include <SparkFun_ATECCX08a_Arduino_Library.h> //Click here to get the library: http://librarymanager/All#SparkFun_ATECCX08a
+#include <Wire.h>
+
+ATECCX08A atecc;
+
+#define RUN_MS 10000 // length of each run
+#define SLEEP_AFTER_MS 500 // for ATECC_POWER_TIMED
+
+unsigned long periods[] = { 100, 1000, 5000 }; // ms between operations
+uint8_t policies[] = { ATECC_POWER_IDLE, ATECC_POWER_SLEEP, ATECC_POWER_TIMED };
+const char *policyNames[] = { "idle ", "sleep", "timed" };
+
+void setup() {
+  Wire.begin();
+  Serial.begin(115200);
+  if (atecc.begin() == true)
+  {
+    Serial.println("Successful wakeUp(). I2C connections are good.");
+  }
+  else
+  {
+    Serial.println("Device not found. Check wiring.");
+    while (1); // stall out forever
+  }
+
+  Serial.println("policy  period ms  ops  wakes  uJ/op     avg uA");
+
+  for (uint8_t p = 0; p < sizeof(periods) / sizeof(periods[0]); p++)
+  {
+    for (uint8_t i = 0; i < sizeof(policies) / sizeof(policies[0]); i++)
+      benchmark(policies[i], policyNames[i], periods[p]);
+  }
+
+  // what the time went on, over all the runs
+  Serial.println();
+  Serial.print("RANDOM commands: ");
+  Serial.print(atecc.commandCount(COMMAND_OPCODE_RANDOM));
+  Serial.print(", executing for ");
+  Serial.print(atecc.commandActiveMicros(COMMAND_OPCODE_RANDOM) / 1000);
+  Serial.println(" ms in total");
+
+  atecc.setPowerPolicy(ATECC_POWER_SLEEP); // the best choice while the sketch does nothing
+  atecc.sleep();
+}
+
+void benchmark(uint8_t policy, const char *name, unsigned long period)
+{
+  ATECCX08A_PowerStats before;
+  ATECCX08A_PowerStats after;
+  unsigned long ops = 0;
+  uint8_t randomNumber[32];
+
+  atecc.setPowerPolicy(policy, SLEEP_AFTER_MS);
+  atecc.powerStats(&before);
+  unsigned long start = millis();
+
+  while ((millis() - start) < RUN_MS)
+  {
+    atecc.updateRandom32Bytes(false, randomNumber);
+    ops++;
+
+    unsigned long last = millis();
+    while (((millis() - last) < period) && ((millis() - start) < RUN_MS))
+      atecc.powerService(); // the rest of the device's work would go here
+  }
+
+  float energy = atecc.energySince(&before);
+  atecc.powerStats(&after);
+  unsigned long elapsedMs = millis() - start;
+
+  Serial.print(name);
+  Serial.print("   ");
+  Serial.print(period);
+  Serial.print("\t     ");
+  Serial.print(ops);
+  Serial.print("\t  ");
+  Serial.print(after.wakes - before.wakes);
+  Serial.print("\t ");
+  Serial.print(energy / ops, 2);
+  Serial.print("\t   ");
+  Serial.println(energy * 1000000.0f / ((float)elapsedMs * ATECC_SUPPLY_MILLIVOLTS), 2); // uJ / (ms * mV) = A, so * 1000000 for uA
+}
+
+void loop()
+{
+  // do nothing.
+}
@@ -0,0 +1,119 @@
+/*
+  Using the SparkFun Cryptographic Co-processor Breakout ATECC508a (Qwiic)
+  SparkFun Electronics
+  License: This code is public domain but you can buy me a beer if you use this and we meet someday (Beerware license).
+
+  Feel like supporting our work? Please buy a board from SparkFun!
+  https://www.sparkfun.com/products/15573
+
+  This example shows how to hash a file (e.g. a firmware image on an SD card) on the IC,
+  without reading the whole file into RAM first.
+
+  hashStream() takes any Stream (a File, SPI flash behind a Stream, ...), and reads each
+  64-byte block while the IC hashes the one before. So the storage reads and the SHA commands
+  overlap: the hash takes about as long as the slower of the two, not their sum.
+  This sketch times both ways: hashStream(), and reading the file, then sha256().
+
+  The whole hash has to run in one wake window (~1.3s), so this is for files up to a few KB,
+  depending on the storage speed and the I2C clock (see setI2CClock()).
+
+  Hardware Connections and initial setup:
+  Put a file called FIRMWARE.BIN (up to MAX_FILE_SIZE bytes) on an SD card, in a card reader
+  with its chip select on SD_CS_PIN.
+  Plug in your controller board (e.g. Artemis Redboard, Nano, ATP) into your computer with USB cable.
+  Connect your Cryptographic Co-processor to your controller board via a qwiic cable.
+  Select TOOLS>>BOARD>>"SparkFun Redboard Artemis"
+  Select TOOLS>>PORT>> "COM 3" (note, yours may be different)
+  Click upload, and follow prompts on serial monitor at 115200.
+
+*/
+
+#include <SparkFun_ATECCX08a_Arduino_Library.h> //Click here to get the library: http://librarymanager/All#SparkFun_ATECCX08a
+#include <Wire.h>
+#include <SD.h>
+
+ATECCX08A atecc;
+
+#define SD_CS_PIN 10
+#define FILE_NAME "FIRMWARE.BIN"
+#define MAX_FILE_SIZE 4096 // only for the read-then-hash comparison, hashStream() needs no buffer
+
+uint8_t fileBuffer[MAX_FILE_SIZE];
+
+void setup() {
+  Wire.begin();
+  Serial.begin(115200);
+  if (atecc.begin() == true)
+  {
+    Serial.println("Successful wakeUp(). I2C connections are good.");
+  }
+  else
+  {
+    Serial.println("Device not found. Check wiring.");
+    while (1); // stall out forever
+  }
+
+  atecc.setI2CClock(ATECC_MAX_CLOCK_HZ); // more data per wake window
+
+  if (!SD.begin(SD_CS_PIN))
+  {
+    Serial.println("SD card not found.");
+    while (1); // stall out forever
+  }
+
+  // overlapped: read and hash block by block
+  File file = SD.open(FILE_NAME);
+  if (!file)
+  {
+    Serial.println("Could not open " FILE_NAME);
+    while (1); // stall out forever
+  }
+
+  size_t size = file.size();
+  uint8_t hash[SHA256_SIZE];
+
+  unsigned long start = micros();
+  bool hashed = atecc.hashStream(file, size, hash);
+  unsigned long streamMicros = micros() - start;
+  file.close();
+
+  if (!hashed)
+  {
+    Serial.print("hashStream() failed, status 0x");
+    Serial.println(atecc.lastStatus(), HEX); // ATECC_STATUS_TOO_LONG: the file is too big for one wake window
+    while (1); // stall out forever
+  }
+
+  Serial.print(FILE_NAME);
+  Serial.print(", ");
+  Serial.print(size);
+  Serial.println(" bytes");
+  atecc.printHexDump("hash", hash, SHA256_SIZE);
+  Serial.print("hashStream(): ");
+  Serial.print(streamMicros);
+  Serial.println(" us");
+
+  // one after the other: read it all, then hash
+  if (size <= MAX_FILE_SIZE)
+  {
+    uint8_t check[SHA256_SIZE];
+
+    file = SD.open(FILE_NAME);
+    start = micros();
+    file.read(fileBuffer, size);
+    atecc.sha256(fileBuffer, size, check);
+    unsigned long serialMicros = micros() - start;
+    file.close();
+
+    Serial.print("read, then sha256(): ");
+    Serial.print(serialMicros);
+    Serial.println(" us");
+    Serial.print("Same hash: ");
+    Serial.println(memcmp(hash, check, SHA256_SIZE) == 0 ? "yes" : "no");
+  }
+}
+
+void loop()
+{
+  // do nothing.
+}
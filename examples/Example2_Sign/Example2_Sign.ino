@@ -59,6 +59,8 @@ void setup() {
 
   //Let's create a digital signature!
   atecc.createSignature(message); // by default, this uses the private key securely stored and locked in slot 0.
+
+  printSignature(); // the new signature lives inside the library as a public array called "atecc.signature"
 }
 
 void loop()
@@ -80,6 +82,21 @@ void printMessage()
   Serial.println("};");
 }
 
+void printSignature()
+{
+  Serial.println("uint8_t signature[64] = {");
+  for (int i = 0; i < sizeof(atecc.signature) ; i++)
+  {
+    Serial.print("0x");
+    if ((atecc.signature[i] >> 4) == 0) Serial.print("0"); // print preceeding high nibble if it's zero
+    Serial.print(atecc.signature[i], HEX);
+    if (i != 63) Serial.print(", ");
+    if ((63 - i) % 16 == 0) Serial.println();
+  }
+  Serial.println("};");
+  Serial.println();
+}
+
 void printInfo()
 {
   // Read all 128 bytes of Configuration Zone
@@ -122,7 +139,7 @@ void printInfo()
   // if everything is locked up, then configuration is complete, so let's print the public key
   if (atecc.configLockStatus && atecc.dataOTPLockStatus && atecc.slot0LockStatus) 
   {
-    if(atecc.generatePublicKey() == false)
+    if(atecc.generatePublicKey(0, true) == false) // slot 0, debug true (prints this device's public key)
     {
       Serial.println("Failure to generate this device's Public Key");
       Serial.println();
@@ -87,7 +87,13 @@ void setup() {
 
   // Let's verirfy!
   if (atecc.verifySignature(message, signature, publicKeyExternal)) Serial.println("Success! Signature Verified.");
-  else Serial.println("Verification failure.");
+  else if (atecc.lastStatus() == ATECC_STATUS_MISCOMPARE) Serial.println("Verification failure: signature does not match.");
+  else
+  {
+    // anything else means the IC could not check it (e.g. wiring, or the IC not configured)
+    Serial.print("Verification failure: status 0x");
+    Serial.println(atecc.lastStatus(), HEX);
+  }
 }
 
 void loop()
@@ -37,6 +37,16 @@
   within the library instance. If your instance was named "atecc" as in the SparkFun examples,
   this array would be "atecc.random32Bytes[]". 
   This can be useful as an time-to-live-token (aka NONCE) to send to another device.
+
+  Each of the above is one RANDOM command on the IC (~23ms for 32 bytes).
+  When you need lots of random bytes (nonces, padding, keys for a session), use the DRBG:
+
+  ATECCX08A_DRBG drbg(atecc);
+  drbg.begin();                  // seeded from the IC
+  drbg.generate(buffer, length); // as many bytes as you like, at software SHA-256 speed
+
+  It reseeds itself from the IC every DRBG_RESEED_INTERVAL calls (see setReseedInterval()),
+  or before every call after setPredictionResistance(true).
   
   //////////////////////////////
   /////////////// CONFIGURATION
@@ -54,9 +64,13 @@
 */
 
 #include <SparkFun_ATECCX08a_Arduino_Library.h> //Click here to get the library: http://librarymanager/All#SparkFun_ATECCX08a
+#include <SparkFun_ATECCX08a_DRBG.h>
 #include <Wire.h>
 
 ATECCX08A atecc;
+ATECCX08A_DRBG drbg(atecc);
+
+uint8_t drbgBytes[1024];
 
 void setup() {
   Wire.begin();
@@ -79,6 +93,9 @@ void setup() {
     Serial.print("Device not configured. Please use the configuration sketch.");
     while (1); // stall out forever.
   }
+
+  if (drbg.begin(atecc.serialNumber, sizeof(atecc.serialNumber)) == false) // serial number as personalization string
+    Serial.println("DRBG seed failed (it needs a locked config zone, see Example1_Configuration).");
 }
 
 void loop()
@@ -117,6 +134,20 @@ void loop()
     Serial.print(atecc.random32Bytes[i], HEX);
   }
   Serial.println();
+
+  // 1024 bytes from the DRBG
+  unsigned long startMicros = micros();
+  drbg.generate(drbgBytes, sizeof(drbgBytes));
+  unsigned long drbgMicros = micros() - startMicros;
+  Serial.print("DRBG: 1024 bytes in ");
+  Serial.print(drbgMicros);
+  Serial.print(" us, first 32: ");
+  for (int i = 0; i < 32 ; i++)
+  {
+    if ((drbgBytes[i] >> 4) == 0) Serial.print("0"); // print preceeding high nibble if it's zero
+    Serial.print(drbgBytes[i], HEX);
+  }
+  Serial.println();
   Serial.println();
 
   delay(1000);
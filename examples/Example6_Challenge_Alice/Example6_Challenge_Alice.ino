@@ -147,8 +147,8 @@ void setup() {
     
     for (int i = 0 ; i < 32 ; i++) token[i] = Serial1.read(); // read in token from Bob.
 
-    //Let's create a digital signature!
-    atecc.createSignature(token); // by default, this uses the private key securely stored and locked in slot 0.
+    //Let's sign Bob's token! This loads and signs the token in a single wake of the IC.
+    atecc.respondToChallenge(token); // by default, this uses the private key securely stored and locked in slot 0.
 
     // Now let's send the signature to Bob.
     // Note, in Example6_Challenge_Alice we are printing the signature we JUST created with token,
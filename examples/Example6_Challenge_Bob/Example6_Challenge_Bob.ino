@@ -145,14 +145,13 @@ void loop()
 
       Serial.print("Creating a new random TTL-token now...");
 
-      // update library instance public variable.
-      atecc.updateRandom32Bytes();
+      // create a new token with the NONCE command in random mode.
+      // The IC also keeps the token in TempKey, so it can only be verified once, and only until the IC sleeps.
+      atecc.issueChallenge(token, CHALLENGE_MODE_NONCE);
 
-      // copy from library public variable into our local variable
-      // also send each byte  to Alice.
+      // send each byte to Alice.
       for (int i = 0 ; i < 32 ; i++)
       {
-        token[i] = atecc.random32Bytes[i]; // store locally
         Serial1.write(token[i]); // send to alice
       }
 
@@ -186,7 +185,7 @@ void loop()
         printSignature();
 
         // Let's verirfy!
-        if (atecc.verifySignature(token, signature, AlicesPublicKey))
+        if (atecc.checkResponse(token, signature, AlicesPublicKey))
         {
           Serial.println("Success! Signature Verified.");
         }
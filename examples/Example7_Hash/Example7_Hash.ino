@@ -171,7 +171,7 @@ void printInfo()
   // if everything is locked up, then configuration is complete, so let's print the public key
   if (atecc.configLockStatus && atecc.dataOTPLockStatus && atecc.slot0LockStatus)
   {
-    if (atecc.generatePublicKey() == false)
+    if (atecc.generatePublicKey(0, true) == false) // slot 0, debug true (prints this device's public key)
     {
       Serial.println("Failure to generate this device's Public Key");
       Serial.println();
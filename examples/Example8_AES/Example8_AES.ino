@@ -0,0 +1,130 @@
+/*
+  Using the SparkFun Cryptographic Co-processor Breakout ATECC608a (Qwiic)
+  SparkFun Electronics
+  License: This code is public domain but you can buy me a beer if you use this and we meet someday (Beerware license).
+
+  Feel like supporting our work? Please buy a board from SparkFun!
+  https://www.sparkfun.com/products/15573
+
+  This example shows how to encrypt data with the AES-128 engine inside the ATECC608a.
+  Note, the ATECC508a does NOT have an AES engine, so this example only works with an ATECC608a.
+
+  The key stays inside the IC. Normally it would live in a slot configured as an AES key (KeyType 6),
+  but to keep this example simple (and to work on any configuration) we load a demo key into TempKey.
+  TempKey is kept while the IC is idle, and lost when it goes to sleep.
+
+  We encrypt a "telemetry" message with AES-GCM, which encrypts AND authenticates the data.
+  Then we decrypt it again and check the tag.
+
+  The IC runs one AES command per 16-byte block. Each command takes a few milliseconds of bus time
+  and execution time, so for large amounts of data a software AES on your microcontroller may be faster.
+  At the end, we print the measured time per block, and ask the library which option is faster.
+
+  Hardware Connections and initial setup:
+  Plug in your controller board (e.g. Artemis Redboard, Nano, ATP) into your computer with USB cable.
+  Connect your Cryptographic Co-processor to your controller board via a qwiic cable.
+  Select TOOLS>>BOARD>>"SparkFun Redboard Artemis"
+  Select TOOLS>>PORT>> "COM 3" (note, yours may be different)
+  Click upload, and follow along on serial monitor at 115200.
+
+*/
+
+#include <SparkFun_ATECCX08a_Arduino_Library.h> //Click here to get the library: http://librarymanager/All#SparkFun_ATECCX08a
+#include <Wire.h>
+
+ATECCX08A atecc;
+
+// Demo key, loaded into TempKey. Only the first 16 bytes are used as the AES key (key block 0).
+// Never use a hard coded key in a real product!
+uint8_t demoKey[32] = {
+  0x2B, 0x7E, 0x15, 0x16, 0x28, 0xAE, 0xD2, 0xA6, 0xAB, 0xF7, 0x15, 0x88, 0x09, 0xCF, 0x4F, 0x3C,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00
+};
+
+// 12-byte IV. It must be different for every message encrypted with the same key.
+uint8_t iv[AES_GCM_IV_SIZE] = {0xCA, 0xFE, 0xBA, 0xBE, 0xFA, 0xCE, 0xDB, 0xAD, 0xDE, 0xCA, 0xF8, 0x88};
+
+uint8_t message[48] = "temperature=21.5C humidity=40% battery=3.71V";
+uint8_t ciphertext[sizeof(message)];
+uint8_t decrypted[sizeof(message)];
+uint8_t tag[AES_GCM_TAG_SIZE];
+
+// time for one 16-byte block of YOUR software AES implementation, measure it on your board.
+#define SOFTWARE_AES_BLOCK_MICROS 150
+// time to get a session key onto the host, e.g. one ecdh() call.
+#define SESSION_KEY_MICROS 60000
+
+void setup() {
+  Wire.begin();
+  Serial.begin(115200);
+  if (atecc.begin() == true)
+  {
+    Serial.println("Successful wakeUp(). I2C connections are good.");
+  }
+  else
+  {
+    Serial.println("Device not found. Check wiring.");
+    while (1); // stall out forever
+  }
+
+  atecc.loadTempKey(demoKey); // load the demo key into TempKey
+
+  ATECCX08A_AES_GCM gcm; // holds the state of one GCM encryption or decryption
+
+  // Encrypt
+  if (!atecc.aesGcmInit(&gcm, AES_KEYID_TEMPKEY, 0, iv) || !atecc.aesGcmEncrypt(&gcm, message, ciphertext, sizeof(message)))
+  {
+    Serial.println("AES failure. Note, this needs an ATECC608a.");
+    while (1); // stall out forever
+  }
+  atecc.aesGcmFinish(&gcm, tag);
+
+  printArray("ciphertext", ciphertext, sizeof(ciphertext));
+  printArray("tag", tag, sizeof(tag));
+
+  // Decrypt
+  atecc.aesGcmInit(&gcm, AES_KEYID_TEMPKEY, 0, iv);
+  atecc.aesGcmDecrypt(&gcm, ciphertext, decrypted, sizeof(ciphertext));
+
+  if (atecc.aesGcmCheckTag(&gcm, tag))
+  {
+    Serial.print("Tag OK, decrypted message: ");
+    Serial.println((char *)decrypted);
+  }
+  else Serial.println("Tag check failure.");
+
+  // Throughput
+  Serial.println();
+  Serial.print("Measured time per AES block on the IC (us): ");
+  Serial.println(atecc.aesBlockMicros());
+
+  for (unsigned long length = 16; length <= 16384; length *= 4)
+  {
+    Serial.print(length);
+    Serial.print(" bytes: ");
+    if (atecc.aesSoftwareIsFaster(length, SOFTWARE_AES_BLOCK_MICROS, SESSION_KEY_MICROS)) Serial.println("software AES with a session key is faster");
+    else Serial.println("AES on the IC is faster");
+  }
+}
+
+void loop()
+{
+  // do nothing.
+}
+
+void printArray(const char *name, uint8_t *data, int length)
+{
+  Serial.print("uint8_t ");
+  Serial.print(name);
+  Serial.println("[] = {");
+  for (int i = 0; i < length ; i++)
+  {
+    Serial.print("0x");
+    if ((data[i] >> 4) == 0) Serial.print("0"); // print preceeding high nibble if it's zero
+    Serial.print(data[i], HEX);
+    if (i != (length - 1)) Serial.print(", ");
+    if (((i + 1) % 16 == 0) || (i == (length - 1))) Serial.println();
+  }
+  Serial.println("};");
+  Serial.println();
+}
@@ -0,0 +1,154 @@
+/*
+  Using the SparkFun Cryptographic Co-processor Breakout ATECC508a (Qwiic)
+  SparkFun Electronics
+  License: This code is public domain but you can buy me a beer if you use this and we meet someday (Beerware license).
+
+  Feel like supporting our work? Please buy a board from SparkFun!
+  https://www.sparkfun.com/products/15573
+
+  This example shows how to create, store and rebuild a compressed X.509 certificate.
+
+  TLS and MQTT servers want a full DER certificate (several hundred bytes), but most of it is the same for every device.
+  Only the serial number, dates, signer ID, public key and signature change. So we keep:
+    - a certificate "template" in flash (certTemplate below, the same for every device)
+    - a 72-byte compressed certificate in a data slot (signature, dates, signer ID)
+    - the public key, which the IC can always re-generate from the private key in slot 0
+  and rebuild the full certificate when it's needed, without any extra RAM for the certificate itself.
+
+  To keep this example self-contained, the certificate is signed by the device's own key (slot 0).
+  In production, your signer (a CA, or a signer ATECC on the production line) would sign it.
+
+  Note, storing the compressed certificate in slot 10 only works if slot 10 is configured for clear writes.
+  With the SparkFun standard configuration (Example1) it is not, so the example just keeps it in RAM.
+
+  Hardware Connections and initial setup:
+  Plug in your controller board (e.g. Artemis Redboard, Nano, ATP) into your computer with USB cable.
+  Connect your Cryptographic Co-processor to your controller board via a qwiic cable.
+  Select TOOLS>>BOARD>>"SparkFun Redboard Artemis"
+  Select TOOLS>>PORT>> "COM 3" (note, yours may be different)
+  Click upload, and follow along on serial monitor at 115200.
+
+*/
+
+#include <SparkFun_ATECCX08a_Arduino_Library.h> //Click here to get the library: http://librarymanager/All#SparkFun_ATECCX08a
+#include <SparkFun_ATECCX08a_Cert.h>
+#include <Wire.h>
+
+ATECCX08A atecc;
+
+// tbsCertificate template: issuer "CN=Signer 0000", subject "CN=SparkFun Device",
+// with zeros as placeholders for the serial number, dates and public key.
+const uint8_t certTemplate[] PROGMEM = {
+  0x30, 0x81, 0xD2, 0xA0, 0x03, 0x02, 0x01, 0x02, 0x02, 0x10, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x30, 0x0A, 0x06, 0x08, 0x2A, 0x86,
+  0x48, 0xCE, 0x3D, 0x04, 0x03, 0x02, 0x30, 0x16, 0x31, 0x14, 0x30, 0x12, 0x06, 0x03, 0x55, 0x04,
+  0x03, 0x0C, 0x0B, 0x53, 0x69, 0x67, 0x6E, 0x65, 0x72, 0x20, 0x30, 0x30, 0x30, 0x30, 0x30, 0x1E,
+  0x17, 0x0D, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30, 0x5A, 0x17,
+  0x0D, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30, 0x5A, 0x30, 0x1A,
+  0x31, 0x18, 0x30, 0x16, 0x06, 0x03, 0x55, 0x04, 0x03, 0x0C, 0x0F, 0x53, 0x70, 0x61, 0x72, 0x6B,
+  0x46, 0x75, 0x6E, 0x20, 0x44, 0x65, 0x76, 0x69, 0x63, 0x65, 0x30, 0x59, 0x30, 0x13, 0x06, 0x07,
+  0x2A, 0x86, 0x48, 0xCE, 0x3D, 0x02, 0x01, 0x06, 0x08, 0x2A, 0x86, 0x48, 0xCE, 0x3D, 0x03, 0x01,
+  0x07, 0x03, 0x42, 0x00, 0x04, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00
+};
+
+// Where the device specific fields are in certTemplate
+const ATECCX08A_CertDef certDef = {
+  certTemplate, sizeof(certTemplate),
+  10, 16, // serial number offset and length
+  66, // issue date
+  81, // expire date
+  58, // signer ID (the "0000" in the issuer CN)
+  149 // public key
+};
+
+uint8_t compressedCert[COMPRESSED_CERT_SIZE];
+uint8_t certificate[320]; // a little over 300 bytes with this template, the signature's DER length varies
+
+void setup() {
+  Wire.begin();
+  Serial.begin(115200);
+  if (atecc.begin() == true)
+  {
+    Serial.println("Successful wakeUp(). I2C connections are good.");
+  }
+  else
+  {
+    Serial.println("Device not found. Check wiring.");
+    while (1); // stall out forever
+  }
+
+  atecc.readConfigZone(false); // Debug argument false (OFF)
+
+  // check to see if Config, Data and Slot 0 are locked (see Example1)
+  if (!(atecc.configLockStatus && atecc.dataOTPLockStatus && atecc.slot0LockStatus))
+  {
+    Serial.print("Device not configured. Please use the configuration sketch.");
+    while (1); // stall out forever.
+  }
+
+  // The public key that goes into the certificate
+  atecc.generatePublicKey(0, false);
+
+  // Issued 2024-01-01 00:00, valid for 10 years, signer ID 0x0001.
+  // The serial number is a hash of the public key and dates, so it never needs to be stored.
+  // First without a signature, to work out what has to be signed.
+  uint8_t noSignature[SIGNATURE_SIZE] = {0};
+  ATECCX08A_Cert::compressCertificate(compressedCert, noSignature, 2024, 1, 1, 0, 10, 0x0001, 0, 0, CERT_SN_SOURCE_PUBKEY_HASH);
+
+  uint8_t digest[SHA256_SIZE];
+  ATECCX08A_Cert::tbsDigest(digest, &certDef, compressedCert, atecc.publicKey64Bytes);
+
+  if (atecc.createSignature(digest) == false)
+  {
+    Serial.println("Signing failed.");
+    while (1); // stall out forever.
+  }
+
+  // Now with the signature
+  ATECCX08A_Cert::compressCertificate(compressedCert, atecc.signature, 2024, 1, 1, 0, 10, 0x0001, 0, 0, CERT_SN_SOURCE_PUBKEY_HASH);
+
+  Serial.print("Store compressed certificate in slot 10: ");
+  if (atecc.writeCompressedCert(10, compressedCert) && atecc.readCompressedCert(10, compressedCert)) Serial.println("Success!");
+  else Serial.println("Not allowed by this configuration, keeping it in RAM.");
+
+  // Rebuild the full DER certificate. (You could also stream it straight to a Print/Client with writeCertificate())
+  if (ATECCX08A_Cert::certificateLength(&certDef, compressedCert) > sizeof(certificate))
+  {
+    Serial.print("certificate[] is too small, it needs ");
+    Serial.print(ATECCX08A_Cert::certificateLength(&certDef, compressedCert));
+    Serial.println(" bytes.");
+    while (1); // stall out forever.
+  }
+  size_t length = ATECCX08A_Cert::rebuildCertificate(certificate, sizeof(certificate), &certDef, compressedCert, atecc.publicKey64Bytes);
+
+  Serial.print("Certificate (");
+  Serial.print(length);
+  Serial.println(" bytes DER, paste into any DER/ASN.1 decoder):");
+  printHex(certificate, length);
+
+  // The DER encoders are handy on their own, e.g. for a TLS CertificateVerify
+  uint8_t signatureDer[DER_SIGNATURE_MAX_SIZE];
+  uint8_t signatureLength = ATECCX08A_Cert::derEncodeSignature(atecc.signature, signatureDer);
+  Serial.println("DER signature:");
+  printHex(signatureDer, signatureLength);
+}
+
+void loop()
+{
+  // do nothing.
+}
+
+void printHex(uint8_t *data, size_t length)
+{
+  for (size_t i = 0; i < length; i++)
+  {
+    if ((data[i] >> 4) == 0) Serial.print("0"); // print preceeding high nibble if it's zero
+    Serial.print(data[i], HEX);
+    if ((i % 32) == 31) Serial.println();
+  }
+  Serial.println();
+}
@@ -0,0 +1,49 @@
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdio.h>
+
+typedef uint8_t byte;
+#define HEX 16
+#define DEC 10
+#define bitRead(value, bit) (((value) >> (bit)) & 0x01)
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+void yield();
+class Print {
+public:
+  virtual ~Print() {}
+  virtual size_t write(uint8_t c) { putchar(c); return 1; }
+  virtual size_t write(const uint8_t *b, size_t n) { for (size_t i=0;i<n;i++) write(b[i]); return n; }
+  size_t write(const char *s) { return write((const uint8_t*)s, strlen(s)); }
+  size_t print(const char *s) { return write(s); }
+  size_t print(char c) { return write((uint8_t)c); }
+  size_t print(long v, int base = DEC) { char b[40]; snprintf(b, sizeof b, base==16?"%lX":"%ld", v); return write(b); }
+  size_t print(unsigned long v, int base = DEC) { char b[40]; snprintf(b, sizeof b, base==16?"%lX":"%lu", v); return write(b); }
+  size_t print(int v, int base = DEC) { return print((long)v, base); }
+  size_t print(unsigned int v, int base = DEC) { return print((unsigned long)v, base); }
+  size_t print(unsigned char v, int base = DEC) { return print((unsigned long)v, base); }
+  size_t print(double v, int d = 2) { char b[40]; snprintf(b, sizeof b, "%.*f", d, v); return write(b); }
+  size_t println() { return write("\r\n"); }
+  template<typename T> size_t println(T v) { size_t n = print(v); return n + println(); }
+  template<typename T> size_t println(T v, int b) { size_t n = print(v, b); return n + println(); }
+};
+class Stream : public Print {
+public:
+  void begin(unsigned long) {}
+  virtual int available() { return 0; }
+  virtual int read() { return -1; }
+  virtual int peek() { return -1; }
+  size_t readBytes(uint8_t *b, size_t n) { size_t i=0; while (i<n && available()) b[i++] = read(); return i; }
+};
+extern Stream Serial;
+extern Stream Serial1;
+#define PROGMEM
+#define pgm_read_byte(addr) (*(const uint8_t *)(addr))
+#define pgm_read_word(addr) (*(const uint16_t *)(addr))
+#define pgm_read_dword(addr) (*(const uint32_t *)(addr))
+#define memcpy_P memcpy
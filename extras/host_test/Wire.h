@@ -0,0 +1,17 @@
+#pragma once
+#include "Arduino.h"
+class TwoWire : public Stream {
+public:
+  void begin() {}
+  void setClock(uint32_t c) { clock = c; }
+  uint32_t clock = 0;
+  void beginTransmission(uint8_t a) { addr = a; txn = 0; }
+  size_t write(uint8_t c) override { if (txn < sizeof tx) tx[txn++] = c; return 1; }
+  size_t write(const uint8_t *b, size_t n) override { for (size_t i=0;i<n;i++) write(b[i]); return n; }
+  uint8_t endTransmission(bool stop = true);
+  uint8_t requestFrom(uint8_t address, uint8_t quantity, uint8_t stop = true);
+  int available() override { return rxn - rxi; }
+  int read() override { return rxi < rxn ? rx[rxi++] : -1; }
+  uint8_t addr; uint8_t tx[256]; size_t txn; uint8_t rx[256]; int rxn = 0, rxi = 0;
+};
+extern TwoWire Wire;
@@ -0,0 +1,7 @@
+// minimal checks for the host tests: prints each failure, main() returns the count
+#pragma once
+#include <cstdio>
+
+static int failures = 0;
+
+#define CHECK(x) do { if (!(x)) { printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #x); failures++; } } while (0)
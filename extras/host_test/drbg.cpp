@@ -0,0 +1,29 @@
+/*
+  ATECCX08A_DRBG: never seeds from the RNG test pattern of an IC with an unlocked config zone.
+*/
+#include "SparkFun_ATECCX08a_Arduino_Library.h"
+#include "SparkFun_ATECCX08a_DRBG.h"
+#include "check.h"
+
+int main()
+{
+  ATECCX08A atecc;
+  ATECCX08A_DRBG drbg(atecc);
+  uint8_t output[16];
+
+  CHECK(atecc.begin());
+
+  // the simulated IC starts with its config zone unlocked
+  CHECK(!atecc.randomReady());
+  CHECK(atecc.lastStatus() == ATECC_STATUS_CONFIG_UNLOCKED);
+  CHECK(!drbg.begin());
+  CHECK(atecc.lastStatus() == ATECC_STATUS_CONFIG_UNLOCKED);
+  CHECK(!drbg.generate(output, sizeof(output)));
+
+  CHECK(atecc.lockConfig());
+  CHECK(atecc.randomReady());
+  CHECK(drbg.begin());
+  CHECK(drbg.generate(output, sizeof(output)));
+
+  return failures;
+}
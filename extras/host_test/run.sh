@@ -0,0 +1,26 @@
+#!/bin/sh
+# Builds and runs the host tests against the simulated IC (needs g++).
+# Usage: sh extras/host_test/run.sh                  all tests
+#        sh extras/host_test/run.sh <test> [args]    one test, e.g. stress_threads nolock
+dir=$(cd "$(dirname "$0")" && pwd)
+
+run() {
+  name=$1; shift
+  out=${TMPDIR:-/tmp}/atecc_$name
+  g++ -std=gnu++11 -O1 -DARDUINO=10810 -DATECCX08A_STD_MUTEX -I"$dir" -I"$dir/../../src" \
+    "$dir/$name.cpp" "$dir/sim.cpp" "$dir"/../../src/*.cpp -o "$out" -lpthread \
+    && "$out" "$@"
+}
+
+if [ $# -gt 0 ]; then
+  run "$@"
+  exit $?
+fi
+
+failed=0
+for test in "$dir"/*.cpp; do
+  name=$(basename "$test" .cpp)
+  [ "$name" = sim ] && continue
+  if run "$name"; then echo "PASS $name"; else echo "FAIL $name"; failed=1; fi
+done
+exit $failed
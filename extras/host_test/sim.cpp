@@ -0,0 +1,101 @@
+/*
+  Host build support for the host tests: Arduino timing, Serial and Wire, and a simulated
+  ATECC508A/608 on the Wire bus (wake, idle, sleep, watchdog, CRCs, and the commands the
+  tests use). Time is simulated: delay() advances micros() and millis() instantly.
+  The simulated IC is not a crypto reference: SIGN returns a fixed pattern, and VERIFY always passes.
+*/
+
+#include "Wire.h"
+#include <vector>
+unsigned long simMicros = 0; // simulated time, advanced by delay()
+unsigned long millis() { return simMicros / 1000; }
+unsigned long micros() { return simMicros; }
+void delay(unsigned long ms) { simMicros += ms * 1000; }
+void delayMicroseconds(unsigned int us) { simMicros += us; }
+void yield() {}
+Stream Serial;
+Stream Serial1;
+TwoWire Wire;
+
+// ---- simulated ATECC ----
+struct Sim {
+  bool awake = false;
+  std::vector<uint8_t> out;
+  uint8_t config[128];
+  uint8_t data[16*416];
+  uint8_t tempKey[32];
+  std::vector<uint8_t> sha;
+  int commands = 0;
+  Sim() { for (int i=0;i<128;i++) config[i]=i; config[87]=0x55; config[86]=0x00;
+    for (int k=0;k<16;k++) { config[20+2*k]=0; config[21+2*k]=0; config[96+2*k]=0x3C; config[97+2*k]=0; }
+    for (int k=0;k<2;k++) { config[20+2*k]=0x83; config[21+2*k]=0x20; config[96+2*k]=0x33; } }
+} sim;
+
+static void crc16(const uint8_t *d, size_t n, uint8_t *o) {
+  uint16_t r = 0;
+  for (size_t c=0;c<n;c++) for (uint8_t s=1;s;s<<=1){ uint8_t db=(d[c]&s)?1:0, cb=r>>15; r<<=1; if(db!=cb) r^=0x8005; }
+  o[0]=r&0xff; o[1]=r>>8;
+}
+static void respond(const uint8_t *d, size_t n) {
+  sim.out.clear(); sim.out.push_back(n+3); sim.out.insert(sim.out.end(), d, d+n);
+  uint8_t c[2]; crc16(sim.out.data(), sim.out.size(), c); sim.out.push_back(c[0]); sim.out.push_back(c[1]);
+}
+static void status(uint8_t s) { respond(&s, 1); }
+#include "SparkFun_ATECCX08a_SHA256.h"
+static void exec(const uint8_t *p, size_t n) {
+  uint8_t c[2]; crc16(p, n-2, c);
+  if (c[0]!=p[n-2]||c[1]!=p[n-1]) { status(0xFF); return; }
+  sim.commands++;
+  uint8_t op=p[1], p1=p[2]; uint16_t p2=p[3]|(p[4]<<8); const uint8_t *data=p+5; size_t dl=n-7;
+  uint8_t buf[64]; for (int i=0;i<64;i++) buf[i]=(uint8_t)(i*7+sim.commands);
+  switch(op){
+    case 0x30: { uint8_t r[4]={0,0,0x50,0}; respond(r,4); break; }
+    case 0x1B: respond(buf,32); break;
+    case 0x16: if ((p1&3)==3) { memcpy(sim.tempKey,data,32); status(0);} else respond(buf,32); break;
+    case 0x41: respond(buf,64); break;
+    case 0x45: status(0); break;
+    case 0x40: respond(buf,64); break;
+    case 0x02: { size_t l=(p1&0x80)?32:4;
+      if ((p1&3)==2) { size_t off=((p2>>3)&15)*416 + (p2>>8)*32 + (p2&7)*4; respond(sim.data+off, l); break; }
+      size_t off = (p1&3)==0 ? (p2&0xff)*4 : 0; respond(sim.config+ (off<128?off:0), l); break; }
+    case 0x12: {
+      if ((p1&3)==2) { size_t off=((p2>>3)&15)*416 + (p2>>8)*32 + (p2&7)*4; if (dl!=((p1&0x80)?32u:4u)) { status(0x0F); break; } memcpy(sim.data+off,data,dl); status(0); break; }
+      if((p1&3)==0){
+        size_t off=(p2&0xff)*4; size_t want=(p1&0x80)?32:4;
+        if (dl!=want || sim.config[87]==0x00) { status(0x0F); break; }
+        for (size_t w=off/4; w<(off+dl)/4; w++) if (w<4 || w==21) { status(0x0F); goto done; }
+        memcpy(sim.config+off,data,dl);
+      }
+      status(0); done: break; }
+    case 0x17: {
+      if ((p1&3)==0) {
+        if (!(p1&0x80)) { uint8_t c2[2]; crc16(sim.config,128,c2); if ((c2[0]|(c2[1]<<8))!=p2) { status(0x01); break; } }
+        sim.config[87]=0x00;
+      } else if ((p1&3)==1) sim.config[86]=0x00;
+      status(0); break; }
+    case 0x47: {
+      if ((p1&7)==0) { sim.sha.clear(); status(0); }
+      else if ((p1&7)==1) { sim.sha.insert(sim.sha.end(), data, data+dl); status(0); }
+      else { sim.sha.insert(sim.sha.end(), data, data+dl); uint8_t h[32]; ATECCX08A_SHA256::hash(sim.sha.data(), sim.sha.size(), h); respond(h,32); }
+      break; }
+    default: status(0x03);
+  }
+}
+static unsigned long wakeAt = 0;
+uint8_t TwoWire::endTransmission(bool) {
+  if (sim.awake && simMicros - wakeAt > 1300000) { sim.awake = false; sim.sha.clear(); } // watchdog
+  if (addr == 0x00 && clock > 100000) return 2; // pulse too short
+  if (addr == 0x00) { if (!sim.awake) { sim.awake = true; wakeAt = simMicros; uint8_t s=0x11; respond(&s,1);} return 2; }
+  if (!sim.awake) return 2;
+  if (txn == 0) return 0;
+  if (tx[0]==0x02 || tx[0]==0x01) { sim.awake = false; sim.sha.clear(); return 0; }
+  if (tx[0]==0x03) exec(tx+1, txn-1);
+  return 0;
+}
+uint8_t TwoWire::requestFrom(uint8_t, uint8_t q, uint8_t) {
+  rxn=0; rxi=0;
+  if (!sim.awake) return 0;
+  size_t k = q < sim.out.size() ? q : sim.out.size();
+  memcpy(rx, sim.out.data(), k); rxn = k; sim.out.erase(sim.out.begin(), sim.out.begin()+k);
+  return k;
+}
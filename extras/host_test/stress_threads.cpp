@@ -0,0 +1,60 @@
+/*
+  Stress test for setLock() and ATECCX08A_Queue: 20 threads share one simulated IC.
+  8 threads call the library directly (SHA-256, slot reads, RANDOM, SIGN) and check every
+  result, 12 submit SHA-256 jobs to an ATECCX08A_Queue served by one worker thread.
+  Run with no arguments to use ATECCX08A_StdLock, exits non-zero on any wrong result.
+  Any argument runs it without the lock, which should fail (shows the test catches the races).
+*/
+#include "SparkFun_ATECCX08a_Arduino_Library.h"
+#include "SparkFun_ATECCX08a_Concurrency.h"
+#include "SparkFun_ATECCX08a_SHA256.h"
+#include <thread>
+#include <vector>
+#include <cstdio>
+#include <cstdlib>
+ATECCX08A a;
+std::atomic<int> fails(0), ops(0);
+struct Ctx { uint8_t msg[100]; size_t len; uint8_t hash[32]; };
+static bool hashJob(ATECCX08A &d, void *c) { Ctx *x=(Ctx*)c; return d.sha256(x->msg,x->len,x->hash); }
+void worker_direct(int id, int n) {
+  for (int i=0;i<n;i++) {
+    uint8_t msg[100]; size_t len = 1 + (id*31+i)%99; for (size_t k=0;k<len;k++) msg[k]=id*13+i+k;
+    uint8_t h[32], ref[32];
+    if (!a.sha256(msg,len,h)) fails++;
+    ATECCX08A_SHA256::hash(msg,len,ref);
+    if (memcmp(h,ref,32)) fails++;
+    uint8_t slot[64], exp[64]; for (int k=0;k<64;k++) exp[k]=(uint8_t)((8+id)*3+k);
+    if (!a.readSlot(8+id,slot,64) || memcmp(slot,exp,64)) fails++;
+    uint8_t r[32]; if (!a.updateRandom32Bytes(false,r) || (uint8_t)(r[1]-r[0])!=7 || (uint8_t)(r[31]-r[30])!=7) fails++;
+    uint8_t sig[64]; uint8_t d[32]={0}; if (!a.createSignature(d,0,sig) || (uint8_t)(sig[63]-sig[62])!=7) fails++;
+    ops++;
+  }
+}
+void worker_queue(ATECCX08A_Queue *q, int id, int n) {
+  for (int i=0;i<n;i++) {
+    Ctx c; c.len = 1+(id*7+i)%99; for (size_t k=0;k<c.len;k++) c.msg[k]=id+i*k;
+    ATECCX08A_Request req;
+    while (!q->submit(&req, hashJob, &c)) std::this_thread::yield();
+    while (!ATECCX08A_Queue::done(&req)) std::this_thread::yield();
+    uint8_t ref[32]; ATECCX08A_SHA256::hash(c.msg,c.len,ref);
+    if (!req.result || memcmp(ref,c.hash,32)) fails++;
+    ops++;
+  }
+}
+int main(int argc, char **argv) {
+  bool useLock = argc < 2;
+  a.begin();
+  for (int s=0;s<8;s++){ uint8_t exp[64]; for (int k=0;k<64;k++) exp[k]=(uint8_t)((8+s)*3+k); a.writeSlot(8+s,exp,64); }
+  ATECCX08A_StdLock lock;
+  if (useLock) a.setLock(&lock);
+  ATECCX08A_Queue q(a);
+  std::atomic<bool> stop(false);
+  std::thread w([&]{ while(!stop) if(!q.process()) std::this_thread::yield(); });
+  std::vector<std::thread> ts;
+  for (int i=0;i<8;i++) ts.emplace_back(worker_direct,i,300);
+  for (int i=0;i<12;i++) ts.emplace_back(worker_queue,&q,i,300);
+  for (auto &t: ts) t.join();
+  stop=true; w.join();
+  printf("lock=%d ops=%d fails=%d\n", useLock, ops.load(), fails.load());
+  return fails ? 1 : 0;
+}
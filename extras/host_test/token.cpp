@@ -0,0 +1,64 @@
+/*
+  ATECCX08A_Token: a token that fails must not leave the SHA session (and the lock) open.
+*/
+#include "SparkFun_ATECCX08a_Arduino_Library.h"
+#include "SparkFun_ATECCX08a_Token.h"
+#include "check.h"
+
+// counts how deep the lock is held
+class CountingLock : public ATECCX08A_Lock {
+  public:
+	void lock() { depth++; }
+	void unlock() { depth--; }
+	int depth = 0;
+};
+
+class Sink : public Print {
+  public:
+	size_t write(uint8_t c) { return 1; }
+	size_t write(const uint8_t *b, size_t n) { return n; }
+};
+
+int main()
+{
+  ATECCX08A atecc;
+  ATECCX08A_Token token(atecc);
+  CountingLock lock;
+  uint8_t random[32];
+  uint8_t hash[SHA256_SIZE];
+  char buffer[256];
+
+  CHECK(atecc.begin());
+  atecc.setLock(&lock);
+
+  // header does not fit
+  CHECK(!token.beginJWT(buffer, 10, 0));
+  CHECK(lock.depth == 0);
+  CHECK(atecc.watchdogRemaining() == 0); // not kept awake
+  delay(5000);
+  CHECK(atecc.updateRandom32Bytes(false, random));
+  CHECK(atecc.sha256((uint8_t *)"abc", 3, hash));
+
+  // claims overflow the buffer
+  CHECK(token.beginJWT(buffer, 60, 0));
+  CHECK(!token.print("{\"iss\":\"a very long issuer that does not fit in the buffer\"}"));
+  CHECK(lock.depth == 0);
+  CHECK(!token.end());
+  CHECK(atecc.updateRandom32Bytes(false, random));
+
+  // more COSE payload than declared
+  uint8_t cose[128];
+  CHECK(token.beginCOSE(cose, sizeof(cose), 2, 0));
+  CHECK(!token.write((const uint8_t *)"abc", 3));
+  CHECK(lock.depth == 0);
+  CHECK(atecc.updateRandom32Bytes(false, random));
+
+  // a good token still works afterwards
+  Sink sink;
+  CHECK(token.beginJWT(sink, 0));
+  CHECK(token.print("{\"iss\":\"device\"}"));
+  CHECK(token.end());
+  CHECK(lock.depth == 0);
+
+  return failures;
+}
@@ -0,0 +1,53 @@
+/*
+  ATECCX08A_Trace: a recorded sha256() replays to the same hash without the IC,
+  and a read record with more bytes than requested ends the replay.
+*/
+#include "SparkFun_ATECCX08a_Arduino_Library.h"
+#include "SparkFun_ATECCX08a_Trace.h"
+#include "check.h"
+
+int main()
+{
+  static uint8_t buffer[4096];
+  static uint8_t recorded[4096];
+  ATECCX08A_Trace trace(buffer, sizeof(buffer));
+  uint8_t message[100];
+  uint8_t hash[SHA256_SIZE];
+  uint8_t replayed[SHA256_SIZE];
+
+  for (uint8_t i = 0; i < sizeof(message); i++)
+    message[i] = i;
+
+  // record: the simulated IC answers
+  ATECCX08A atecc;
+  atecc.setBus(&trace);
+  trace.record();
+  CHECK(atecc.begin());
+  CHECK(atecc.sha256(message, sizeof(message), hash));
+  trace.stop();
+  CHECK(trace.droppedTransactions() == 0);
+
+  size_t length = trace.copy(recorded, sizeof(recorded));
+  CHECK(length > 0);
+
+  // replay: the same calls, served from the trace
+  ATECCX08A replay;
+  replay.setBus(&trace);
+  trace.replay(recorded, length);
+  CHECK(replay.begin());
+  CHECK(replay.sha256(message, sizeof(message), replayed));
+  CHECK(memcmp(hash, replayed, SHA256_SIZE) == 0);
+  CHECK(trace.replayFinished());
+  CHECK(!trace.diverged());
+  CHECK(trace.mismatches() == 0);
+
+  // a read of 4 bytes, recorded as 5 received: diverged, nothing copied
+  const uint8_t tooLong[] = { TRACE_READ | ATECC508A_ADDRESS_DEFAULT, 0x00, 4, 5, 1, 2, 3, 4, 5 };
+  uint8_t data[5] = { 0 };
+  trace.replay(tooLong, sizeof(tooLong));
+  CHECK(trace.read(NULL, ATECC508A_ADDRESS_DEFAULT, data, 4) == 0);
+  CHECK(trace.diverged());
+  CHECK(data[4] == 0);
+
+  return failures;
+}
@@ -25,6 +25,170 @@
 */
 
 #include "SparkFun_ATECCX08a_Arduino_Library.h"
+#include "SparkFun_ATECCX08a_SHA256.h"
+#include "SparkFun_ATECCX08a_P256.h"
+
+/* Command table: one entry per opcode, used by executeCommand() and executionTime().
+   Execution times are max times in ms, one column per device variant (0 = not supported).
+   ATECC508A: the delays this library has always used, or the datasheet max.
+   ATECC608A/B: datasheet max times at the default clock divider (ChipMode M0).
+   Note, at M0 the 608 is not faster than the 508, and several commands take longer.
+   responseSize is the number of data bytes in a successful response (1 = status byte only),
+   and successCode is the status byte that means success for those. */
+typedef struct {
+  uint8_t opcode;
+  uint8_t time508A;
+  uint8_t time608;
+  uint8_t responseSize;
+  uint8_t successCode;
+} CommandDescriptor;
+
+static const CommandDescriptor commandDescriptors[] PROGMEM = {
+  { COMMAND_OPCODE_INFO,          1,   5, RESPONSE_INFO_SIZE,     0x00 },
+  { COMMAND_OPCODE_LOCK,         32,  35, RESPONSE_SIGNAL_SIZE,   ATRCC508A_SUCCESSFUL_LOCK },
+  { COMMAND_OPCODE_RANDOM,       23,  23, RESPONSE_RANDOM_SIZE,   0x00 },
+  { COMMAND_OPCODE_READ,          1,   5, 4,                      0x00 }, // 4 or 32 bytes
+  { COMMAND_OPCODE_WRITE,        26,  45, RESPONSE_SIGNAL_SIZE,   ATRCC508A_SUCCESSFUL_WRITE },
+  { COMMAND_OPCODE_SHA,           9,  36, RESPONSE_SIGNAL_SIZE,   ATRCC508A_SUCCESSFUL_SHA }, // digest (32) on END
+  { COMMAND_OPCODE_GENKEY,      115, 115, PUBLIC_KEY_SIZE,        0x00 },
+  { COMMAND_OPCODE_NONCE,         7,  20, RESPONSE_SIGNAL_SIZE,   ATRCC508A_SUCCESSFUL_TEMPKEY }, // RandOut (32) in random mode
+  { COMMAND_OPCODE_SIGN,         70, 115, SIGNATURE_SIZE,         0x00 },
+  { COMMAND_OPCODE_VERIFY,       58, 105, RESPONSE_SIGNAL_SIZE,   ATRCC508A_SUCCESSFUL_VERIFY },
+  { COMMAND_OPCODE_ECDH,         58,  75, RESPONSE_ECDH_SIZE,     ATRCC508A_SUCCESSFUL_ECDH }, // status only when written to a slot/TempKey
+  { COMMAND_OPCODE_AES,           0,  27, RESPONSE_AES_SIZE,      0x00 },
+  { COMMAND_OPCODE_CHECKMAC,     13,  40, RESPONSE_SIGNAL_SIZE,   0x00 },
+  { COMMAND_OPCODE_COUNTER,      20,  25, RESPONSE_COUNTER_SIZE,  0x00 },
+  { COMMAND_OPCODE_DERIVEKEY,    50,  50, RESPONSE_SIGNAL_SIZE,   0x00 },
+  { COMMAND_OPCODE_GENDIG,       11,  25, RESPONSE_SIGNAL_SIZE,   0x00 },
+  { COMMAND_OPCODE_HMAC,         23,   0, SHA256_SIZE,            0x00 },
+  { COMMAND_OPCODE_KDF,           0, 165, RESPONSE_SIGNAL_SIZE,   0x00 }, // output (32) when returned to the host
+  { COMMAND_OPCODE_MAC,          14,  55, RESPONSE_MAC_SIZE,      0x00 },
+  { COMMAND_OPCODE_PAUSE,         3,   0, RESPONSE_SIGNAL_SIZE,   0x00 },
+  { COMMAND_OPCODE_PRIVWRITE,    48,  50, RESPONSE_SIGNAL_SIZE,   0x00 },
+  { COMMAND_OPCODE_SECUREBOOT,    0,  80, RESPONSE_SIGNAL_SIZE,   0x00 },
+  { COMMAND_OPCODE_SELFTEST,      0, 250, RESPONSE_SIGNAL_SIZE,   0x00 },
+  { COMMAND_OPCODE_UPDATEEXTRA,  10,  10, RESPONSE_SIGNAL_SIZE,   0x00 },
+};
+
+#define EXECUTION_TIME_DEFAULT 115 // for opcodes missing from the table
+
+/* Compile-time CRC of a parameter-only command frame (count, opcode, param1, param2),
+   same algorithm as atca_calculate_crc(). Written as single-return constexpr for C++11 compilers. */
+static constexpr uint16_t crcStep(uint16_t crc_register, uint8_t data_bit)
+{
+  return (uint16_t)((data_bit != (crc_register >> 15)) ? ((uint16_t)(crc_register << 1) ^ 0x8005) : (uint16_t)(crc_register << 1));
+}
+
+static constexpr uint16_t crcByte(uint16_t crc_register, uint8_t data, uint8_t bit = 0)
+{
+  return (bit == 8) ? crc_register : crcByte(crcStep(crc_register, (data >> bit) & 0x01), data, bit + 1);
+}
+
+static constexpr uint16_t constantFrameCrc(uint8_t opcode, uint8_t param1, uint16_t param2)
+{
+  return crcByte(crcByte(crcByte(crcByte(crcByte(0, CONSTANT_FRAME_SIZE - ATRCC508A_PROTOCOL_FIELD_SIZE_COMMAND), opcode), param1), param2 & 0xFF), param2 >> 8);
+}
+
+#define CONSTANT_FRAME(OPCODE, PARAM1, PARAM2) { \
+  WORD_ADDRESS_VALUE_COMMAND, CONSTANT_FRAME_SIZE - ATRCC508A_PROTOCOL_FIELD_SIZE_COMMAND, (OPCODE), (PARAM1), \
+  (uint8_t)((PARAM2) & 0xFF), (uint8_t)((PARAM2) >> 8), \
+  (uint8_t)(constantFrameCrc((OPCODE), (PARAM1), (PARAM2)) & 0xFF), (uint8_t)(constantFrameCrc((OPCODE), (PARAM1), (PARAM2)) >> 8) }
+
+/* Complete frames (word address to CRC) for commands that never carry data, so their CRC is never recalculated. */
+static const uint8_t constantFrames[][CONSTANT_FRAME_SIZE] PROGMEM = {
+  CONSTANT_FRAME(COMMAND_OPCODE_RANDOM, 0x00, 0x0000), // FRAME_RANDOM
+  CONSTANT_FRAME(COMMAND_OPCODE_INFO, 0x00, 0x0000), // FRAME_INFO
+  CONSTANT_FRAME(COMMAND_OPCODE_LOCK, LOCK_MODE_ZONE_CONFIG, 0x0000), // FRAME_LOCK_CONFIG
+  CONSTANT_FRAME(COMMAND_OPCODE_LOCK, LOCK_MODE_ZONE_DATA_AND_OTP, 0x0000), // FRAME_LOCK_DATA_AND_OTP
+  CONSTANT_FRAME(COMMAND_OPCODE_LOCK, LOCK_MODE_SLOT0, 0x0000), // FRAME_LOCK_SLOT0
+  CONSTANT_FRAME(COMMAND_OPCODE_GENKEY, GENKEY_MODE_PUBLIC, 0), // FRAME_GENKEY_PUBLIC(0)
+  CONSTANT_FRAME(COMMAND_OPCODE_GENKEY, GENKEY_MODE_PUBLIC, 1),
+  CONSTANT_FRAME(COMMAND_OPCODE_GENKEY, GENKEY_MODE_PUBLIC, 2),
+  CONSTANT_FRAME(COMMAND_OPCODE_GENKEY, GENKEY_MODE_PUBLIC, 3),
+  CONSTANT_FRAME(COMMAND_OPCODE_GENKEY, GENKEY_MODE_PUBLIC, 4),
+  CONSTANT_FRAME(COMMAND_OPCODE_GENKEY, GENKEY_MODE_PUBLIC, 5),
+  CONSTANT_FRAME(COMMAND_OPCODE_GENKEY, GENKEY_MODE_PUBLIC, 6),
+  CONSTANT_FRAME(COMMAND_OPCODE_GENKEY, GENKEY_MODE_PUBLIC, 7),
+  CONSTANT_FRAME(COMMAND_OPCODE_GENKEY, GENKEY_MODE_PUBLIC, 8),
+  CONSTANT_FRAME(COMMAND_OPCODE_GENKEY, GENKEY_MODE_PUBLIC, 9),
+  CONSTANT_FRAME(COMMAND_OPCODE_GENKEY, GENKEY_MODE_PUBLIC, 10),
+  CONSTANT_FRAME(COMMAND_OPCODE_GENKEY, GENKEY_MODE_PUBLIC, 11),
+  CONSTANT_FRAME(COMMAND_OPCODE_GENKEY, GENKEY_MODE_PUBLIC, 12),
+  CONSTANT_FRAME(COMMAND_OPCODE_GENKEY, GENKEY_MODE_PUBLIC, 13),
+  CONSTANT_FRAME(COMMAND_OPCODE_GENKEY, GENKEY_MODE_PUBLIC, 14),
+  CONSTANT_FRAME(COMMAND_OPCODE_GENKEY, GENKEY_MODE_PUBLIC, 15),
+};
+
+#define FRAME_RANDOM				0
+#define FRAME_INFO					1
+#define FRAME_LOCK_CONFIG			2
+#define FRAME_LOCK_DATA_AND_OTP		3
+#define FRAME_LOCK_SLOT0			4
+#define FRAME_GENKEY_PUBLIC(SLOT)	(5 + (SLOT))
+
+// Maps a status byte from the IC to ATECCX08A_Status
+static ATECCX08A_Status deviceStatus(uint8_t status)
+{
+  switch (status)
+  {
+    case ATECC_STATUS_SUCCESS:
+    case ATECC_STATUS_MISCOMPARE:
+    case ATECC_STATUS_PARSE_ERROR:
+    case ATECC_STATUS_ECC_FAULT:
+    case ATECC_STATUS_SELFTEST_ERROR:
+    case ATECC_STATUS_HEALTH_TEST_ERROR:
+    case ATECC_STATUS_EXECUTION_ERROR:
+    case ATECC_STATUS_AFTER_WAKE:
+    case ATECC_STATUS_WATCHDOG:
+    case ATECC_STATUS_DEVICE_CRC_ERROR:
+      return (ATECCX08A_Status)status;
+    default:
+      return ATECC_STATUS_UNKNOWN;
+  }
+}
+
+// Commands that leave TempKey alone. Every other command may use, overwrite or clear it.
+static bool keepsTempKey(uint8_t command_opcode)
+{
+  switch (command_opcode)
+  {
+    case COMMAND_OPCODE_INFO:
+    case COMMAND_OPCODE_LOCK:
+    case COMMAND_OPCODE_RANDOM:
+    case COMMAND_OPCODE_READ:
+    case COMMAND_OPCODE_COUNTER:
+    case COMMAND_OPCODE_UPDATEEXTRA:
+      return true;
+    default:
+      return false;
+  }
+}
+
+static_assert((sizeof(commandDescriptors) / sizeof(commandDescriptors[0])) == ATECC_COMMAND_TYPES, "ATECC_COMMAND_TYPES must match commandDescriptors[]");
+
+// position of command_opcode in commandDescriptors[], -1 if it is not there
+static int8_t commandIndex(uint8_t command_opcode)
+{
+  for (uint8_t i = 0; i < ATECC_COMMAND_TYPES; i++)
+  {
+    if (pgm_read_byte(&commandDescriptors[i].opcode) == command_opcode)
+      return i;
+  }
+
+  return -1;
+}
+
+/* Looks up the command table entry for an opcode. Returns false if the opcode is not in the table. */
+static bool findCommandDescriptor(uint8_t command_opcode, CommandDescriptor *descriptor)
+{
+  int8_t index = commandIndex(command_opcode);
+
+  if (index < 0)
+    return false;
+
+  memcpy_P(descriptor, &commandDescriptors[index], sizeof(CommandDescriptor));
+  return true;
+}
 
 /** \brief
 
@@ -33,6 +197,9 @@
 	returns false if IC does not respond,
 	returns true if wake() function is successful
 
+	Also detects the device variant (ATECC508A or ATECC608A/B) with the INFO command,
+	unless it was pinned at compile time with ATECCX08A_DEVICE_VARIANT.
+
 	Note, in most SparkFun Arduino Libraries, begin would call a different
 	function called isConnected() to check status on the bus, but because
 	this IC will ACK and respond with a status, we are gonna use wakeUp()
@@ -48,7 +215,17 @@ bool ATECCX08A::begin(uint8_t i2caddr, TwoWire &wirePort, Stream &serialPort)
 
   _i2caddr = i2caddr;
 
-  return ( wakeUp() ); // see if the IC wakes up properly, return responce.
+  _powerState = ATECC_STATE_SLEEP; // as after power up
+  resetPowerStats();
+
+  if (!wakeUp()) // see if the IC wakes up properly
+    return false;
+
+  #if !defined(ATECCX08A_DEVICE_VARIANT)
+  getInfo(); // detect the device variant, to select command timings. An unknown variant uses worst case timings.
+  #endif
+
+  return true;
 }
 
 /** \brief
@@ -70,26 +247,36 @@ bool ATECCX08A::begin(uint8_t i2caddr, TwoWire &wirePort, Stream &serialPort)
 
 bool ATECCX08A::wakeUp()
 {
-  _i2cPort->beginTransmission(0x00); // set up to write to address "0x00",
+  uint8_t previousState = _powerState;
+
+  powerEnter(ATECC_STATE_AWAKE); // the IC draws the awake current from the wake pulse on
+  _awakeAccounted = 0; // a fresh watchdog window
+
+  applyClock(ATECC_WAKE_CLOCK_HZ); // only if setI2CClock() was used, the port is at 100kHz otherwise
+
+  busWrite(0x00, NULL, 0); // write to address "0x00",
   // This creates a "wake condition" where SDA is held low for at least tWLO
   // tWLO means "wake low duration" and must be at least 60 uSeconds (which is acheived by writing 0x00 at 100KHz I2C)
-  _i2cPort->endTransmission(); // actually send it
+
+  applyClock(_sessionDepth ? _dataClock : _busClock);
 
   delayMicroseconds(1500); // required for the IC to actually wake up.
   // 1500 uSeconds is minimum and known as "Wake High Delay to Data Comm." tWHI, and SDA must be high during this time.
 
   // Now let's read back from the IC and see if it reports back good things.
   countGlobal = 0;
+  _awake = false;
 
-  if (!receiveResponseData(RESPONSE_COUNT_SIZE + RESPONSE_SIGNAL_SIZE + CRC_SIZE))
-    return false;
-
-  if (!checkCount() || !checkCrc())
-    return false;
+  if (!receiveResponseData(RESPONSE_COUNT_SIZE + RESPONSE_SIGNAL_SIZE + CRC_SIZE) || !checkCount() || !checkCrc()
+      || (inputBuffer[RESPONSE_SIGNAL_INDEX] != ATRCC508A_SUCCESSFUL_WAKEUP)) // If we hear a "0x11", that means it had a successful wake up.
+  {
+    powerEnter((previousState == ATECC_STATE_IDLE) ? ATECC_STATE_IDLE : ATECC_STATE_SLEEP); // it did not wake, or the watchdog had put it to sleep
+    return fail(ATECC_STATUS_WAKE_FAILED);
+  }
 
-  // If we hear a "0x11", that means it had a successful wake up.
-  if (inputBuffer[RESPONSE_SIGNAL_INDEX] != ATRCC508A_SUCCESSFUL_WAKEUP)
-    return false;
+  _awake = true;
+  _wakeMillis = millis();
+  _powerStats.wakes++;
 
   return true;
 }
@@ -101,14 +288,21 @@ bool ATECCX08A::wakeUp()
 	The ATECCX08A goes into the idle mode and ignores all subsequent I/O transitions
 	until the next wake flag. The contents of TempKey and RNG Seed registers are retained.
 	Idle Power Supply Current: 800uA.
-	Note, it will automatically go into sleep mode after watchdog timer has been reached (1.3-1.7sec).
+	Note, the watchdog timer stops in idle mode, and starts a fresh window (1.3-1.7sec) at the next wake.
+	So an idle IC stays idle until the next call, see setPowerPolicy().
 */
 
 bool ATECCX08A::idleMode()
 {
-  _i2cPort->beginTransmission(_i2caddr); // set up to write to address
-  _i2cPort->write(WORD_ADDRESS_VALUE_IDLE); // enter idle command (aka word address - the first part of every communication to the IC)
-  return (_i2cPort->endTransmission() == 0); // actually send it
+  uint8_t wordAddress = WORD_ADDRESS_VALUE_IDLE; // enter idle command (aka word address - the first part of every communication to the IC)
+
+  if (_awake)
+  {
+    powerAccount();
+    powerEnter((_awakeAccounted >= ATECC_WATCHDOG_TIMEOUT_MS * 1000UL) ? ATECC_STATE_SLEEP : ATECC_STATE_IDLE); // the watchdog may have put it to sleep already
+  }
+  _awake = false;
+  return (busWrite(_i2caddr, &wordAddress, 1) == 0);
 }
 
 /** \brief
@@ -120,402 +314,381 @@ bool ATECCX08A::idleMode()
 	Idle Power Supply Current: 150nA.
 	This helps avoid waiting for watchdog timer and immidiately puts the device in sleep mode.
 	With this sleep/wakeup cycle, RNG seed registers are updated from internal entropy.
+	An idle IC only listens for a wake, so it is woken first to take the sleep command.
 */
 
 bool ATECCX08A::sleep()
 {
-  idleMode();
-  _i2cPort->beginTransmission(_i2caddr); // set up to write to address
-  _i2cPort->write(WORD_ADDRESS_VALUE_SLEEP); // enter sleep command (aka word address - the first part of every communication to the IC)
-  return (_i2cPort->endTransmission() == 0); // actually send it
-}
-
-/** \brief
-
-	getInfo()
+  bool result;
 
-	This function sends the INFO Command and listens for the correct version (0x50) within the response.
-	The Info command has a mode parameter, and in this function we are using the "Revision" mode (0x00)
-	At the time of data sheet creation the Info command will return 0x00 0x00 0x50 0x00. For
-	all versions of the ECC508A the 3rd byte will always be 0x50. The fourth byte will indicate the
-	silicon revision.
-*/
+  if (_lock)
+    _lock->lock();
 
-bool ATECCX08A::getInfo()
-{
-  if (!sendCommand(COMMAND_OPCODE_INFO, 0x00, 0x0000)) // param1 - 0x00 (revision mode).
+  if (_started)
   {
-    return false;
+    finishStarted(); // let a started command end first, see startCommand()
+    endSession();
   }
 
-  delay(1); // time for IC to process command and exectute
-
-    // Now let's read back from the IC and see if it reports back good things.
-  countGlobal = 0;
-  if (!receiveResponseData(RESPONSE_COUNT_SIZE + RESPONSE_INFO_SIZE + CRC_SIZE, true))
-    return false;
-
-  idleMode();
+  _sessionDepth = 0; // TempKey is lost, so any session is over
+  result = enterSleep();
 
-  if (!checkCount()|| !checkCrc())
-    return false;
-
-  // If we hear a "0x50", that means it had a successful version response.
-  if (inputBuffer[RESPONSE_GETINFO_SIGNAL_INDEX] != ATRCC508A_SUCCESSFUL_GETINFO)
-    return false;
+  if (_lock)
+    _lock->unlock();
 
-  return true;
+  return result;
 }
 
 /** \brief
 
-	lockConfig()
+	beginSession()
 
-	This function sends the LOCK Command with the configuration zone parameter,
-	and listens for success response (0x00).
+	Keeps the IC awake across several commands.
+	Normally every command wakes the IC, and sends it to idle afterwards.
+	Inside a session, the IC is only woken for the first command (or again if the
+	watchdog would have put it to sleep), and it is not sent to idle until endSession().
+	This saves the wake sequence on every command of a multi-command operation.
+	Keep sessions short: the watchdog puts the IC to sleep 1.3-1.7 sec after wake.
 */
 
-bool ATECCX08A::lockConfig()
+void ATECCX08A::beginSession()
 {
-  return lock(LOCK_MODE_ZONE_CONFIG);
+  if (_lock)
+    _lock->lock(); // held until the matching endSession()
+
+  if (_sessionDepth++ == 0)
+    applyClock(_dataClock);
 }
 
 /** \brief
 
-	readConfigZone()
+	endSession()
 
-	This function reads the entire configuration zone EEPROM memory on the device.
-	It stores them for vewieing in a large array called configZone[128].
-	In addition to configuration settings, the configuration memory on the IC also
-	contains the serial number, revision number, lock statuses, and much more.
-	This function also updates global variables for these other things.
+	Ends a session started with beginSession(). The outermost call sends the IC to idle.
 */
 
-bool ATECCX08A::readConfigZone(bool debug)
+void ATECCX08A::endSession()
 {
-  // read block 0, the first 32 bytes of config zone into inputBuffer
-  read(ZONE_CONFIG, ADDRESS_CONFIG_READ_BLOCK_0, CONFIG_ZONE_READ_SIZE);
-
-  // copy current contents of inputBuffer into configZone[] (for later viewing/comparing)
-  memcpy(&configZone[CONFIG_ZONE_READ_SIZE * 0], &inputBuffer[1], CONFIG_ZONE_READ_SIZE);
+  if (_sessionDepth > 0)
+    _sessionDepth--;
 
-  read(ZONE_CONFIG, ADDRESS_CONFIG_READ_BLOCK_1, CONFIG_ZONE_READ_SIZE); 	// read block 1
-  memcpy(&configZone[CONFIG_ZONE_READ_SIZE * 1], &inputBuffer[1], CONFIG_ZONE_READ_SIZE); 	// copy block 1
+  if (_sessionDepth == 0)
+  {
+    if (_awake)
+      powerDown();
+    applyClock(_busClock);
+  }
 
-  read(ZONE_CONFIG, ADDRESS_CONFIG_READ_BLOCK_2, CONFIG_ZONE_READ_SIZE); 	// read block 2
-  memcpy(&configZone[CONFIG_ZONE_READ_SIZE * 2], &inputBuffer[1], CONFIG_ZONE_READ_SIZE); 	// copy block 2
+  if (_lock)
+    _lock->unlock();
+}
 
-  read(ZONE_CONFIG, ADDRESS_CONFIG_READ_BLOCK_3, CONFIG_ZONE_READ_SIZE); 	// read block 3
-  memcpy(&configZone[CONFIG_ZONE_READ_SIZE * 3], &inputBuffer[1], CONFIG_ZONE_READ_SIZE); 	// copy block 3
+/** \brief
 
-  // pull out serial number from configZone, and copy to public variable within this instance
-  memcpy(&serialNumber[0], &configZone[CONFIG_ZONE_SERIAL_PART0], 4); 	// copy SN<0:3>
-  memcpy(&serialNumber[4], &configZone[CONFIG_ZONE_SERIAL_PART1], 5); 	// copy SN<4:8>
+	setI2CClock(uint32_t dataClock, uint32_t busClock)
 
-  // pull out revision number from configZone, and copy to public variable within this instance
-  memcpy(&revisionNumber[0], &configZone[CONFIG_ZONE_REVISION_NUMBER], 4); 	// copy RevNum<0:3>
+	Runs data transfers with the IC at dataClock (400kHz or 1MHz) instead of 100kHz.
+	Large commands (e.g. the 128-byte VERIFY frame) then take about a quarter of the bus time.
+	The wake pulse needs SDA held low for 60us, which writing address 0x00 only does at 100kHz,
+	so the clock drops to ATECC_WAKE_CLOCK_HZ for the wake pulse only.
 
-  // set lock statuses for config, data/otp, and slot 0
-  if (configZone[CONFIG_ZONE_LOCK_STATUS] == 0x00) configLockStatus = true;
-  else configLockStatus = false;
+	busClock is the clock other devices on the same TwoWire port need. It is restored after
+	each call (or at the end of a session), so the clock only changes around our transfers.
+	0 leaves the port at dataClock. Each ATECCX08A has its own settings, for its own port.
+*/
 
-  if (configZone[CONFIG_ZONE_OTP_LOCK] == 0x00) dataOTPLockStatus = true;
-  else dataOTPLockStatus = false;
+void ATECCX08A::setI2CClock(uint32_t dataClock, uint32_t busClock)
+{
+  if (dataClock > ATECC_MAX_CLOCK_HZ)
+    dataClock = ATECC_MAX_CLOCK_HZ;
 
-  if ( (configZone[CONFIG_ZONE_SLOTS_LOCK0] & (1 << 0) ) == true) slot0LockStatus = false; // LSB is slot 0. if bit set = UN-locked.
-  else slot0LockStatus = true;
+  _dataClock = dataClock;
+  _busClock = busClock ? busClock : dataClock;
 
-  memcpy(SlotConfig, &configZone[CONFIG_ZONE_SLOT_CONFIG], sizeof(uint16_t) * DATA_ZONE_SLOTS);
-  memcpy(KeyConfig, &configZone[CONFIG_ZONE_KEY_CONFIG], sizeof(uint16_t) * DATA_ZONE_SLOTS);
+  applyClock(_busClock);
+}
 
-  if (debug)
-  {
-    _debugSerial->println("configZone: ");
-    for (int i = 0; i < sizeof(configZone) ; i++)
-    {
-      _debugSerial->print(i);
-	  _debugSerial->print(": 0x");
-	  if ((configZone[i] >> 4) == 0) _debugSerial->print("0"); // print preceeding high nibble if it's zero
-	  _debugSerial->print(configZone[i], HEX);
-	  _debugSerial->print(" \t0b");
-	  for(int bit = 7; bit >= 0; bit--) _debugSerial->print(bitRead(configZone[i],bit)); // print binary WITH preceding '0' bits
-	  _debugSerial->println();
-    }
-    _debugSerial->println();
-  }
+void ATECCX08A::applyClock(uint32_t clock)
+{
+  if ((_dataClock == 0) || (clock == _portClock))
+    return; // setClock() is slow on some cores, so only when it changes
 
-  return true;
+  _i2cPort->setClock(clock);
+  _portClock = clock;
 }
 
 /** \brief
 
-	lockDataAndOTP()
+	setLock(ATECCX08A_Lock *lock)
 
-	This function sends the LOCK Command with the Data and OTP (one-time-programming) zone parameter,
-	and listens for success response (0x00).
+	Makes every library call atomic against the IC when several tasks or threads share it.
+	Each call (and each session) holds the lock from its first command until its results
+	have been copied out of inputBuffer[], so frames and responses can no longer interleave.
+
+	Results also land in the shared members (signature[], publicKey64Bytes[], random32Bytes[]).
+	When sharing, pass an output pointer (e.g. createSignature(data, slot, mySignature))
+	so another task can not overwrite the result before you read it.
+
+	Set the lock before any other task uses the IC, and not inside a session.
 */
 
-bool ATECCX08A::lockDataAndOTP()
+void ATECCX08A::setLock(ATECCX08A_Lock *lock)
 {
-  return lock(LOCK_MODE_ZONE_DATA_AND_OTP);
+  _lock = lock;
 }
 
 /** \brief
 
-	lockDataSlot0()
+	idleAfterCommand()
 
-	This function sends the LOCK Command with the Slot 0 zone parameter,
-	and listens for success response (0x00).
+	Called at the end of each command. Sends the IC to idle (or to sleep, see setPowerPolicy()),
+	unless we are inside a session.
 */
 
-bool ATECCX08A::lockDataSlot0()
+void ATECCX08A::idleAfterCommand()
 {
-  return lock(LOCK_MODE_SLOT0);
+  if (_sessionDepth == 0)
+    powerDown();
 }
 
 /** \brief
 
-	lock(byte zone)
+	getInfo()
 
-	This function sends the LOCK Command using the argument zone as parameter 1,
-	and listens for success response (0x00).
+	This function sends the INFO Command and listens for the correct version (0x50 or 0x60) within the response.
+	The Info command has a mode parameter, and in this function we are using the "Revision" mode (0x00)
+	At the time of data sheet creation the Info command will return 0x00 0x00 0x50 0x00. For
+	all versions of the ECC508A the 3rd byte will always be 0x50, and for the ECC608A/B it is 0x60.
+	The fourth byte will indicate the silicon revision.
+	The result selects the device variant, see deviceVariant().
 */
 
-bool ATECCX08A::lock(uint8_t zone)
+bool ATECCX08A::getInfo()
 {
-  if (!sendCommand(COMMAND_OPCODE_LOCK, zone, 0x0000))
-    return false;
-
-  delay(32); // time for IC to process command and exectute
+  uint8_t revision;
+  uint8_t siliconRevision;
 
-  // Now let's read back from the IC and see if it reports back good things.
-  countGlobal = 0;
+  beginSession();
 
-  if (!receiveResponseData(RESPONSE_COUNT_SIZE + RESPONSE_SIGNAL_SIZE + CRC_SIZE))
+  // param1 - 0x00 (revision mode).
+  if (!executeConstantCommand(FRAME_INFO))
+  {
+    endSession();
     return false;
+  }
 
-  idleMode();
+  revision = inputBuffer[RESPONSE_GETINFO_SIGNAL_INDEX];
+  siliconRevision = inputBuffer[RESPONSE_GETINFO_SIGNAL_INDEX + 1];
 
-  if (!checkCount() || !checkCrc())
-    return false;
+  endSession();
 
-  // If we hear a "0x00", that means it had a successful lock
-  if (inputBuffer[RESPONSE_SIGNAL_INDEX] != ATRCC508A_SUCCESSFUL_LOCK)
-    return false;
+  // If we hear a "0x50" or "0x60", that means it had a successful version response.
+  if ((revision != ATRCC508A_SUCCESSFUL_GETINFO) && (revision != ATRCC608A_SUCCESSFUL_GETINFO))
+    return fail(ATECC_STATUS_UNKNOWN);
+
+  setVariant(revision, siliconRevision);
+
+  #if defined(ATECCX08A_DEVICE_VARIANT)
+  if ((ATECCX08A_DEVICE_VARIANT == ATECC_VARIANT_508A) != (revision == ATRCC508A_SUCCESSFUL_GETINFO))
+    return fail(ATECC_STATUS_NOT_SUPPORTED); // not the variant this build was pinned to
+  #endif
 
   return true;
 }
 
 /** \brief
 
-	updateRandom32Bytes(bool debug)
+	setVariant(uint8_t revision, uint8_t siliconRevision)
 
-    This function pulls a complete random number (all 32 bytes)
-    It stores it in a global array called random32Bytes[]
-    If you wish to access this global variable and use as a 256 bit random number,
-    then you will need to access this array and combine it's elements as you wish.
-    In order to keep compatibility with ATmega328 based arduinos,
-    We have offered some other functions that return variables more usable (i.e. byte, int, long)
-    They are getRandomByte(), getRandomInt(), and getRandomLong().
+	Records the device variant from the revision byte (0x50 or 0x60) and silicon revision
+	reported by the INFO command (or found in the config zone revision number).
 */
 
-bool ATECCX08A::updateRandom32Bytes(bool debug)
+void ATECCX08A::setVariant(uint8_t revision, uint8_t siliconRevision)
 {
-  if (!sendCommand(COMMAND_OPCODE_RANDOM, 0x00, 0x0000))
-    return false;
+  _siliconRevision = siliconRevision;
 
-  // param1 = 0. - Automatically update EEPROM seed only if necessary prior to random number generation. Recommended for highest security.
-  // param2 = 0x0000. - must be 0x0000.
+  if (revision == ATRCC508A_SUCCESSFUL_GETINFO)
+    _variant = ATECC_VARIANT_508A;
+  else if (revision == ATRCC608A_SUCCESSFUL_GETINFO)
+    _variant = (siliconRevision >= ATECC608B_MIN_SILICON_REVISION) ? ATECC_VARIANT_608B : ATECC_VARIANT_608A;
+}
 
-  delay(23); // time for IC to process command and exectute
+/** \brief
 
-  // Now let's read back from the IC. This will be 35 bytes of data (count + 32_data_bytes + crc[0] + crc[1])
+	deviceVariant()
 
-  if (!receiveResponseData(RESPONSE_COUNT_SIZE + RESPONSE_RANDOM_SIZE + CRC_SIZE, debug))
-    return false;
+	Returns the device variant detected by begin()/getInfo() (or the one pinned at compile time):
+	ATECC_VARIANT_508A, ATECC_VARIANT_608A, ATECC_VARIANT_608B or ATECC_VARIANT_UNKNOWN.
+*/
 
-  idleMode();
+uint8_t ATECCX08A::deviceVariant()
+{
+  #if defined(ATECCX08A_DEVICE_VARIANT)
+  return ATECCX08A_DEVICE_VARIANT;
+  #else
+  return _variant;
+  #endif
+}
 
-  if (!checkCount(debug) || !checkCrc(debug))
-    return false;
+/** \brief
 
-  // update random32Bytes[] array
-  // we don't need the count value (which is currently the first byte of the inputBuffer)
-  for (int i = 0 ; i < RESPONSE_RANDOM_SIZE ; i++) // for loop through to grab all but the first position (which is "count" of the message)
-  {
-    random32Bytes[i] = inputBuffer[RESPONSE_COUNT_SIZE + i];
-  }
+	siliconRevision()
 
-  if (debug)
-  {
-    _debugSerial->print("random32Bytes: ");
-    for (int i = 0; i < sizeof(random32Bytes) ; i++)
-    {
-      _debugSerial->print(random32Bytes[i], HEX);
-      _debugSerial->print(",");
-    }
-    _debugSerial->println();
-  }
+	Returns the silicon revision reported by the INFO command (0 if getInfo() has not succeeded yet).
+*/
 
-  return true;
+uint8_t ATECCX08A::siliconRevision()
+{
+  return _siliconRevision;
 }
 
 /** \brief
 
-	getRandomByte(bool debug)
+	hasFeature(uint8_t feature)
 
-    This function returns a random byte.
-	It calls updateRandom32Bytes(), then uses the first byte in that array for a return value.
+	Returns true if the device variant supports feature (e.g. ATECC_FEATURE_AES).
+	While the variant is unknown, this returns true and leaves it to the IC to reject the command.
 */
 
-byte ATECCX08A::getRandomByte(bool debug)
+bool ATECCX08A::hasFeature(uint8_t feature)
 {
-  updateRandom32Bytes(debug);
-  return random32Bytes[0];
+  switch (deviceVariant())
+  {
+    case ATECC_VARIANT_508A:
+      return false; // all optional features are ATECC608 additions
+    case ATECC_VARIANT_608A:
+    case ATECC_VARIANT_608B:
+      return ((ATECC_FEATURES_608 & feature) == feature);
+    default:
+      return true;
+  }
 }
 
 /** \brief
 
-	getRandomInt(bool debug)
+	executionTime(uint8_t command_opcode)
 
-    This function returns a random Int.
-	It calls updateRandom32Bytes(), then uses the first 2 bytes in that array for a return value.
-	It bitwize ORS the first two bytes of the array into the return value.
+	Returns the max execution time (ms) of a command on this device variant, from the commandDescriptors[] table.
+	While the variant is unknown, returns the longer of the two.
 */
 
-int ATECCX08A::getRandomInt(bool debug)
+uint8_t ATECCX08A::executionTime(uint8_t command_opcode)
 {
-  updateRandom32Bytes(debug);
-  int return_val;
-  return_val = random32Bytes[0]; // store first randome byte into return_val
-  return_val <<= 8; // shift it over, to make room for the next byte
-  return_val |= random32Bytes[1]; // "or in" the next byte in the array
-  return return_val;
+  CommandDescriptor descriptor;
+  uint8_t variant = deviceVariant();
+
+  if (!findCommandDescriptor(command_opcode, &descriptor))
+    return EXECUTION_TIME_DEFAULT;
+
+  if (variant == ATECC_VARIANT_508A)
+    return descriptor.time508A;
+  if ((variant == ATECC_VARIANT_608A) || (variant == ATECC_VARIANT_608B))
+    return descriptor.time608;
+  return (descriptor.time508A > descriptor.time608) ? descriptor.time508A : descriptor.time608;
 }
 
 /** \brief
 
-	getRandomLong(bool debug)
+	lockConfig()
 
-    This function returns a random Long.
-	It calls updateRandom32Bytes(), then uses the first 4 bytes in that array for a return value.
-	It bitwize ORS the first 4 bytes of the array into the return value.
+	This function sends the LOCK Command with the configuration zone parameter,
+	and listens for success response (0x00).
 */
 
-long ATECCX08A::getRandomLong(bool debug)
+bool ATECCX08A::lockConfig()
 {
-  updateRandom32Bytes(debug);
-  long return_val;
-  return_val = random32Bytes[0]; // store first randome byte into return_val
-  return_val <<= 8; // shift it over, to make room for the next byte
-  return_val |= random32Bytes[1]; // "or in" the next byte in the array
-  return_val <<= 8; // shift it over, to make room for the next byte
-  return_val |= random32Bytes[2]; // "or in" the next byte in the array
-  return_val <<= 8; // shift it over, to make room for the next byte
-  return_val |= random32Bytes[3]; // "or in" the next byte in the array
-  return return_val;
+  return lock(LOCK_MODE_ZONE_CONFIG);
 }
 
 /** \brief
 
-	random(long max)
+	lockConfigChecked()
 
-    This function returns a positive random Long between 0 and max
-	max can be up to the larges positive value of a long: 2147483647
+	Locks the configuration zone like lockConfig(), but with the summary check enabled:
+	the host calculates the CRC of configZone[] and the device only locks if its
+	configuration zone has the same CRC. So nothing gets locked unless the device holds
+	exactly what configZone[] says it holds (for example, after writeConfig()).
 */
 
-long ATECCX08A::random(long max)
+bool ATECCX08A::lockConfigChecked()
 {
-  return random(0, max);
+  uint16_t summary;
+
+  if (!_configZoneLoaded && !readConfigZone())
+    return false;
+
+  atca_calculate_crc(CONFIG_ZONE_SIZE, configZone);
+  summary = crc[0] | (crc[1] << 8);
+
+  // If we hear a "0x00", that means the summary matched and the config zone is locked
+  if (!executeCommand(COMMAND_OPCODE_LOCK, LOCK_MODE_ZONE_CONFIG_SUMMARY, summary))
+  {
+    ATECC_LOG_ERROR("Config Summary Mismatch");
+    return false;
+  }
+
+  configZone[CONFIG_ZONE_LOCK_STATUS] = 0x00;
+  configLockStatus = true;
+
+  return true;
 }
 
 /** \brief
 
-	random(long min, long max)
+	readConfigZone()
 
-    This function returns a random Long with set boundaries of min and max.
-	If you flip min and max, it still works!
-	Also, it can handle negative numbers. Wahoo!
+	This function reads the entire configuration zone EEPROM memory on the device.
+	It stores them for vewieing in a large array called configZone[128].
+	In addition to configuration settings, the configuration memory on the IC also
+	contains the serial number, revision number, lock statuses, and much more.
+	This function also updates global variables for these other things.
+	Returns false if any read fails, with configZone[] and those variables left as they were.
 */
 
-long ATECCX08A::random(long min, long max)
+bool ATECCX08A::readConfigZone(bool debug)
 {
-  long randomLong = getRandomLong();
-  long halfFSR = (max - min) / 2; // half of desired full scale range
-  long midPoint = (max + min) / 2; // where we "start" out output value, then add in a fraction of halfFSR
-  float fraction = float(randomLong) / 2147483647;
-  return (midPoint + (halfFSR * fraction) );
-}
-
-/** \brief
+  static const uint16_t blockAddresses[CONFIG_ZONE_SIZE / CONFIG_ZONE_READ_SIZE] = {
+    ADDRESS_CONFIG_READ_BLOCK_0, ADDRESS_CONFIG_READ_BLOCK_1, ADDRESS_CONFIG_READ_BLOCK_2, ADDRESS_CONFIG_READ_BLOCK_3
+  };
+  uint8_t config[CONFIG_ZONE_SIZE];
+  bool result = true;
 
-	receiveResponseData(uint8_t length, bool debug)
+  beginSession(); // all four reads in a single wake
 
-	This function receives messages from the ATECCX08a IC (up to 128 Bytes)
-	It will return true if it receives the correct amount of data and good CRCs.
-	What we hear back from the IC is always formatted with the following series of bytes:
-	COUNT, DATA, CRC[0], CRC[1]
-	Note, the count number includes itself, the num of data bytes, and the two CRC bytes in the total,
-	so a simple response message from the IC that indicates that it heard the wake
-	condition properly is like so:
-	EXAMPLE Wake success response: 0x04, 0x11, 0x33, 0x44
-	It needs length argument:
-	length: length of data to receive (includes count + DATA + 2 crc bytes)
-*/
-bool ATECCX08A::receiveResponseData(uint8_t length, bool debug)
-{
-
-  // pull in data 32 bytes at at time. (necessary to avoid overflow on atmega328)
-  // if length is less than or equal to 32, then just pull it in.
-  // if length is greater than 32, then we must first pull in 32, then pull in remainder.
-  // lets use length as our tracker and we will subtract from it as we pull in data.
-  countGlobal = 0; // reset for each new message (most important, like wensleydale at a cheese party)
-  cleanInputBuffer();
-  byte requestAttempts = 0; // keep track of how many times we've attempted to request, to break out if necessary
-
-  /* Normalize length according to buffer size */
-  if (length > sizeof(inputBuffer))
-    length = sizeof(inputBuffer);
-
-  while(length)
+  for (uint8_t block = 0; result && (block < (CONFIG_ZONE_SIZE / CONFIG_ZONE_READ_SIZE)); block++)
   {
-    byte requestAmount; // amount of bytes to request, needed to pull in data 32 bytes at a time
-    if (length > ATRCC508A_MAX_REQUEST_SIZE)
-    {
-      requestAmount = ATRCC508A_MAX_REQUEST_SIZE; // as we have more than 32 to pull in, keep pulling in 32 byte chunks
-    }
-    else
-    {
-      requestAmount = length; // now we're ready to pull in the last chunk.
-    }
-
-    _i2cPort->requestFrom(_i2caddr, requestAmount);    // request bytes from peripheral
+    // read the next 32 bytes of config zone into inputBuffer, and copy them out
+    result = read(ZONE_CONFIG, blockAddresses[block], CONFIG_ZONE_READ_SIZE);
+    if (result)
+      memcpy(&config[CONFIG_ZONE_READ_SIZE * block], &inputBuffer[1], CONFIG_ZONE_READ_SIZE);
+  }
 
-    requestAttempts++;
+  endSession();
 
-    while (_i2cPort->available())   // peripheral may send less than requested
-    {
-      uint8_t value = _i2cPort->read();
+  // a failed read leaves configZone[] (and what was parsed from it) as it was
+  if (!result)
+    return false;
 
-      /* Make sure not to read beyond buffer size */
-      if (countGlobal < sizeof(inputBuffer))
-        inputBuffer[countGlobal] = value;    // receive a byte as character
+  // copy into configZone[] (for later viewing/comparing)
+  memcpy(configZone, config, CONFIG_ZONE_SIZE);
 
-      length--; // keep this while loop active until we've pulled in everything
-      countGlobal++; // keep track of the count of the entire message.
-    }
+  parseConfigZone();
 
-    if (requestAttempts == ATRCC508A_MAX_RETRIES)
-      break; // this probably means that the device is not responding.
-  }
+  _configZoneLoaded = true;
 
   if (debug)
   {
-    _debugSerial->print("inputBuffer: ");
-    for (int i = 0; i < countGlobal ; i++)
+    _debugSerial->println("configZone: ");
+    for (int i = 0; i < sizeof(configZone) ; i++)
     {
-      _debugSerial->print(inputBuffer[i], HEX);
-      _debugSerial->print(",");
+      _debugSerial->print(i);
+	  _debugSerial->print(": 0x");
+	  if ((configZone[i] >> 4) == 0) _debugSerial->print("0"); // print preceeding high nibble if it's zero
+	  _debugSerial->print(configZone[i], HEX);
+	  _debugSerial->print(" \t0b");
+	  for(int bit = 7; bit >= 0; bit--) _debugSerial->print(bitRead(configZone[i],bit)); // print binary WITH preceding '0' bits
+	  _debugSerial->println();
     }
     _debugSerial->println();
   }
@@ -525,204 +698,272 @@ bool ATECCX08A::receiveResponseData(uint8_t length, bool debug)
 
 /** \brief
 
-	checkCount(bool debug)
+	parseConfigZone()
 
-	This function checks that the count byte received in the most recent message equals countGlobal
-	Call receiveResponseData, and then imeeditately call this to check the count of the complete message.
-	Returns true if inputBuffer[0] == countGlobal.
+	Updates the serial number, revision number, lock statuses, SlotConfig[] and KeyConfig[]
+	from the bytes in configZone[].
 */
 
-bool ATECCX08A::checkCount(bool debug)
+void ATECCX08A::parseConfigZone()
 {
-  if (debug)
-  {
-    _debugSerial->print("countGlobal: 0x");
-	_debugSerial->println(countGlobal, HEX);
-	_debugSerial->print("count heard from IC (inpuBuffer[0]): 0x");
-    _debugSerial->println(inputBuffer[0], HEX);
-  }
+  // pull out serial number from configZone, and copy to public variable within this instance
+  memcpy(&serialNumber[0], &configZone[CONFIG_ZONE_SERIAL_PART0], 4); 	// copy SN<0:3>
+  memcpy(&serialNumber[4], &configZone[CONFIG_ZONE_SERIAL_PART1], 5); 	// copy SN<4:8>
 
-  // Check count; the first byte sent from IC is count, and it should be equal to the actual message count
-  if (inputBuffer[RESPONSE_COUNT_INDEX] != countGlobal)
-  {
-	if (debug) _debugSerial->println("Message Count Error");
-	  return false;
-  }
+  // pull out revision number from configZone, and copy to public variable within this instance
+  memcpy(&revisionNumber[0], &configZone[CONFIG_ZONE_REVISION_NUMBER], 4); 	// copy RevNum<0:3>
 
-  return true;
+  // RevNum matches the INFO response, so use it if begin() could not detect the variant
+  if (_variant == ATECC_VARIANT_UNKNOWN)
+    setVariant(revisionNumber[2], revisionNumber[3]);
+
+  // set lock statuses for config, data/otp, and slot 0
+  if (configZone[CONFIG_ZONE_LOCK_STATUS] == 0x00) configLockStatus = true;
+  else configLockStatus = false;
+
+  if (configZone[CONFIG_ZONE_OTP_LOCK] == 0x00) dataOTPLockStatus = true;
+  else dataOTPLockStatus = false;
+
+  if ( (configZone[CONFIG_ZONE_SLOTS_LOCK0] & (1 << 0) ) == true) slot0LockStatus = false; // LSB is slot 0. if bit set = UN-locked.
+  else slot0LockStatus = true;
+
+  memcpy(SlotConfig, &configZone[CONFIG_ZONE_SLOT_CONFIG], sizeof(uint16_t) * DATA_ZONE_SLOTS);
+  memcpy(KeyConfig, &configZone[CONFIG_ZONE_KEY_CONFIG], sizeof(uint16_t) * DATA_ZONE_SLOTS);
+
+  for (uint8_t slot = 0; slot < DATA_ZONE_SLOTS; slot++)
+    slotPermissions[slot] = decodeSlotPermissions(slot, SlotConfig[slot], KeyConfig[slot]);
 }
 
 /** \brief
 
-	checkCrc(bool debug)
+	decodeSlotPermissions(uint16_t slot, uint16_t slotConfig, uint16_t keyConfig)
 
-	This function checks that the CRC bytes received in the most recent message equals a calculated CRCs
-	Call receiveResponseData, then call immediately call this to check the CRCs of the complete message.
+	Turns one slot's SlotConfig and KeyConfig into SLOT_ALLOW_* bits. datasheet pg 20-23
+	For ECC private keys, the ReadKey bits enable signing and ECDH instead of reads,
+	and WriteConfig bit 1 lets GenKey replace the key once the data zone is locked.
 */
 
-bool ATECCX08A::checkCrc(bool debug)
+uint16_t ATECCX08A::decodeSlotPermissions(uint16_t slot, uint16_t slotConfig, uint16_t keyConfig)
 {
-  // Check CRC[0] and CRC[1] are good to go.
-  atca_calculate_crc(countGlobal - CRC_SIZE, inputBuffer);   // first calculate it
+  uint16_t permissions = 0;
+  uint16_t keyType = KEY_CONFIG_KEY_TYPE(keyConfig);
+  uint16_t readKey = READ_KEY(slotConfig);
+  uint16_t writeConfig = WRITE_CONFIG(slotConfig) >> 12;
+  bool eccPrivate = (keyType == KEY_TYPE_ECC) && (keyConfig & KEY_CONFIG_SET(1, KEY_CONFIG_OFFSET_PRIVATE));
 
-  if (debug)
+  if (eccPrivate)
   {
-    _debugSerial->print("CRC[0] Calc: 0x");
-	_debugSerial->println(crc[0], HEX);
-	_debugSerial->print("CRC[1] Calc: 0x");
-    _debugSerial->println(crc[1], HEX);
+    permissions |= SLOT_ECC_PRIVATE;
+    if (readKey & 0b0001) permissions |= SLOT_ALLOW_SIGN;
+    if (readKey & 0b0010) permissions |= SLOT_ALLOW_SIGN_INTERNAL;
+    if ((readKey & ECDH_READKEY_PERMITTED) && !(readKey & ECDH_READKEY_WRITE_SLOT)) permissions |= SLOT_ALLOW_ECDH;
+    if ((readKey & ECDH_READKEY_PERMITTED) && (readKey & ECDH_READKEY_WRITE_SLOT) && !(slot & 0x01)) permissions |= SLOT_ALLOW_ECDH_SLOT;
+    if (writeConfig & 0b0010) permissions |= SLOT_ALLOW_GENKEY;
+    if (keyConfig & KEY_CONFIG_SET(1, KEY_CONFIG_OFFSET_PUB_INFO)) permissions |= SLOT_ALLOW_PUBLIC_KEY;
   }
-
-  if ( (inputBuffer[countGlobal - (CRC_SIZE - 1)] != crc[1]) || (inputBuffer[countGlobal - CRC_SIZE] != crc[0]) )   // then check the CRCs.
+  else
   {
-	if (debug) _debugSerial->println("Message CRC Error");
-	  return false;
+    if (!IS_SECRET(slotConfig)) permissions |= SLOT_ALLOW_READ;
+    if (writeConfig == 0) permissions |= SLOT_ALLOW_WRITE; // Always
+    if ((keyType != KEY_TYPE_ECC) && !NO_MAC(slotConfig)) permissions |= SLOT_ALLOW_MAC;
+    if (keyType == KEY_TYPE_AES) permissions |= SLOT_ALLOW_AES;
+    if (keyType == KEY_TYPE_ECC) permissions |= SLOT_ECC_PUBLIC;
   }
 
-  return true;
+  if (IS_SECRET(slotConfig)) permissions |= SLOT_SECRET;
+  if (LIMITED_USE(slotConfig)) permissions |= SLOT_LIMITED_USE;
+  if (keyConfig & KEY_CONFIG_SET(1, KEY_CONFIG_OFFSET_LOCKABLE)) permissions |= SLOT_LOCKABLE;
+
+  return permissions;
 }
 
 /** \brief
 
-	atca_calculate_crc(uint8_t length, uint8_t *data)
+	slotAllows(uint16_t slot, uint16_t permissions)
 
-    This function calculates CRC.
-    It was copied directly from the App Note provided from Microchip.
-    Note, it seems to be their own unique type of CRC cacluation.
-    View the entire app note here:
-    http://ww1.microchip.com/downloads/en/AppNotes/Atmel-8936-CryptoAuth-Data-Zone-CRC-Calculation-ApplicationNote.pdf
-    \param[in] length number of bytes in buffer
-    \param[in] data pointer to data for which CRC should be calculated
+	Returns true if slot has all of the SLOT_ALLOW_* bits in permissions.
+	Reads the config zone first if it has not been read yet, after that it is a table lookup.
+	Otherwise fails with ATECC_STATUS_NOT_PERMITTED (or ATECC_STATUS_BAD_PARAM for a bad slot).
 */
 
-void ATECCX08A::atca_calculate_crc(uint8_t length, uint8_t *data)
+bool ATECCX08A::slotAllows(uint16_t slot, uint16_t permissions)
 {
-  uint8_t counter;
-  uint16_t crc_register = 0;
-  uint16_t polynom = 0x8005;
-  uint8_t shift_register;
-  uint8_t data_bit, crc_bit;
-  for (counter = 0; counter < length; counter++) {
-    for (shift_register = 0x01; shift_register > 0x00; shift_register <<= 1) {
-      data_bit = (data[counter] & shift_register) ? 1 : 0;
-      crc_bit = crc_register >> 15;
-      crc_register <<= 1;
-      if (data_bit != crc_bit)
-        crc_register ^= polynom;
-    }
-  }
-  crc[0] = (uint8_t) (crc_register & 0x00FF);
-  crc[1] = (uint8_t) (crc_register >> 8);
-}
+  if (slot >= DATA_ZONE_SLOTS)
+    return fail(ATECC_STATUS_BAD_PARAM);
 
+  if (!_configZoneLoaded && !readConfigZone(false))
+    return false;
+
+  if ((slotPermissions[slot] & permissions) != permissions)
+    return fail(ATECC_STATUS_NOT_PERMITTED);
+
+  return true;
+}
 
 /** \brief
 
-	cleanInputBuffer()
+	printSlotPermissions()
 
-    This function sets the entire inputBuffer to 0xFFs.
-	It is helpful for debugging message/count/CRCs errors.
+	Prints what each slot allows, one line per slot, on the debug port.
+	Call it at boot (after readConfigZone()) to catch a misconfigured device early.
 */
 
-void ATECCX08A::cleanInputBuffer()
+void ATECCX08A::printSlotPermissions()
 {
-  for (int i = 0; i < sizeof(inputBuffer) ; i++)
+  static const struct {
+    uint16_t bit;
+    const char *name;
+  } names[] = {
+    { SLOT_ECC_PRIVATE, "ecc-private" },
+    { SLOT_ECC_PUBLIC, "ecc-public" },
+    { SLOT_ALLOW_READ, "read" },
+    { SLOT_ALLOW_WRITE, "write" },
+    { SLOT_ALLOW_SIGN, "sign" },
+    { SLOT_ALLOW_SIGN_INTERNAL, "sign-internal" },
+    { SLOT_ALLOW_GENKEY, "genkey" },
+    { SLOT_ALLOW_PUBLIC_KEY, "public-key" },
+    { SLOT_ALLOW_ECDH, "ecdh" },
+    { SLOT_ALLOW_ECDH_SLOT, "ecdh-to-slot" },
+    { SLOT_ALLOW_MAC, "mac" },
+    { SLOT_ALLOW_AES, "aes" },
+    { SLOT_SECRET, "secret" },
+    { SLOT_LIMITED_USE, "limited-use" },
+    { SLOT_LOCKABLE, "lockable" },
+  };
+
+  if (!_configZoneLoaded && !readConfigZone(false))
+    return;
+
+  for (uint8_t slot = 0; slot < DATA_ZONE_SLOTS; slot++)
   {
-    inputBuffer[i] = 0xFF;
+    _debugSerial->print("Slot ");
+    _debugSerial->print(slot);
+    _debugSerial->print(":\t");
+    for (uint8_t i = 0; i < sizeof(names) / sizeof(names[0]); i++)
+    {
+      if (slotPermissions[slot] & names[i].bit)
+      {
+        _debugSerial->print(names[i].name);
+        _debugSerial->print(" ");
+      }
+    }
+    _debugSerial->println();
   }
 }
 
 /** \brief
 
-	createNewKeyPair(uint16_t slot)
+	writeConfig(const uint8_t *config)
 
-    This function sends the command to create a new key pair (private AND public)
-	in the slot designated by argument slot (default slot 0).
-	Sparkfun Default Configuration Sketch calls this, and then locks the data/otp zones and slot 0.
+	Brings the configuration zone to a complete 128-byte target image.
+	Only the words that differ from configZone[] are written (bytes that Write cannot change, such as
+	the serial number, UserExtra and the lock bytes, are ignored in the target).
+	Where a block is fully writable (blocks 1 and 3) and more than one word in it changed,
+	the block is written with one 32-byte write instead of several 4-byte writes.
+	configZone[] is updated as the writes succeed, so it can be used for lockConfigChecked() afterwards.
+
+	Returns true if the device now holds the target image. Returns false if the config zone
+	is already locked and differs, or if any write fails.
 */
 
-bool ATECCX08A::createNewKeyPair(uint16_t slot)
+bool ATECCX08A::writeConfig(const uint8_t *config)
 {
-  if (!sendCommand(COMMAND_OPCODE_GENKEY, GENKEY_MODE_NEW_PRIVATE, slot))
+  bool result = true;
+  uint8_t changed[CONFIG_ZONE_SIZE / CONFIG_ZONE_READ_SIZE]; // one bit per changed word, per block
+  uint8_t changes = 0;
+
+  if (!_configZoneLoaded && !readConfigZone())
     return false;
 
-  delay(115); // time for IC to process command and exectute
+  for (uint8_t block = 0; block < sizeof(changed); block++)
+  {
+    changed[block] = 0;
+    for (uint8_t word = 0; word < CONFIG_ZONE_BLOCK_WORDS; word++)
+    {
+      uint8_t offset = (block * CONFIG_ZONE_BLOCK_WORDS + word) * 4;
+      if (configWordWritable(offset / 4) && (memcmp(&configZone[offset], &config[offset], 4) != 0))
+      {
+        changed[block] |= (1 << word);
+        changes++;
+      }
+    }
+  }
+
+  if (changes == 0)
+    return true; // nothing to do
+  if (configLockStatus)
+    return fail(ATECC_STATUS_EXECUTION_ERROR); // differs, but can no longer be written
 
-  // Now let's read back from the IC.
+  beginSession(); // all writes in as few wakes as possible
 
-  if (!receiveResponseData(RESPONSE_COUNT_SIZE + PUBLIC_KEY_SIZE + CRC_SIZE)) // public key (64), plus crc (2), plus count (1)
-    return false;
+  for (uint8_t block = 0; (block < sizeof(changed)) && result; block++)
+  {
+    uint8_t buffer[CONFIG_ZONE_READ_SIZE];
+    uint8_t blockOffset = block * CONFIG_ZONE_READ_SIZE;
 
-  idleMode();
+    if (changed[block] == 0)
+      continue;
 
-  // update publicKey64Bytes[] array
-  if (!checkCount() || !checkCrc()) // check that it was a good message
-    return false;
+    // write() takes a non-const buffer
+    memcpy(buffer, &config[blockOffset], CONFIG_ZONE_READ_SIZE);
 
-  // we don't need the count value (which is currently the first byte of the inputBuffer)
-  for (int i = 0 ; i < PUBLIC_KEY_SIZE ; i++) // for loop through to grab all but the first position (which is "count" of the message)
-  {
-    publicKey64Bytes[i] = inputBuffer[i + RESPONSE_COUNT_SIZE];
+    if (configBlockWritable(block) && (changed[block] & (changed[block] - 1))) // two or more words
+    {
+      result = write(ZONE_CONFIG, block * CONFIG_ZONE_BLOCK_WORDS, buffer, CONFIG_ZONE_READ_SIZE);
+      if (result)
+        memcpy(&configZone[blockOffset], buffer, CONFIG_ZONE_READ_SIZE);
+    }
+    else
+    {
+      for (uint8_t word = 0; (word < CONFIG_ZONE_BLOCK_WORDS) && result; word++)
+      {
+        if (!(changed[block] & (1 << word)))
+          continue;
+
+        result = write(ZONE_CONFIG, block * CONFIG_ZONE_BLOCK_WORDS + word, &buffer[word * 4], 4);
+        if (result)
+          memcpy(&configZone[blockOffset + word * 4], &buffer[word * 4], 4);
+      }
+    }
   }
 
-  return true;
-}
+  endSession();
 
-/** \brief
+  parseConfigZone();
 
-	generatePublicKey(uint16_t slot, bool debug)
+  if (!result)
+    ATECC_LOG_ERROR("Config Write Failure");
 
-    This function uses the GENKEY command in "Public Key Computation" mode.
+  return result;
+}
 
-    Generates an ECC public key based upon the private key stored in the slot defined by the KeyID
-	parameter (aka slot). Defaults to slot 0.
+/** \brief
 
-	Note, if you haven't created a private key in the slot already, then this will fail.
+	configWordWritable(uint8_t word)
 
-	The generated public key is read back from the device, and then copied from inputBuffer to
-	a global variable named publicKey64Bytes for later use.
+	Returns true if the 4-byte word (index 0-31) of the configuration zone can be changed with the Write command.
+	Words 0-3 (serial number, revision number) are read only, and word 21 holds UserExtra, Selector
+	and the two lock bytes, which are changed by UpdateExtra and Lock only.
 */
 
-bool ATECCX08A::generatePublicKey(uint16_t slot, bool debug)
+bool ATECCX08A::configWordWritable(uint8_t word)
 {
-  if (!sendCommand(COMMAND_OPCODE_GENKEY, GENKEY_MODE_PUBLIC, slot))
-    return false;
-
-  delay(115); // time for IC to process command and exectute
-
-  // Now let's read back from the IC.
-  // public key (64), plus crc (2), plus count (1)
-  if (!receiveResponseData(RESPONSE_COUNT_SIZE + PUBLIC_KEY_SIZE + CRC_SIZE))
-    return false;
+  return (word >= (CONFIG_ZONE_WRITABLE_START / 4)) && (word != (CONFIG_ZONE_USER_EXTRA / 4)) && (word < (CONFIG_ZONE_SIZE / 4));
+}
 
-  idleMode();
+/** \brief
 
-  // update publicKey64Bytes[] array
-  if (!checkCount() || !checkCrc()) // check that it was a good message
-    return false;
+	configBlockWritable(uint8_t block)
 
-  // we don't need the count value (which is currently the first byte of the inputBuffer)
-  for (int i = 0 ; i < PUBLIC_KEY_SIZE ; i++) // for loop through to grab all but the first position (which is "count" of the message)
-  {
-    publicKey64Bytes[i] = inputBuffer[RESPONSE_COUNT_SIZE + i];
-  }
+	Returns true if every word of the 32-byte block is writable, so a 32-byte write can be used.
+*/
 
-  if (debug)
+bool ATECCX08A::configBlockWritable(uint8_t block)
+{
+  for (uint8_t word = 0; word < CONFIG_ZONE_BLOCK_WORDS; word++)
   {
-    _debugSerial->println("This device's Public Key:");
-    _debugSerial->println();
-    _debugSerial->println("uint8_t publicKey[64] = {");
-    for (int i = 0; i < sizeof(publicKey64Bytes) ; i++)
-    {
-      _debugSerial->print("0x");
-      if ((publicKey64Bytes[i] >> 4) == 0) _debugSerial->print("0"); // print preceeding high nibble if it's zero
-      _debugSerial->print(publicKey64Bytes[i], HEX);
-      if (i != 63) _debugSerial->print(", ");
-      if ((63-i) % 16 == 0) _debugSerial->println();
-    }
-
-    _debugSerial->println("};");
-    _debugSerial->println();
+    if (!configWordWritable(block * CONFIG_ZONE_BLOCK_WORDS + word))
+      return false;
   }
 
   return true;
@@ -730,421 +971,3193 @@ bool ATECCX08A::generatePublicKey(uint16_t slot, bool debug)
 
 /** \brief
 
-	read(uint8_t zone, uint16_t address, uint8_t length, bool debug)
-
-    Reads data from the IC at a specific zone and address.
-	Your data response will be available at inputBuffer[].
+	provisionConfig(const uint8_t *config)
 
-	For more info on address encoding, see datasheet pg 58.
+	Writes a complete configuration image (see writeConfig()) and then locks the
+	configuration zone with lockConfigChecked(), so the lock only happens if the device holds exactly that image.
+	Note, this PERMINANTLY disables changes to config zone.
 */
 
-bool ATECCX08A::read(uint8_t zone, uint16_t address, uint8_t length, bool debug)
+bool ATECCX08A::provisionConfig(const uint8_t *config)
 {
-	return read_output(zone, address, length, NULL, debug);
-}
+  bool result;
 
-bool ATECCX08A::read_output(uint8_t zone, uint16_t address, uint8_t length, uint8_t * output, bool debug)
-{
-  // adjust zone as needed for whether it's 4 or 32 bytes length read
-  // bit 7 of zone needs to be set correctly
-  // (0 = 4 Bytes are read)
-  // (1 = 32 Bytes are read)
-  if (length == 32)
-  {
-	zone |= 0b10000000; // set bit 7
-  }
-  else if (length == 4)
-  {
-	zone &= ~0b10000000; // clear bit 7
-  }
-  else
-  {
-	return false; // invalid length, abort.
-  }
+  beginSession();
 
-  if (!sendCommand(COMMAND_OPCODE_READ, zone, address))
-    return false;
+  result = writeConfig(config) && lockConfigChecked();
 
-  delay(1); // time for IC to process command and exectute
+  endSession();
 
-  // Now let's read back from the IC. ( + CRC_SIZE + count)
-  if (!receiveResponseData(RESPONSE_COUNT_SIZE + length + CRC_SIZE, debug))
-    return false;
+  return result;
+}
 
-  idleMode();
+/** \brief
 
-  if (!checkCount(debug) || !checkCrc(debug))
-    return false;
+	lockDataAndOTP()
 
-  /* Copy data to output */
-  if (output)
-  {
-	  memcpy(output, inputBuffer + RESPONSE_READ_INDEX, length);
-  }
+	This function sends the LOCK Command with the Data and OTP (one-time-programming) zone parameter,
+	and listens for success response (0x00).
+*/
 
-  return true;
+bool ATECCX08A::lockDataAndOTP()
+{
+  return lock(LOCK_MODE_ZONE_DATA_AND_OTP);
+}
+
+/** \brief
+
+	lockDataSlot0()
+
+	This function sends the LOCK Command with the Slot 0 zone parameter,
+	and listens for success response (0x00).
+*/
+
+bool ATECCX08A::lockDataSlot0()
+{
+  return lock(LOCK_MODE_SLOT0);
+}
+
+/** \brief
+
+	lock(byte zone)
+
+	This function sends the LOCK Command using the argument zone as parameter 1,
+	and listens for success response (0x00).
+*/
+
+bool ATECCX08A::lock(uint8_t zone)
+{
+  bool result;
+
+  // If we hear a "0x00", that means it had a successful lock
+  switch (zone)
+  {
+    case LOCK_MODE_ZONE_CONFIG:
+      result = executeConstantCommand(FRAME_LOCK_CONFIG);
+      break;
+    case LOCK_MODE_ZONE_DATA_AND_OTP:
+      result = executeConstantCommand(FRAME_LOCK_DATA_AND_OTP);
+      break;
+    case LOCK_MODE_SLOT0:
+      result = executeConstantCommand(FRAME_LOCK_SLOT0);
+      break;
+    default:
+      result = executeCommand(COMMAND_OPCODE_LOCK, zone, 0x0000);
+      break;
+  }
+
+  // keep the cached lock state in step, the slot permission checks depend on it
+  if (result && (zone == LOCK_MODE_ZONE_CONFIG))
+  {
+    configZone[CONFIG_ZONE_LOCK_STATUS] = 0x00;
+    configLockStatus = true;
+  }
+  else if (result && (zone == LOCK_MODE_ZONE_DATA_AND_OTP))
+  {
+    configZone[CONFIG_ZONE_OTP_LOCK] = 0x00;
+    dataOTPLockStatus = true;
+  }
+  else if (result && (zone == LOCK_MODE_SLOT0))
+  {
+    configZone[CONFIG_ZONE_SLOTS_LOCK0] &= ~(1 << 0);
+    slot0LockStatus = true;
+  }
+
+  return result;
+}
+
+/** \brief
+
+	randomReady()
+
+	Until the config zone is locked, the RANDOM command only returns a fixed test pattern
+	(FF FF 00 00 ...), the same on every device. Returns true once the config zone is locked,
+	false (ATECC_STATUS_CONFIG_UNLOCKED) before that. Check it before using random numbers
+	as key material or seeds. Reads the config zone first if it was not read yet.
+*/
+
+bool ATECCX08A::randomReady()
+{
+  if (!_configZoneLoaded && !readConfigZone())
+    return false;
+
+  if (!configLockStatus)
+    return fail(ATECC_STATUS_CONFIG_UNLOCKED);
+
+  return true;
+}
+
+/** \brief
+
+	updateRandom32Bytes(bool debug)
+
+    This function pulls a complete random number (all 32 bytes)
+    It stores it in a global array called random32Bytes[]
+    If you wish to access this global variable and use as a 256 bit random number,
+    then you will need to access this array and combine it's elements as you wish.
+    In order to keep compatibility with ATmega328 based arduinos,
+    We have offered some other functions that return variables more usable (i.e. byte, int, long)
+    They are getRandomByte(), getRandomInt(), and getRandomLong().
+*/
+
+bool ATECCX08A::updateRandom32Bytes(bool debug, uint8_t *randomOut)
+{
+  beginSession();
+
+  // param1 = 0. - Automatically update EEPROM seed only if necessary prior to random number generation. Recommended for highest security.
+  // param2 = 0x0000. - must be 0x0000.
+  // This will be 35 bytes of data (count + 32_data_bytes + crc[0] + crc[1])
+  if (!executeConstantCommand(FRAME_RANDOM, RESPONSE_RANDOM_SIZE, debug))
+  {
+    endSession();
+    return false;
+  }
+
+  // update random32Bytes[] array
+  // we don't need the count value (which is currently the first byte of the inputBuffer)
+  memcpy(random32Bytes, &inputBuffer[RESPONSE_COUNT_SIZE], RESPONSE_RANDOM_SIZE);
+
+  if (randomOut)
+    memcpy(randomOut, &inputBuffer[RESPONSE_COUNT_SIZE], RESPONSE_RANDOM_SIZE);
+
+  endSession();
+
+  if (debug)
+    printHexDump("random32Bytes", random32Bytes, sizeof(random32Bytes));
+
+  return true;
+}
+
+/** \brief
+
+	getRandomByte(bool debug)
+
+    This function returns a random byte.
+	It calls updateRandom32Bytes(), then uses the first byte in that array for a return value.
+*/
+
+byte ATECCX08A::getRandomByte(bool debug)
+{
+  uint8_t randomBytes[RESPONSE_RANDOM_SIZE] = {0};
+  updateRandom32Bytes(debug, randomBytes);
+  return randomBytes[0];
+}
+
+/** \brief
+
+	getRandomInt(bool debug)
+
+    This function returns a random Int.
+	It calls updateRandom32Bytes(), then uses the first 2 bytes in that array for a return value.
+	It bitwize ORS the first two bytes of the array into the return value.
+*/
+
+int ATECCX08A::getRandomInt(bool debug)
+{
+  uint8_t randomBytes[RESPONSE_RANDOM_SIZE] = {0};
+  updateRandom32Bytes(debug, randomBytes);
+  int return_val;
+  return_val = randomBytes[0]; // store first randome byte into return_val
+  return_val <<= 8; // shift it over, to make room for the next byte
+  return_val |= randomBytes[1]; // "or in" the next byte in the array
+  return return_val;
+}
+
+/** \brief
+
+	getRandomLong(bool debug)
+
+    This function returns a random Long.
+	It calls updateRandom32Bytes(), then uses the first 4 bytes in that array for a return value.
+	It bitwize ORS the first 4 bytes of the array into the return value.
+*/
+
+long ATECCX08A::getRandomLong(bool debug)
+{
+  uint8_t randomBytes[RESPONSE_RANDOM_SIZE] = {0};
+  updateRandom32Bytes(debug, randomBytes);
+  long return_val;
+  return_val = randomBytes[0]; // store first randome byte into return_val
+  return_val <<= 8; // shift it over, to make room for the next byte
+  return_val |= randomBytes[1]; // "or in" the next byte in the array
+  return_val <<= 8; // shift it over, to make room for the next byte
+  return_val |= randomBytes[2]; // "or in" the next byte in the array
+  return_val <<= 8; // shift it over, to make room for the next byte
+  return_val |= randomBytes[3]; // "or in" the next byte in the array
+  return return_val;
+}
+
+/** \brief
+
+	random(long max)
+
+    This function returns a positive random Long between 0 and max
+	max can be up to the larges positive value of a long: 2147483647
+*/
+
+long ATECCX08A::random(long max)
+{
+  return random(0, max);
+}
+
+/** \brief
+
+	random(long min, long max)
+
+    This function returns a random Long with set boundaries of min and max.
+	If you flip min and max, it still works!
+	Also, it can handle negative numbers. Wahoo!
+*/
+
+long ATECCX08A::random(long min, long max)
+{
+  long randomLong = getRandomLong();
+  long halfFSR = (max - min) / 2; // half of desired full scale range
+  long midPoint = (max + min) / 2; // where we "start" out output value, then add in a fraction of halfFSR
+  float fraction = float(randomLong) / 2147483647;
+  return (midPoint + (halfFSR * fraction) );
+}
+
+/** \brief
+
+	receiveResponseData(uint8_t length, bool debug)
+
+	This function receives messages from the ATECCX08a IC (up to 128 Bytes)
+	It will return true if it receives the correct amount of data and good CRCs.
+	What we hear back from the IC is always formatted with the following series of bytes:
+	COUNT, DATA, CRC[0], CRC[1]
+	Note, the count number includes itself, the num of data bytes, and the two CRC bytes in the total,
+	so a simple response message from the IC that indicates that it heard the wake
+	condition properly is like so:
+	EXAMPLE Wake success response: 0x04, 0x11, 0x33, 0x44
+	It needs length argument:
+	length: length of data to receive (includes count + DATA + 2 crc bytes)
+*/
+bool ATECCX08A::receiveResponseData(uint8_t length, bool debug)
+{
+
+  // pull in data 32 bytes at at time. (necessary to avoid overflow on atmega328)
+  // if length is less than or equal to 32, then just pull it in.
+  // if length is greater than 32, then we must first pull in 32, then pull in remainder.
+  // lets use length as our tracker and we will subtract from it as we pull in data.
+  countGlobal = 0; // reset for each new message (most important, like wensleydale at a cheese party)
+  cleanInputBuffer();
+  byte requestAttempts = 0; // keep track of how many times we've attempted to request, to break out if necessary
+
+  /* Normalize length according to buffer size */
+  if (length > sizeof(inputBuffer))
+    length = sizeof(inputBuffer);
+
+  while(length)
+  {
+    byte requestAmount; // amount of bytes to request, needed to pull in data 32 bytes at a time
+    if (length > ATRCC508A_MAX_REQUEST_SIZE)
+    {
+      requestAmount = ATRCC508A_MAX_REQUEST_SIZE; // as we have more than 32 to pull in, keep pulling in 32 byte chunks
+    }
+    else
+    {
+      requestAmount = length; // now we're ready to pull in the last chunk.
+    }
+
+    // peripheral may send less than requested. countGlobal + length never exceeds sizeof(inputBuffer)
+    uint8_t received = busRead(&inputBuffer[countGlobal], requestAmount);
+
+    requestAttempts++;
+
+    length -= received; // keep this while loop active until we've pulled in everything
+    countGlobal += received; // keep track of the count of the entire message.
+
+    if (requestAttempts == ATRCC508A_MAX_RETRIES)
+      break; // this probably means that the device is not responding.
+  }
+
+  if (debug)
+    printHexDump("inputBuffer", inputBuffer, countGlobal);
+  else
+    ATECC_LOG_HEX_DEBUG("inputBuffer", inputBuffer, countGlobal);
+
+  if (countGlobal == 0)
+    return fail(ATECC_STATUS_RX_TIMEOUT); // nothing heard at all
+
+  return true;
+}
+
+/** \brief
+
+	checkCount(bool debug)
+
+	This function checks that the count byte received in the most recent message equals countGlobal
+	Call receiveResponseData, and then imeeditately call this to check the count of the complete message.
+	Returns true if inputBuffer[0] == countGlobal.
+*/
+
+bool ATECCX08A::checkCount(bool debug)
+{
+  if (debug)
+  {
+    _debugSerial->print("countGlobal: 0x");
+	_debugSerial->println(countGlobal, HEX);
+	_debugSerial->print("count heard from IC (inpuBuffer[0]): 0x");
+    _debugSerial->println(inputBuffer[0], HEX);
+  }
+
+  // Check count; the first byte sent from IC is count, and it should be equal to the actual message count
+  if (inputBuffer[RESPONSE_COUNT_INDEX] != countGlobal)
+  {
+	if (debug) _debugSerial->println("Message Count Error");
+	else ATECC_LOG_ERROR("Message Count Error");
+	  return false;
+  }
+
+  return true;
+}
+
+/** \brief
+
+	checkCrc(bool debug)
+
+	This function checks that the CRC bytes received in the most recent message equals a calculated CRCs
+	Call receiveResponseData, then call immediately call this to check the CRCs of the complete message.
+*/
+
+bool ATECCX08A::checkCrc(bool debug)
+{
+  // Check CRC[0] and CRC[1] are good to go.
+  atca_calculate_crc(countGlobal - CRC_SIZE, inputBuffer);   // first calculate it
+
+  if (debug)
+  {
+    _debugSerial->print("CRC[0] Calc: 0x");
+	_debugSerial->println(crc[0], HEX);
+	_debugSerial->print("CRC[1] Calc: 0x");
+    _debugSerial->println(crc[1], HEX);
+  }
+
+  if ( (inputBuffer[countGlobal - (CRC_SIZE - 1)] != crc[1]) || (inputBuffer[countGlobal - CRC_SIZE] != crc[0]) )   // then check the CRCs.
+  {
+	if (debug) _debugSerial->println("Message CRC Error");
+	else ATECC_LOG_ERROR("Message CRC Error");
+	  return false;
+  }
+
+  return true;
+}
+
+/** \brief
+
+	atca_calculate_crc(uint8_t length, uint8_t *data)
+
+    This function calculates CRC.
+    It was copied directly from the App Note provided from Microchip.
+    Note, it seems to be their own unique type of CRC cacluation.
+    View the entire app note here:
+    http://ww1.microchip.com/downloads/en/AppNotes/Atmel-8936-CryptoAuth-Data-Zone-CRC-Calculation-ApplicationNote.pdf
+    \param[in] length number of bytes in buffer
+    \param[in] data pointer to data for which CRC should be calculated
+*/
+
+void ATECCX08A::atca_calculate_crc(uint8_t length, uint8_t *data)
+{
+  uint8_t counter;
+  uint16_t crc_register = 0;
+  uint16_t polynom = 0x8005;
+  uint8_t shift_register;
+  uint8_t data_bit, crc_bit;
+  for (counter = 0; counter < length; counter++) {
+    for (shift_register = 0x01; shift_register > 0x00; shift_register <<= 1) {
+      data_bit = (data[counter] & shift_register) ? 1 : 0;
+      crc_bit = crc_register >> 15;
+      crc_register <<= 1;
+      if (data_bit != crc_bit)
+        crc_register ^= polynom;
+    }
+  }
+  crc[0] = (uint8_t) (crc_register & 0x00FF);
+  crc[1] = (uint8_t) (crc_register >> 8);
+}
+
+
+/** \brief
+
+	cleanInputBuffer()
+
+    This function sets the entire inputBuffer to 0xFFs.
+	It is helpful for debugging message/count/CRCs errors.
+*/
+
+void ATECCX08A::cleanInputBuffer()
+{
+  for (int i = 0; i < sizeof(inputBuffer) ; i++)
+  {
+    inputBuffer[i] = 0xFF;
+  }
+}
+
+/** \brief
+
+	createNewKeyPair(uint16_t slot)
+
+    This function sends the command to create a new key pair (private AND public)
+	in the slot designated by argument slot (default slot 0).
+	Sparkfun Default Configuration Sketch calls this, and then locks the data/otp zones and slot 0.
+*/
+
+bool ATECCX08A::createNewKeyPair(uint16_t slot, uint8_t *publicKeyOut)
+{
+  // once the data zone is locked, only slots with WriteConfig GenKey set take a new key
+  if (!slotAllows(slot, SLOT_ECC_PRIVATE) || (dataOTPLockStatus && !slotAllows(slot, SLOT_ALLOW_GENKEY)))
+    return false;
+
+  beginSession();
+
+  // public key (64), plus crc (2), plus count (1)
+  if (!executeCommand(COMMAND_OPCODE_GENKEY, GENKEY_MODE_NEW_PRIVATE, slot))
+  {
+    endSession();
+    return false;
+  }
+
+  // update publicKey64Bytes[] array
+  // we don't need the count value (which is currently the first byte of the inputBuffer)
+  memcpy(publicKey64Bytes, &inputBuffer[RESPONSE_COUNT_SIZE], PUBLIC_KEY_SIZE);
+
+  if (publicKeyOut)
+    memcpy(publicKeyOut, &inputBuffer[RESPONSE_COUNT_SIZE], PUBLIC_KEY_SIZE);
+
+  endSession();
+
+  return true;
+}
+
+/** \brief
+
+	generatePublicKey(uint16_t slot, bool debug)
+
+    This function uses the GENKEY command in "Public Key Computation" mode.
+
+    Generates an ECC public key based upon the private key stored in the slot defined by the KeyID
+	parameter (aka slot). Defaults to slot 0.
+
+	Note, if you haven't created a private key in the slot already, then this will fail.
+
+	The generated public key is read back from the device, and then copied from inputBuffer to
+	a global variable named publicKey64Bytes for later use.
+*/
+
+bool ATECCX08A::generatePublicKey(uint16_t slot, bool debug, uint8_t *publicKeyOut)
+{
+  bool result;
+
+  if ((slot < DATA_ZONE_SLOTS) && !slotAllows(slot, SLOT_ALLOW_PUBLIC_KEY))
+    return false;
+
+  beginSession();
+
+  // public key (64), plus crc (2), plus count (1)
+  if (slot < DATA_ZONE_SLOTS)
+    result = executeConstantCommand(FRAME_GENKEY_PUBLIC(slot));
+  else
+    result = executeCommand(COMMAND_OPCODE_GENKEY, GENKEY_MODE_PUBLIC, slot);
+
+  if (!result)
+  {
+    endSession();
+    return false;
+  }
+
+  // update publicKey64Bytes[] array
+  // we don't need the count value (which is currently the first byte of the inputBuffer)
+  memcpy(publicKey64Bytes, &inputBuffer[RESPONSE_COUNT_SIZE], PUBLIC_KEY_SIZE);
+
+  if (publicKeyOut)
+    memcpy(publicKeyOut, &inputBuffer[RESPONSE_COUNT_SIZE], PUBLIC_KEY_SIZE);
+
+  if (debug)
+  {
+    _debugSerial->println("This device's Public Key:");
+    _debugSerial->println();
+    printHexDump("publicKey", publicKey64Bytes, sizeof(publicKey64Bytes));
+    _debugSerial->println();
+  }
+
+  endSession();
+
+  return true;
+}
+
+/** \brief
+
+	readPublicKey(uint16_t slot)
+
+	Reads a public key stored in a data slot (8-15), for example a signer's public key
+	that a certificate chain needs. Stored public keys are 72 bytes: 4 pad bytes, X, 4 pad bytes, Y.
+	The 64-byte X||Y is copied into publicKey64Bytes[].
+*/
+
+bool ATECCX08A::readPublicKey(uint16_t slot, uint8_t *publicKeyOut)
+{
+  uint8_t stored[PUBLIC_KEY_SLOT_SIZE];
+
+  if (!readSlot(slot, stored, PUBLIC_KEY_SLOT_SIZE))
+    return false;
+
+  memcpy(&publicKey64Bytes[0], &stored[4], 32);
+  memcpy(&publicKey64Bytes[32], &stored[40], 32);
+
+  if (publicKeyOut)
+  {
+    memcpy(&publicKeyOut[0], &stored[4], 32);
+    memcpy(&publicKeyOut[32], &stored[40], 32);
+  }
+
+  return true;
+}
+
+/** \brief
+
+	readSlot(uint16_t slot, uint8_t *data, uint16_t length)
+
+	Reads the first length bytes of a data slot (in the clear, so the slot must allow it).
+	Uses 32-byte reads for whole blocks and 4-byte reads for the rest, so length must be a multiple of 4.
+	The data zone can only be read once it is locked.
+*/
+
+bool ATECCX08A::readSlot(uint16_t slot, uint8_t *data, uint16_t length)
+{
+  bool result = true;
+  uint16_t offset = 0;
+
+  if ((slot >= DATA_ZONE_SLOTS) || (length % 4))
+    return fail(ATECC_STATUS_BAD_PARAM);
+
+  if (!slotAllows(slot, SLOT_ALLOW_READ))
+    return false;
+
+  if (!dataOTPLockStatus)
+    return fail(ATECC_STATUS_NOT_PERMITTED);
+
+  beginSession();
+
+  while ((offset < length) && result)
+  {
+    uint8_t block = offset / 32;
+    uint8_t word = (offset % 32) / 4;
+    uint8_t size = ((word == 0) && ((length - offset) >= 32)) ? 32 : 4;
+
+    result = read_output(ZONE_DATA, DATA_ZONE_ADDRESS(slot, block, word), size, &data[offset]);
+    offset += size;
+  }
+
+  endSession();
+
+  return result;
+}
+
+/** \brief
+
+	writeSlot(uint16_t slot, uint8_t *data, uint16_t length)
+
+	Writes the first length bytes of a data slot in the clear, with 32-byte writes
+	for whole blocks and 4-byte writes for the rest. length must be a multiple of 4.
+	Note, once the data zone is locked, only slots configured for clear writes can be written.
+	4-byte writes stay allowed for them: the IC only refuses 4-byte writes that are encrypted.
+*/
+
+bool ATECCX08A::writeSlot(uint16_t slot, uint8_t *data, uint16_t length)
+{
+  bool result = true;
+  uint16_t offset = 0;
+
+  if ((slot >= DATA_ZONE_SLOTS) || (length % 4))
+    return fail(ATECC_STATUS_BAD_PARAM);
+
+  // before the data zone is locked, every slot takes clear writes
+  if (!slotAllows(slot, 0) || (dataOTPLockStatus && !slotAllows(slot, SLOT_ALLOW_WRITE)))
+    return false;
+
+  beginSession();
+
+  while ((offset < length) && result)
+  {
+    uint8_t block = offset / 32;
+    uint8_t word = (offset % 32) / 4;
+    uint8_t size = ((word == 0) && ((length - offset) >= 32)) ? 32 : 4;
+
+    result = write(ZONE_DATA, DATA_ZONE_ADDRESS(slot, block, word), &data[offset], size);
+    offset += size;
+  }
+
+  endSession();
+
+  return result;
+}
+
+/** \brief
+
+	readCompressedCert(uint16_t slot, uint8_t *compressed)
+
+	Reads a 72-byte compressed certificate from a data slot (by convention, slot 10 for the
+	device certificate and slot 12 for the signer certificate).
+	Use ATECCX08A_Cert::writeCertificate() to rebuild the full DER certificate from it.
+*/
+
+bool ATECCX08A::readCompressedCert(uint16_t slot, uint8_t *compressed)
+{
+  return readSlot(slot, compressed, COMPRESSED_CERT_SIZE);
+}
+
+/** \brief
+
+	writeCompressedCert(uint16_t slot, uint8_t *compressed)
+
+	Stores a 72-byte compressed certificate (see ATECCX08A_Cert::compressCertificate()) in a data slot.
+*/
+
+bool ATECCX08A::writeCompressedCert(uint16_t slot, uint8_t *compressed)
+{
+  return writeSlot(slot, compressed, COMPRESSED_CERT_SIZE);
+}
+
+/** \brief
+
+	read(uint8_t zone, uint16_t address, uint8_t length, bool debug)
+
+    Reads data from the IC at a specific zone and address.
+	Your data response will be available at inputBuffer[].
+
+	For more info on address encoding, see datasheet pg 58.
+*/
+
+bool ATECCX08A::read(uint8_t zone, uint16_t address, uint8_t length, bool debug)
+{
+	return read_output(zone, address, length, NULL, debug);
+}
+
+bool ATECCX08A::read_output(uint8_t zone, uint16_t address, uint8_t length, uint8_t * output, bool debug)
+{
+  // adjust zone as needed for whether it's 4 or 32 bytes length read
+  // bit 7 of zone needs to be set correctly
+  // (0 = 4 Bytes are read)
+  // (1 = 32 Bytes are read)
+  if (length == 32)
+  {
+	zone |= 0b10000000; // set bit 7
+  }
+  else if (length == 4)
+  {
+	zone &= ~0b10000000; // clear bit 7
+  }
+  else
+  {
+	return fail(ATECC_STATUS_BAD_PARAM); // invalid length, abort.
+  }
+
+  beginSession();
+
+  // response is count + length + CRC_SIZE
+  if (!executeCommand(COMMAND_OPCODE_READ, zone, address, NULL, 0, length, debug))
+  {
+	endSession();
+	return false;
+  }
+
+  /* Copy data to output */
+  if (output)
+  {
+	  memcpy(output, inputBuffer + RESPONSE_READ_INDEX, length);
+  }
+
+  endSession();
+
+  return true;
+}
+
+/** \brief
+
+	write(uint8_t zone, uint16_t address, uint8_t *data, uint8_t length_of_data)
+
+    Writes data to a specific zone and address on the IC.
+
+	For more info on zone and address encoding, see datasheet pg 58.
+*/
+
+bool ATECCX08A::write(uint8_t zone, uint16_t address, uint8_t *data, uint8_t length_of_data)
+{
+  // adjust zone as needed for whether it's 4 or 32 bytes length write
+  // bit 7 of param1 needs to be set correctly
+  // (0 = 4 Bytes are written)
+  // (1 = 32 Bytes are written)
+  if (length_of_data == 32)
+  {
+	zone |= 0b10000000; // set bit 7
+  }
+  else if (length_of_data == 4)
+  {
+	zone &= ~0b10000000; // clear bit 7
+  }
+  else
+  {
+	return fail(ATECC_STATUS_BAD_PARAM); // invalid length, abort.
+  }
+
+  // If we hear a "0x00", that means it had a successful write
+  return executeCommand(COMMAND_OPCODE_WRITE, zone, address, data, length_of_data);
+}
+
+/** \brief
+
+	createSignature(uint8_t *data, uint16_t slot)
+
+    Creates a 64-byte ECC signature on 32 bytes of data.
+	Defaults to use private key located in slot 0.
+	Your signature will be available at global variable signature[].
+
+	Note, the IC actually needs you to store your data in a temporary memory location
+	called TempKey. This function first loads TempKey, and then signs TempKey. Then it
+	receives the signature and copies it to signature[].
+*/
+
+bool ATECCX08A::createSignature(uint8_t *data, uint16_t slot, uint8_t *signatureOut)
+{
+  bool result;
+
+  if (!slotAllows(slot, SLOT_ALLOW_SIGN))
+    return false;
+
+  // a deadline with room for NONCE but not SIGN fails here, instead of after NONCE
+  if (!checkDeadline(commandMillis(COMMAND_OPCODE_NONCE, 32) + commandMillis(COMMAND_OPCODE_SIGN)))
+    return false;
+
+  beginSession(); // load and sign in a single wake
+  result = (loadTempKey(data) && signTempKey(slot, signatureOut));
+  endSession();
+
+  return result;
+}
+
+/** \brief
+
+	loadTempKey(uint8_t *data)
+
+	Writes 32 bytes of data to memory location "TempKey" on the IC.
+	Note, the data is provided externally by you, the user, and is included in the
+	command NONCE.
+
+    We will use the NONCE command in passthrough mode to load tempKey with our data (aka message).
+    Note, the datasheet warns that this does not provide protection agains replay attacks,
+    but we will protect again this because our server (Bob) is going to send us it's own unique random TOKEN,
+    when it requests data, and this will allow us to create a unique data + signature for every communication.
+*/
+
+bool ATECCX08A::loadTempKey(uint8_t *data)
+{
+  // note, param2 is 0x0000 (and param1 is PASSTHROUGH), so OutData will be just a single byte of zero upon completion.
+  // see ds pg 77 for more info
+  // If we hear a "0x00", that means it had a successful nonce
+  return executeCommand(COMMAND_OPCODE_NONCE, NONCE_MODE_PASSTHROUGH, 0x0000, data, 32);
+}
+
+/** \brief
+
+	signTempKey(uint16_t slot)
+
+	Create a 64 byte ECC signature for the contents of TempKey using the private key in Slot.
+	Default slot is 0
+
+	The response from this command (the signature) is stored in global varaible signature[].
+*/
+
+bool ATECCX08A::signTempKey(uint16_t slot, uint8_t *signatureOut)
+{
+  if (!slotAllows(slot, SLOT_ALLOW_SIGN))
+    return false;
+
+  beginSession();
+
+  // signature (64), plus crc (2), plus count (1)
+  if (!executeCommand(COMMAND_OPCODE_SIGN, SIGN_MODE_TEMPKEY, slot))
+  {
+    endSession();
+    return false;
+  }
+
+  // update signature[] array
+  // we don't need the count value (which is currently the first byte of the inputBuffer)
+  memcpy(signature, &inputBuffer[RESPONSE_COUNT_SIZE], SIGNATURE_SIZE);
+
+  if (signatureOut)
+    memcpy(signatureOut, &inputBuffer[RESPONSE_COUNT_SIZE], SIGNATURE_SIZE);
+
+  endSession();
+
+  ATECC_LOG_HEX_DEBUG("signature", signature, sizeof(signature));
+
+  return true;
+}
+
+/** \brief
+
+	verifySignature(uint8_t *message, uint8_t *signature, uint8_t *publicKey)
+
+	Verifies a ECC signature using the message, signature and external public key.
+	Returns true if successful.
+
+	Depending on the verify policy (see setVerifyPolicy()), this runs on the IC with verifySignatureDevice(),
+	or on the host with verifySignatureSoftware(). Both give the same result.
+*/
+
+bool ATECCX08A::verifySignature(uint8_t *message, uint8_t *signature, uint8_t *publicKey)
+{
+  if (softwareVerifyPreferred())
+    return verifySignatureSoftware(message, signature, publicKey);
+
+  return verifySignatureDevice(message, signature, publicKey);
+}
+
+/** \brief
+
+	verifySignatureDevice(uint8_t *message, uint8_t *signature, uint8_t *publicKey)
+
+	Verifies a ECC signature on the IC.
+
+	Note, it acutally uses loadTempKey, then uses the verify command in "external public key" mode.
+	So the contents of TempKey are lost.
+*/
+
+bool ATECCX08A::verifySignatureDevice(uint8_t *message, uint8_t *signature, uint8_t *publicKey)
+{
+  bool result = false;
+  unsigned long startMicros = micros();
+
+  beginSession(); // load and verify in a single wake
+
+  // first, let's load the message into TempKey on the device, this uses NONCE command in passthrough mode.
+  if (!loadTempKey(message))
+    ATECC_LOG_ERROR("Load TempKey Failure");
+  else
+    result = verifyTempKey(signature, publicKey);
+
+  endSession();
+
+  _deviceVerifyMicros = micros() - startMicros;
+
+  return result;
+}
+
+/** \brief
+
+	verifySignatureStored(uint8_t *message, uint8_t *signature, uint16_t slot)
+
+	Verifies a ECC signature on the IC, with the public key stored in slot (VERIFY stored mode),
+	so only the 64-byte signature goes over the bus. The slot must hold a P256 public key
+	(KeyConfig KeyType P256, Private = 0), padded as readPublicKey() expects, e.g. written with writeSlot().
+	Any other slot fails with ATECC_STATUS_NOT_PERMITTED before anything is sent.
+	The contents of TempKey are lost, as with verifySignatureDevice().
+*/
+
+bool ATECCX08A::verifySignatureStored(uint8_t *message, uint8_t *signature, uint16_t slot)
+{
+  bool result = false;
+  unsigned long startMicros = micros();
+
+  if (!slotAllows(slot, SLOT_ECC_PUBLIC))
+    return false;
+
+  beginSession();
+
+  if (!loadTempKey(message))
+    ATECC_LOG_ERROR("Load TempKey Failure");
+  else
+    result = executeCommand(COMMAND_OPCODE_VERIFY, VERIFY_MODE_STORED, slot, signature, SIGNATURE_SIZE);
+
+  endSession();
+
+  _deviceVerifyMicros = micros() - startMicros;
+
+  return result;
+}
+
+/** \brief
+
+	verifySignatureSoftware(uint8_t *message, uint8_t *signature, uint8_t *publicKey)
+
+	Verifies a ECC signature on the host (see SparkFun_ATECCX08a_P256.h), without using the IC.
+	Same arguments and result as verifySignatureDevice().
+*/
+
+bool ATECCX08A::verifySignatureSoftware(uint8_t *message, uint8_t *signature, uint8_t *publicKey)
+{
+  unsigned long startMicros = micros();
+  bool result = ATECCX08A_P256::verify(message, signature, publicKey);
+
+  _softwareVerifyMicros = micros() - startMicros;
+
+  if (!result)
+    return fail(ATECC_STATUS_MISCOMPARE); // same as the IC's VERIFY
+
+  _lastStatus = ATECC_STATUS_SUCCESS;
+
+  return true;
+}
+
+/** \brief
+
+	setVerifyPolicy(uint8_t policy)
+
+	Chooses where verifySignature() runs:
+	VERIFY_POLICY_DEVICE: always on the IC.
+	VERIFY_POLICY_SOFTWARE: always on the host.
+	VERIFY_POLICY_AUTO (default): see softwareVerifyPreferred().
+*/
+
+void ATECCX08A::setVerifyPolicy(uint8_t policy)
+{
+  _verifyPolicy = policy;
+}
+
+/** \brief
+
+	softwareVerifyPreferred()
+
+	Returns true if verifySignature() will verify in software.
+	With VERIFY_POLICY_AUTO, the last measured times of both paths are compared.
+	Before a path has been measured, the software estimate for this platform
+	(ATECCX08A_SOFTWARE_VERIFY_MICROS) and the datasheet times plus bus time for the IC are used.
+	While the IC is busy (inside a session, where a verify on the IC would also overwrite TempKey),
+	software is preferred unless it is more than VERIFY_BUSY_SOFTWARE_FACTOR times slower.
+*/
+
+bool ATECCX08A::softwareVerifyPreferred()
+{
+  unsigned long deviceMicros;
+
+  if (_verifyPolicy == VERIFY_POLICY_SOFTWARE)
+    return true;
+  if (_verifyPolicy == VERIFY_POLICY_DEVICE)
+    return false;
+
+  deviceMicros = _deviceVerifyMicros;
+  if (deviceMicros == 0)
+    deviceMicros = (executionTime(COMMAND_OPCODE_NONCE) + executionTime(COMMAND_OPCODE_VERIFY)) * 1000UL + (VERIFY_BUS_MICROS * ATECC_WAKE_CLOCK_HZ) / (_dataClock ? _dataClock : ATECC_WAKE_CLOCK_HZ);
+
+  if (_sessionDepth > 0)
+    deviceMicros *= VERIFY_BUSY_SOFTWARE_FACTOR;
+
+  return (_softwareVerifyMicros < deviceMicros);
+}
+
+/** \brief
+
+	verifyTempKey(uint8_t *signature, uint8_t *publicKey)
+
+	Verifies a ECC signature of the message already in TempKey, using the verify command
+	in "external public key" mode. Returns true if successful.
+*/
+
+bool ATECCX08A::verifyTempKey(uint8_t *signature, uint8_t *publicKey)
+{
+  uint8_t data_sigAndPub[128];
+
+  // We can only send one *single* data array to sendCommand as Param2, so we need to combine signature and public key.
+  memcpy(&data_sigAndPub[0], &signature[0], SIGNATURE_SIZE);	// append signature
+  memcpy(&data_sigAndPub[SIGNATURE_SIZE], &publicKey[0], PUBLIC_KEY_SIZE);	// append external public key
+
+  // If we hear a "0x00", that means it had a successful verify
+  return executeCommand(COMMAND_OPCODE_VERIFY, VERIFY_MODE_EXTERNAL, VERIFY_PARAM2_KEYTYPE_ECC, data_sigAndPub, sizeof(data_sigAndPub));
+}
+
+/** \brief
+
+	issueChallenge(uint8_t *challenge, uint8_t mode)
+
+	Verifier side of a challenge-response authentication.
+	Creates a new 32-byte challenge (aka token) in a single wake session, and copies it into challenge.
+	Send it to the prover, who signs it with respondToChallenge(), then check the signature with checkResponse().
+
+	mode CHALLENGE_MODE_RANDOM: the challenge comes straight from the RNG (RANDOM command).
+
+	mode CHALLENGE_MODE_NONCE: uses the NONCE command in random mode. The IC combines a new
+	random number with NumIn, and keeps SHA-256(RandOut, NumIn, 0x16, mode, 0x00) in TempKey.
+	We calculate the same digest here, and that digest is the challenge.
+	checkResponse() then verifies directly against TempKey, so the IC itself guarantees the
+	challenge is the fresh one it generated. The challenge is lost if TempKey is overwritten,
+	or if the IC falls asleep, so check the response before any other TempKey command.
+	Any command other than Info, Lock, Random, Read, Counter and UpdateExtra drops it, and
+	checkResponse() then loads the challenge with a NONCE passthrough instead.
+*/
+
+bool ATECCX08A::issueChallenge(uint8_t *challenge, uint8_t mode)
+{
+  if (mode == CHALLENGE_MODE_RANDOM)
+  {
+    _challengePending = false;
+    return updateRandom32Bytes(false, challenge);
+  }
+
+  // NumIn carries the host's own freshness contribution. We trust our own IC's RNG here, so it is left as zeros.
+  uint8_t tempKeyMessage[NONCE_TEMPKEY_MESSAGE_SIZE] = {0};
+
+  beginSession(); // TempKey and _challengeDigest[] must describe the same challenge
+
+  _challengePending = false;
+
+  // RandOut is 32 bytes (count + 32_data_bytes + crc[0] + crc[1]). Idle afterwards retains TempKey.
+  if (!executeCommand(COMMAND_OPCODE_NONCE, NONCE_MODE_RANDOM, 0x0000, &tempKeyMessage[RESPONSE_RANDOM_SIZE], NONCE_NUMIN_SIZE, RESPONSE_RANDOM_SIZE))
+  {
+    endSession();
+    return false;
+  }
+
+  // TempKey = SHA-256(RandOut, NumIn, opcode, mode, LSB of param2). datasheet pg 79
+  memcpy(&tempKeyMessage[0], &inputBuffer[RESPONSE_COUNT_SIZE], RESPONSE_RANDOM_SIZE);
+  tempKeyMessage[RESPONSE_RANDOM_SIZE + NONCE_NUMIN_SIZE + 0] = COMMAND_OPCODE_NONCE;
+  tempKeyMessage[RESPONSE_RANDOM_SIZE + NONCE_NUMIN_SIZE + 1] = NONCE_MODE_RANDOM;
+  tempKeyMessage[RESPONSE_RANDOM_SIZE + NONCE_NUMIN_SIZE + 2] = 0x00;
+
+  ATECCX08A_SHA256::hash(tempKeyMessage, sizeof(tempKeyMessage), _challengeDigest);
+
+  memcpy(challenge, _challengeDigest, CHALLENGE_SIZE);
+  _challengePending = true;
+
+  endSession();
+
+  return true;
+}
+
+/** \brief
+
+	respondToChallenge(uint8_t *challenge, uint16_t slot)
+
+	Prover side of a challenge-response authentication.
+	Signs the 32-byte challenge with the private key in slot (default slot 0), in a single wake session.
+	The signature is available at global variable signature[].
+*/
+
+bool ATECCX08A::respondToChallenge(uint8_t *challenge, uint16_t slot, uint8_t *signatureOut)
+{
+  return createSignature(challenge, slot, signatureOut);
+}
+
+/** \brief
+
+	checkResponse(uint8_t *challenge, uint8_t *signature, uint8_t *publicKey)
+
+	Verifier side of a challenge-response authentication.
+	Verifies the prover's signature of challenge with the prover's public key, in a single wake session.
+	If challenge is the one still held in TempKey by issueChallenge(CHALLENGE_MODE_NONCE),
+	it is verified directly against TempKey (no NONCE passthrough load).
+	Each challenge can only be checked against TempKey once.
+*/
+
+bool ATECCX08A::checkResponse(uint8_t *challenge, uint8_t *signature, uint8_t *publicKey)
+{
+  bool result;
+
+  beginSession(); // TempKey still holds our challenge only while no one else uses the IC
+
+  if (_challengePending && (memcmp(challenge, _challengeDigest, CHALLENGE_SIZE) == 0))
+  {
+    _challengePending = false;
+    result = verifyTempKey(signature, publicKey);
+    endSession();
+    return result;
+  }
+
+  endSession();
+
+  return verifySignature(challenge, signature, publicKey);
+}
+
+/** \brief
+
+	mac(uint16_t slot, uint8_t *challenge, uint8_t *digest)
+
+	Prover side of a symmetric challenge-response.
+	The IC computes SHA-256 over the 32-byte key in slot and the 32-byte challenge
+	(plus the command bytes and the fixed serial number bytes, see calculateMac()),
+	and the 32-byte digest is copied into digest. The key never leaves the IC.
+	Returns false if the slot is not a MAC key (ECC key, or NoMac set in SlotConfig).
+*/
+
+bool ATECCX08A::mac(uint16_t slot, uint8_t *challenge, uint8_t *digest)
+{
+  bool result;
+
+  if (!checkMacSlot(slot))
+    return false;
+
+  beginSession();
+
+  // count + 32_digest_bytes + crc[0] + crc[1]
+  result = executeCommand(COMMAND_OPCODE_MAC, MAC_MODE_CHALLENGE, slot, challenge, MAC_CHALLENGE_SIZE, RESPONSE_MAC_SIZE);
+  if (result)
+    memcpy(digest, &inputBuffer[RESPONSE_COUNT_SIZE], RESPONSE_MAC_SIZE);
+
+  endSession();
+
+  return result;
+}
+
+/** \brief
+
+	checkMac(uint16_t slot, uint8_t *challenge, uint8_t *digest)
+
+	Verifier side of a symmetric challenge-response.
+	The IC recomputes the MAC of challenge with its own copy of the key in slot, and compares it
+	with the prover's digest (from mac() with the same slot number). Returns true only on a match.
+	The comparison happens inside the IC, so the verifier never sees the key or the expected digest.
+*/
+
+bool ATECCX08A::checkMac(uint16_t slot, uint8_t *challenge, uint8_t *digest)
+{
+  // ClientChal (32), ClientResp (32), OtherData (13)
+  uint8_t data[MAC_CHALLENGE_SIZE + RESPONSE_MAC_SIZE + CHECKMAC_OTHER_DATA_SIZE] = {0};
+
+  if (!checkMacSlot(slot))
+    return false;
+
+  memcpy(&data[0], challenge, MAC_CHALLENGE_SIZE);
+  memcpy(&data[MAC_CHALLENGE_SIZE], digest, RESPONSE_MAC_SIZE);
+
+  // OtherData starts with the opcode, mode and param2 of the prover's MAC command, the rest stays zero
+  data[MAC_CHALLENGE_SIZE + RESPONSE_MAC_SIZE + 0] = COMMAND_OPCODE_MAC;
+  data[MAC_CHALLENGE_SIZE + RESPONSE_MAC_SIZE + 1] = MAC_MODE_CHALLENGE;
+  data[MAC_CHALLENGE_SIZE + RESPONSE_MAC_SIZE + 2] = slot & 0xFF;
+  data[MAC_CHALLENGE_SIZE + RESPONSE_MAC_SIZE + 3] = slot >> 8;
+
+  // If we hear a "0x00", the digest matched (0x01 = miscompare)
+  return executeCommand(COMMAND_OPCODE_CHECKMAC, CHECKMAC_MODE_CHALLENGE, slot, data, sizeof(data));
+}
+
+/** \brief
+
+	writeMacKey(uint16_t slot, uint8_t *key)
+
+	Writes a 32-byte MAC key into slot. Writes in the clear only work while the data zone
+	is unlocked, so do this during provisioning, before lockDataAndOTP().
+	The slot must be set up for it first, see macSlotConfig().
+*/
+
+bool ATECCX08A::writeMacKey(uint16_t slot, uint8_t *key)
+{
+  if (!checkMacSlot(slot))
+    return false;
+
+  if (dataOTPLockStatus)
+  {
+    ATECC_LOG_ERROR("Data zone is locked, MAC key can not be written");
+    return fail(ATECC_STATUS_EXECUTION_ERROR); // what the IC would answer
+  }
+
+  return writeSlot(slot, key, MAC_KEY_SIZE);
+}
+
+/** \brief
+
+	macSlotConfig(uint8_t *config, uint8_t slot)
+
+	Sets SlotConfig and KeyConfig of slot in a 128-byte config zone image (e.g. a copy of configZone[])
+	for a secret MAC key: never readable, KeyType SHA. Write the image with writeConfig() or provisionConfig().
+*/
+
+void ATECCX08A::macSlotConfig(uint8_t *config, uint8_t slot)
+{
+  config[CONFIG_ZONE_SLOT_CONFIG + sizeof(uint16_t) * slot + 0] = SLOT_CONFIG_MAC_KEY & 0xFF;
+  config[CONFIG_ZONE_SLOT_CONFIG + sizeof(uint16_t) * slot + 1] = SLOT_CONFIG_MAC_KEY >> 8;
+  config[CONFIG_ZONE_KEY_CONFIG + sizeof(uint16_t) * slot + 0] = KEY_CONFIG_MAC_KEY & 0xFF;
+  config[CONFIG_ZONE_KEY_CONFIG + sizeof(uint16_t) * slot + 1] = KEY_CONFIG_MAC_KEY >> 8;
+}
+
+/** \brief
+
+	calculateMac(const uint8_t *key, const uint8_t *challenge, uint16_t slot, uint8_t *digest)
+
+	Computes the digest mac() returns, in software, for a verifier that holds the key itself
+	(e.g. a hub with per-device keys). datasheet pg 77:
+	SHA-256(key, challenge, opcode, mode, param2, 8 zeros (OTP), 3 zeros (OTP), SN[8], 4 zeros (SN[4:7]), SN[0:1], 2 zeros (SN[2:3]))
+	Compare the result with a constant time comparison.
+*/
+
+void ATECCX08A::calculateMac(const uint8_t *key, const uint8_t *challenge, uint16_t slot, uint8_t *digest)
+{
+  uint8_t message[MAC_MESSAGE_SIZE] = {0};
+
+  memcpy(&message[0], key, MAC_KEY_SIZE);
+  memcpy(&message[MAC_KEY_SIZE], challenge, MAC_CHALLENGE_SIZE);
+  message[64] = COMMAND_OPCODE_MAC;
+  message[65] = MAC_MODE_CHALLENGE;
+  message[66] = slot & 0xFF;
+  message[67] = slot >> 8;
+  // 68-78 OTP, zeros
+  message[79] = MAC_SN8;
+  // 80-83 SN[4:7], zeros
+  message[84] = MAC_SN0;
+  message[85] = MAC_SN1;
+  // 86-87 SN[2:3], zeros
+
+  ATECCX08A_SHA256::hash(message, sizeof(message), digest);
+}
+
+bool ATECCX08A::checkMacSlot(uint16_t slot)
+{
+  if (!slotAllows(slot, SLOT_ALLOW_MAC))
+  {
+    ATECC_LOG_ERROR("Slot is not a MAC key");
+    return false;
+  }
+
+  return true;
+}
+
+/** \brief
+
+	kdf(uint8_t mode, uint16_t keyId, uint32_t details, const uint8_t *message, uint8_t messageLength, uint8_t *output, uint8_t *outputNonce)
+
+	ATECC608A only. Sends one KDF command: mode is KDF_MODE_ALG_*, KDF_MODE_SOURCE_* and KDF_MODE_TARGET_*,
+	keyId the source and target slots (see KDF_KEY_ID()), details the KDF_DETAILS_* for the algorithm.
+	For PRF and HKDF, the message length is added to details here.
+	With KDF_MODE_TARGET_OUTPUT, the result (32 bytes, 64 for PRF with KDF_DETAILS_PRF_TARGET_LEN_64)
+	is copied to output. With KDF_MODE_TARGET_OUTPUT_ENC, output gets it encrypted with the IO protection
+	key, and outputNonce the 32-byte nonce to decrypt it (see decryptKdfOutput()).
+	For everything else the result stays on the IC, in a slot, TempKey or the alternate key buffer.
+*/
+
+bool ATECCX08A::kdf(uint8_t mode, uint16_t keyId, uint32_t details, const uint8_t *message, uint8_t messageLength, uint8_t *output, uint8_t *outputNonce)
+{
+  uint8_t data[KDF_DETAILS_SIZE + KDF_MAX_MESSAGE_SIZE];
+  uint8_t target = mode & KDF_MODE_TARGET_MASK;
+  uint8_t outputSize = 0;
+  uint8_t responseSize = RESPONSE_SIGNAL_SIZE;
+  bool result;
+
+  if (!hasFeature(ATECC_FEATURE_KDF))
+  {
+    ATECC_LOG_ERROR("KDF needs an ATECC608");
+    return fail(ATECC_STATUS_NOT_SUPPORTED);
+  }
+
+  if ((messageLength > KDF_MAX_MESSAGE_SIZE) || (((mode & 0xE0) == KDF_MODE_ALG_AES) && (messageLength != AES_BLOCK_SIZE)))
+    return fail(ATECC_STATUS_BAD_PARAM);
+
+  if ((mode & 0xE0) != KDF_MODE_ALG_AES)
+    details = (details & 0x00FFFFFFUL) | KDF_DETAILS_MESSAGE_LENGTH(messageLength);
+
+  if ((target == KDF_MODE_TARGET_OUTPUT) || (target == KDF_MODE_TARGET_OUTPUT_ENC))
+  {
+    if (!output || ((target == KDF_MODE_TARGET_OUTPUT_ENC) && !outputNonce))
+      return fail(ATECC_STATUS_BAD_PARAM);
+    outputSize = (((mode & 0xE0) == KDF_MODE_ALG_PRF) && (details & KDF_DETAILS_PRF_TARGET_LEN_64)) ? (2 * KDF_OUTPUT_SIZE) : KDF_OUTPUT_SIZE;
+    responseSize = outputSize + ((target == KDF_MODE_TARGET_OUTPUT_ENC) ? KDF_NONCE_SIZE : 0);
+  }
+
+  for (uint8_t i = 0; i < KDF_DETAILS_SIZE; i++)
+    data[i] = (details >> (8 * i)) & 0xFF;
+  memcpy(&data[KDF_DETAILS_SIZE], message, messageLength);
+
+  beginSession();
+
+  result = executeCommand(COMMAND_OPCODE_KDF, mode, keyId, data, KDF_DETAILS_SIZE + messageLength, responseSize);
+  if (result && outputSize)
+  {
+    memcpy(output, &inputBuffer[RESPONSE_COUNT_SIZE], outputSize);
+    if (target == KDF_MODE_TARGET_OUTPUT_ENC)
+      memcpy(outputNonce, &inputBuffer[RESPONSE_COUNT_SIZE + outputSize], KDF_NONCE_SIZE);
+  }
+
+  endSession();
+
+  return result;
+}
+
+/** \brief
+
+	deriveKey(ATECCX08A_KeyDerivation *derivation)
+
+	Derives a 32-byte key from the key in derivation->source and derivation->info, on the IC,
+	into a slot or TempKey, or returned (encrypted) to the host. Use a different info for every key,
+	e.g. a session number and a direction.
+
+	ATECC608A: HKDF-Expand (RFC 5869) with the source key as PRK, one block:
+	HMAC-SHA256(source, info || 0x01), with the KDF command. calculateDerivedKey() gives the same key,
+	so a peer that shares the master key can derive it in software. With a shared secret from
+	ecdhToTempKey() as the source, the secret never leaves the IC either.
+
+	ATECC508A: the key is SHA-256 of the source key, SHA-256(info) and the serial number,
+	through TempKey: NONCE pass-through, then GenDig (into TempKey) or DeriveKey (into a slot).
+	For DeriveKey, the target slot's config picks the parent key (its WriteKey for Create, the
+	slot itself for Roll), so source must be that slot; SlotConfig.WriteConfig must allow
+	DeriveKey without a MAC. The key can not be returned: KDF_TARGET_OUTPUT and
+	KDF_TARGET_ENCRYPTED fail with ATECC_STATUS_NOT_SUPPORTED, and so does a TempKey source.
+*/
+
+bool ATECCX08A::deriveKey(ATECCX08A_KeyDerivation *derivation)
+{
+  uint8_t message[KDF_MAX_MESSAGE_SIZE];
+  uint8_t mode = KDF_MODE_ALG_HKDF;
+  uint8_t source = 0;
+  uint8_t target = 0;
+  bool result;
+
+  if ((derivation->infoLength > KDF_MAX_INFO_SIZE) || (derivation->target > KDF_TARGET_ENCRYPTED))
+    return fail(ATECC_STATUS_BAD_PARAM);
+  if ((derivation->source != KDF_KEYID_TEMPKEY) && (derivation->source >= DATA_ZONE_SLOTS))
+    return fail(ATECC_STATUS_BAD_PARAM);
+  if ((derivation->target == KDF_TARGET_SLOT) && (derivation->targetSlot >= DATA_ZONE_SLOTS))
+    return fail(ATECC_STATUS_BAD_PARAM);
+
+  if (!hasFeature(ATECC_FEATURE_KDF))
+    return deriveKeyThroughTempKey(derivation);
+
+  if (derivation->source == KDF_KEYID_TEMPKEY)
+    mode |= KDF_MODE_SOURCE_TEMPKEY;
+  else
+  {
+    mode |= KDF_MODE_SOURCE_SLOT;
+    source = derivation->source;
+  }
+
+  switch (derivation->target)
+  {
+    case KDF_TARGET_SLOT:
+      mode |= KDF_MODE_TARGET_SLOT;
+      target = derivation->targetSlot;
+      break;
+    case KDF_TARGET_TEMPKEY:
+      mode |= KDF_MODE_TARGET_TEMPKEY;
+      break;
+    case KDF_TARGET_OUTPUT:
+      mode |= KDF_MODE_TARGET_OUTPUT;
+      break;
+    default:
+      mode |= KDF_MODE_TARGET_OUTPUT_ENC;
+      break;
+  }
+
+  // T(1) of HKDF-Expand
+  memcpy(message, derivation->info, derivation->infoLength);
+  message[derivation->infoLength] = 0x01;
+
+  result = kdf(mode, KDF_KEY_ID(source, target), KDF_DETAILS_HKDF_MSG_INPUT, message, derivation->infoLength + 1, derivation->output, derivation->nonce);
+
+  if (!result)
+    ATECC_LOG_ERROR("Key derivation failed");
+
+  return result;
+}
+
+// ATECC508A version of deriveKey(): NONCE pass-through of SHA-256(info), then GenDig or DeriveKey
+bool ATECCX08A::deriveKeyThroughTempKey(ATECCX08A_KeyDerivation *derivation)
+{
+  uint8_t context[SHA256_SIZE];
+  bool result;
+
+  if ((derivation->source == KDF_KEYID_TEMPKEY) || (derivation->target >= KDF_TARGET_OUTPUT))
+  {
+    ATECC_LOG_ERROR("Key derivation to the host, or from TempKey, needs an ATECC608");
+    return fail(ATECC_STATUS_NOT_SUPPORTED);
+  }
+
+  ATECCX08A_SHA256::hash(derivation->info, derivation->infoLength, context);
+
+  beginSession(); // TempKey only lasts while the IC is awake
+
+  result = loadTempKey(context);
+  if (result && (derivation->target == KDF_TARGET_TEMPKEY))
+    result = executeCommand(COMMAND_OPCODE_GENDIG, GENDIG_ZONE_DATA, derivation->source);
+  else if (result)
+    result = executeCommand(COMMAND_OPCODE_DERIVEKEY, DERIVEKEY_MODE_INPUT, derivation->targetSlot);
+
+  endSession();
+
+  if (!result)
+    ATECC_LOG_ERROR("Key derivation failed");
+
+  return result;
+}
+
+/** \brief
+
+	deriveKeys(ATECCX08A_KeyDerivation *derivations, uint8_t count)
+
+	Runs deriveKey() for each of the count derivations, all in a single wake session, so a
+	rekey pays for one wake instead of one per key. Stops at the first failure, and returns false.
+	A derivation into TempKey replaces the TempKey that later ones would use as their source.
+*/
+
+bool ATECCX08A::deriveKeys(ATECCX08A_KeyDerivation *derivations, uint8_t count)
+{
+  bool result = true;
+
+  beginSession();
+
+  for (uint8_t i = 0; (i < count) && result; i++)
+    result = deriveKey(&derivations[i]);
+
+  endSession();
+
+  return result;
+}
+
+/** \brief
+
+	calculateDerivedKey(const uint8_t *key, const uint8_t *info, uint8_t infoLength, uint8_t *derived)
+
+	The key deriveKey() derives on an ATECC608A from the 32-byte key, in software:
+	HMAC-SHA256(key, info || 0x01). For a peer that holds the same master key.
+*/
+
+void ATECCX08A::calculateDerivedKey(const uint8_t *key, const uint8_t *info, uint8_t infoLength, uint8_t *derived)
+{
+  ATECCX08A_SHA256 sha;
+  uint8_t pad[SHA_BLOCK_SIZE];
+  uint8_t counter = 0x01;
+  uint8_t inner[SHA256_SIZE];
+
+  memset(pad, 0x36, sizeof(pad)); // ipad
+  for (uint8_t i = 0; i < SHA256_SIZE; i++)
+    pad[i] ^= key[i];
+  sha.begin();
+  sha.update(pad, sizeof(pad));
+  sha.update(info, infoLength);
+  sha.update(&counter, 1);
+  sha.finish(inner);
+
+  for (uint8_t i = 0; i < sizeof(pad); i++)
+    pad[i] ^= (0x36 ^ 0x5C); // opad
+  sha.begin();
+  sha.update(pad, sizeof(pad));
+  sha.update(inner, sizeof(inner));
+  sha.finish(derived);
+
+  memset(pad, 0, sizeof(pad));
+  memset(inner, 0, sizeof(inner));
+}
+
+/** \brief
+
+	decryptKdfOutput(const uint8_t *ioKey, const uint8_t *nonce, uint8_t *data, size_t length)
+
+	Decrypts, in place, what deriveKey() returned with KDF_TARGET_ENCRYPTED (or kdf() with
+	KDF_MODE_TARGET_OUTPUT_ENC). ioKey is the 32-byte IO protection key, written to the slot
+	that the config zone names for it, and kept by the host. Each 32-byte block is XORed with
+	SHA-256(ioKey || 16 bytes of the nonce).
+*/
+
+void ATECCX08A::decryptKdfOutput(const uint8_t *ioKey, const uint8_t *nonce, uint8_t *data, size_t length)
+{
+  ATECCX08A_SHA256 sha;
+  uint8_t mask[SHA256_SIZE];
+
+  for (size_t block = 0; (block * SHA256_SIZE) < length; block++)
+  {
+    sha.begin();
+    sha.update(ioKey, SHA256_SIZE);
+    sha.update(&nonce[block * 16], 16);
+    sha.finish(mask);
+
+    for (size_t i = 0; (i < SHA256_SIZE) && ((block * SHA256_SIZE + i) < length); i++)
+      data[block * SHA256_SIZE + i] ^= mask[i];
+  }
+
+  memset(mask, 0, sizeof(mask));
+}
+
+/** \brief
+
+	ecdh(uint16_t slot, uint8_t *publicKey, uint8_t *sharedSecret)
+
+	Performs ECDH key agreement on the IC, using the private key stored in slot
+	and the peer's 64-byte public key (X,Y). This replaces a software P-256 scalar multiply.
+	The 32-byte shared secret (the X coordinate of the shared point) is copied into sharedSecret.
+
+	The slot must have ECDH enabled in its SlotConfig (ReadKey bit 2), and must NOT have
+	the "write to slot" option set (ReadKey bit 3), otherwise the IC will not return the secret.
+	These are checked against the cached config zone before anything is sent to the IC.
+*/
+
+bool ATECCX08A::ecdh(uint16_t slot, uint8_t *publicKey, uint8_t *sharedSecret)
+{
+  bool result;
+
+  if (!checkEcdhSlot(slot, false))
+    return false;
+
+  beginSession();
+
+  result = executeCommand(COMMAND_OPCODE_ECDH, ECDH_MODE_COMPATIBLE, slot, publicKey, PUBLIC_KEY_SIZE, RESPONSE_ECDH_SIZE);
+  if (result)
+    memcpy(sharedSecret, &inputBuffer[RESPONSE_COUNT_SIZE], SHARED_SECRET_SIZE);
+
+  endSession();
+
+  return result;
+}
+
+/** \brief
+
+	ecdhToSlot(uint16_t slot, uint8_t *publicKey)
+
+	Performs ECDH key agreement on the IC, and the IC writes the shared secret
+	into slot|1 (e.g. a key in slot 2 writes its secret into slot 3).
+	The secret never crosses the bus, and can be used later by other commands.
+
+	The slot must be even, and must have both ECDH (ReadKey bit 2) and
+	"write to slot" (ReadKey bit 3) enabled in its SlotConfig.
+*/
+
+bool ATECCX08A::ecdhToSlot(uint16_t slot, uint8_t *publicKey)
+{
+  if (!checkEcdhSlot(slot, true))
+    return false;
+
+  // If we hear a "0x00", that means the secret was written to the slot
+  return executeCommand(COMMAND_OPCODE_ECDH, ECDH_MODE_COMPATIBLE, slot, publicKey, PUBLIC_KEY_SIZE, RESPONSE_SIGNAL_SIZE);
+}
+
+/** \brief
+
+	ecdhToTempKey(uint16_t slot, uint8_t *publicKey)
+
+	ATECC608A only.
+	Performs ECDH key agreement on the IC, and the IC writes the shared secret into TempKey.
+	The secret never crosses the bus. Note, TempKey is lost on sleep (or watchdog timeout),
+	so use it right away (e.g. with a MAC or SHA/HMAC command).
+	On an ATECC508A this fails without sending anything.
+*/
+
+bool ATECCX08A::ecdhToTempKey(uint16_t slot, uint8_t *publicKey)
+{
+  if (!hasFeature(ATECC_FEATURE_ECDH_TEMPKEY))
+    return fail(ATECC_STATUS_NOT_SUPPORTED);
+
+  if (!checkEcdhSlot(slot, false))
+    return false;
+
+  // If we hear a "0x00", that means the secret was written to TempKey
+  return executeCommand(COMMAND_OPCODE_ECDH, ECDH_MODE_COPY_TEMPKEY, slot, publicKey, PUBLIC_KEY_SIZE, RESPONSE_SIGNAL_SIZE);
+}
+
+/** \brief
+
+	checkEcdhSlot(uint16_t slot, bool writeToSlot)
+
+	Checks the slot's decoded permissions before we spend any time on the bus.
+	Returns false if ECDH is not enabled for the slot, or if the slot's output
+	option does not match what the caller asked for (see SLOT_ALLOW_ECDH_SLOT).
+*/
+
+bool ATECCX08A::checkEcdhSlot(uint16_t slot, bool writeToSlot)
+{
+  if (!slotAllows(slot, writeToSlot ? SLOT_ALLOW_ECDH_SLOT : SLOT_ALLOW_ECDH))
+  {
+    ATECC_LOG_ERROR("ECDH (with this output option) not enabled for slot");
+    return false;
+  }
+
+  return true;
+}
+
+/** \brief
+
+	aesEncrypt(uint16_t slot, uint8_t keyBlock, uint8_t *plaintext, uint8_t *ciphertext)
+
+	ATECC608A only.
+	Encrypts one 16-byte block with the AES-128 engine on the IC.
+	The key stays in the IC: slot is the key slot (or AES_KEYID_TEMPKEY), and keyBlock (0-3)
+	selects which of the four 16-byte keys in that slot to use.
+	An ATECC508A does not have the AES command, so this fails without sending anything.
+*/
+
+bool ATECCX08A::aesEncrypt(uint16_t slot, uint8_t keyBlock, uint8_t *plaintext, uint8_t *ciphertext)
+{
+  return aesEcb(AES_MODE_ENCRYPT, slot, keyBlock, plaintext, ciphertext, AES_BLOCK_SIZE);
+}
+
+/** \brief
+
+	aesDecrypt(uint16_t slot, uint8_t keyBlock, uint8_t *ciphertext, uint8_t *plaintext)
+
+	ATECC608A only.
+	Decrypts one 16-byte block with the AES-128 engine on the IC. See aesEncrypt().
+*/
+
+bool ATECCX08A::aesDecrypt(uint16_t slot, uint8_t keyBlock, uint8_t *ciphertext, uint8_t *plaintext)
+{
+  return aesEcb(AES_MODE_DECRYPT, slot, keyBlock, ciphertext, plaintext, AES_BLOCK_SIZE);
+}
+
+/** \brief
+
+	aesEcbEncrypt(uint16_t slot, uint8_t keyBlock, uint8_t *plaintext, uint8_t *ciphertext, size_t length)
+
+	ATECC608A only.
+	Encrypts length bytes (a multiple of 16) in ECB mode, one AES command per block,
+	all in a single wake session. Note, ECB leaks repeated blocks, prefer CTR or GCM for real data.
+*/
+
+bool ATECCX08A::aesEcbEncrypt(uint16_t slot, uint8_t keyBlock, uint8_t *plaintext, uint8_t *ciphertext, size_t length)
+{
+  return aesEcb(AES_MODE_ENCRYPT, slot, keyBlock, plaintext, ciphertext, length);
+}
+
+/** \brief
+
+	aesEcbDecrypt(uint16_t slot, uint8_t keyBlock, uint8_t *ciphertext, uint8_t *plaintext, size_t length)
+
+	ATECC608A only.
+	Decrypts length bytes (a multiple of 16) in ECB mode, all in a single wake session.
+*/
+
+bool ATECCX08A::aesEcbDecrypt(uint16_t slot, uint8_t keyBlock, uint8_t *ciphertext, uint8_t *plaintext, size_t length)
+{
+  return aesEcb(AES_MODE_DECRYPT, slot, keyBlock, ciphertext, plaintext, length);
+}
+
+/** \brief
+
+	aesCtrInit(ATECCX08A_AES_CTR *ctx, uint16_t slot, uint8_t keyBlock, uint8_t *counter)
+
+	ATECC608A only.
+	Sets up ctx for AES-CTR with the key in slot/keyBlock, starting at the 16-byte initial counter block.
+	The whole 16-byte counter increments (big endian) for each block.
+	Nothing is sent to the IC yet, but the slot is checked against the config zone.
+*/
+
+bool ATECCX08A::aesCtrInit(ATECCX08A_AES_CTR *ctx, uint16_t slot, uint8_t keyBlock, uint8_t *counter)
+{
+  if (!checkAesSlot(slot))
+    return false;
+
+  ctx->slot = slot;
+  ctx->keyBlock = keyBlock;
+  memcpy(ctx->counter, counter, AES_BLOCK_SIZE);
+  ctx->keystreamUsed = AES_BLOCK_SIZE; // no keystream left, the next byte needs a new block
+  ctx->counterSize = AES_BLOCK_SIZE;
+
+  return true;
+}
+
+/** \brief
+
+	aesCtrUpdate(ATECCX08A_AES_CTR *ctx, uint8_t *input, uint8_t *output, size_t length)
+
+	ATECC608A only.
+	Encrypts (or decrypts, it's the same operation) length bytes in CTR mode.
+	Can be called as many times as needed, with any length. Unused keystream is kept for the next call.
+	All blocks of a call are sent in a single wake session.
+*/
+
+bool ATECCX08A::aesCtrUpdate(ATECCX08A_AES_CTR *ctx, uint8_t *input, uint8_t *output, size_t length)
+{
+  bool result;
+
+  beginSession();
+  result = aesCtrBlocks(ctx, input, output, length);
+  endSession();
+
+  return result;
+}
+
+/** \brief
+
+	aesGcmInit(ATECCX08A_AES_GCM *ctx, uint16_t slot, uint8_t keyBlock, uint8_t *iv, size_t ivLength)
+
+	ATECC608A only.
+	Sets up ctx for AES-GCM (NIST SP 800-38D) with the key in slot/keyBlock.
+	This sends two AES commands (hash subkey H, and E(K, J0) for the tag), in a single wake session.
+	The GHASH multiplications run in software on the host, they are much faster than another AES command.
+	A 12-byte IV is recommended. Never reuse an IV with the same key.
+*/
+
+bool ATECCX08A::aesGcmInit(ATECCX08A_AES_GCM *ctx, uint16_t slot, uint8_t keyBlock, uint8_t *iv, size_t ivLength)
+{
+  uint8_t j0[AES_BLOCK_SIZE];
+  bool result = false;
+
+  if (ivLength == 0)
+    return fail(ATECC_STATUS_BAD_PARAM);
+
+  if (!checkAesSlot(slot))
+    return false;
+
+  ctx->ctr.slot = slot;
+  ctx->ctr.keyBlock = keyBlock;
+  ctx->ctr.keystreamUsed = AES_BLOCK_SIZE;
+  ctx->ctr.counterSize = 4; // GCM increments only the low 32 bits
+  ctx->ghashBlockLength = 0;
+  ctx->aadLength = 0;
+  ctx->dataLength = 0;
+  memset(ctx->ghash, 0, AES_BLOCK_SIZE);
+  memset(ctx->h, 0, AES_BLOCK_SIZE);
+
+  beginSession();
+
+  if (aesCommand(AES_MODE_ENCRYPT | AES_MODE_KEY_BLOCK(keyBlock), slot, ctx->h, ctx->h)) // H = E(K, 0)
+  {
+    // J0 = IV || 0^31 || 1 for a 12-byte IV, otherwise GHASH(IV || padding || length of IV)
+    if (ivLength == AES_GCM_IV_SIZE)
+    {
+      memcpy(j0, iv, AES_GCM_IV_SIZE);
+      j0[12] = 0x00;
+      j0[13] = 0x00;
+      j0[14] = 0x00;
+      j0[15] = 0x01;
+    }
+    else
+    {
+      uint8_t lengthBlock[AES_BLOCK_SIZE] = {0};
+      uint32_t ivBits = ivLength * 8;
+
+      aesGcmHash(ctx, iv, ivLength);
+      aesGcmHashFlush(ctx);
+      lengthBlock[12] = (uint8_t)(ivBits >> 24);
+      lengthBlock[13] = (uint8_t)(ivBits >> 16);
+      lengthBlock[14] = (uint8_t)(ivBits >> 8);
+      lengthBlock[15] = (uint8_t)(ivBits);
+      aesGcmHash(ctx, lengthBlock, AES_BLOCK_SIZE);
+      memcpy(j0, ctx->ghash, AES_BLOCK_SIZE);
+      memset(ctx->ghash, 0, AES_BLOCK_SIZE);
+    }
+
+    result = aesCommand(AES_MODE_ENCRYPT | AES_MODE_KEY_BLOCK(keyBlock), slot, j0, ctx->tagMask);
+  }
+
+  endSession();
+
+  if (!result)
+    return false; // j0 is not set if H failed
+
+  // data starts at inc32(J0)
+  memcpy(ctx->ctr.counter, j0, AES_BLOCK_SIZE);
+  for (int i = AES_BLOCK_SIZE - 1; i >= AES_BLOCK_SIZE - 4; i--)
+  {
+    if (++ctx->ctr.counter[i] != 0)
+      break;
+  }
+
+  return true;
+}
+
+/** \brief
+
+	aesGcmAad(ATECCX08A_AES_GCM *ctx, uint8_t *aad, size_t length)
+
+	Adds additional authenticated data (authenticated, but not encrypted).
+	Can be called several times, but only before the first aesGcmEncrypt() / aesGcmDecrypt().
+	This is host-side only, nothing is sent to the IC.
+*/
+
+bool ATECCX08A::aesGcmAad(ATECCX08A_AES_GCM *ctx, uint8_t *aad, size_t length)
+{
+  if (ctx->dataLength != 0)
+    return fail(ATECC_STATUS_BAD_PARAM);
+
+  aesGcmHash(ctx, aad, length);
+  ctx->aadLength += length;
+
+  return true;
+}
+
+/** \brief
+
+	aesGcmEncrypt(ATECCX08A_AES_GCM *ctx, uint8_t *plaintext, uint8_t *ciphertext, size_t length)
+
+	ATECC608A only.
+	Encrypts length bytes and adds the ciphertext to the tag. Can be called as many times as needed.
+	All blocks of a call are sent in a single wake session.
+*/
+
+bool ATECCX08A::aesGcmEncrypt(ATECCX08A_AES_GCM *ctx, uint8_t *plaintext, uint8_t *ciphertext, size_t length)
+{
+  if (ctx->dataLength == 0)
+    aesGcmHashFlush(ctx); // pad out the AAD
+
+  if (!aesCtrUpdate(&ctx->ctr, plaintext, ciphertext, length))
+    return false;
+
+  aesGcmHash(ctx, ciphertext, length);
+  ctx->dataLength += length;
+
+  return true;
+}
+
+/** \brief
+
+	aesGcmDecrypt(ATECCX08A_AES_GCM *ctx, uint8_t *ciphertext, uint8_t *plaintext, size_t length)
+
+	ATECC608A only.
+	Decrypts length bytes and adds the ciphertext to the tag. Can be called as many times as needed.
+	Don't trust the plaintext until aesGcmCheckTag() returns true.
+*/
+
+bool ATECCX08A::aesGcmDecrypt(ATECCX08A_AES_GCM *ctx, uint8_t *ciphertext, uint8_t *plaintext, size_t length)
+{
+  if (ctx->dataLength == 0)
+    aesGcmHashFlush(ctx); // pad out the AAD
+
+  aesGcmHash(ctx, ciphertext, length); // hash first, so ciphertext and plaintext can share a buffer
+  ctx->dataLength += length;
+
+  return aesCtrUpdate(&ctx->ctr, ciphertext, plaintext, length);
+}
+
+/** \brief
+
+	aesGcmFinish(ATECCX08A_AES_GCM *ctx, uint8_t *tag)
+
+	Completes the GHASH with the AAD and data lengths, and writes the 16-byte tag.
+	This is host-side only, nothing is sent to the IC.
+*/
+
+void ATECCX08A::aesGcmFinish(ATECCX08A_AES_GCM *ctx, uint8_t *tag)
+{
+  uint8_t lengthBlock[AES_BLOCK_SIZE] = {0};
+  uint32_t aadBits = ctx->aadLength * 8;
+  uint32_t dataBits = ctx->dataLength * 8;
+
+  aesGcmHashFlush(ctx);
+
+  // [len(A)]64 || [len(C)]64, our lengths are 32 bits so the high words stay zero
+  for (int i = 0; i < 4; i++)
+  {
+    lengthBlock[4 + i] = (uint8_t)(aadBits >> (24 - 8 * i));
+    lengthBlock[12 + i] = (uint8_t)(dataBits >> (24 - 8 * i));
+  }
+  aesGcmHash(ctx, lengthBlock, AES_BLOCK_SIZE);
+
+  for (int i = 0; i < AES_GCM_TAG_SIZE; i++)
+    tag[i] = ctx->ghash[i] ^ ctx->tagMask[i];
+}
+
+/** \brief
+
+	aesGcmCheckTag(ATECCX08A_AES_GCM *ctx, uint8_t *tag, size_t tagLength)
+
+	Completes the tag (see aesGcmFinish()), and compares it to the received tag in constant time.
+	Returns true if the message is authentic.
+*/
+
+bool ATECCX08A::aesGcmCheckTag(ATECCX08A_AES_GCM *ctx, uint8_t *tag, size_t tagLength)
+{
+  uint8_t expected[AES_GCM_TAG_SIZE];
+  uint8_t difference = 0;
+
+  if ((tagLength == 0) || (tagLength > AES_GCM_TAG_SIZE))
+    return fail(ATECC_STATUS_BAD_PARAM);
+
+  aesGcmFinish(ctx, expected);
+
+  for (size_t i = 0; i < tagLength; i++)
+    difference |= expected[i] ^ tag[i];
+
+  if (difference != 0)
+    return fail(ATECC_STATUS_MISCOMPARE);
+
+  return true;
+}
+
+/** \brief
+
+	aesBlockMicros()
+
+	Returns how long the last AES command took (wake + command + execution + response), in microseconds.
+	Returns 0 if no AES command has been sent yet.
+*/
+
+unsigned long ATECCX08A::aesBlockMicros()
+{
+  return _aesBlockMicros;
+}
+
+/** \brief
+
+	aesSoftwareIsFaster(size_t length, unsigned long softwareBlockMicros, unsigned long sessionKeyMicros)
+
+	Helps decide between AES on the IC and AES in software on the host, for a message of length bytes.
+	softwareBlockMicros: your software AES time per 16-byte block.
+	sessionKeyMicros: the one-off cost of getting a session key onto the host (e.g. ecdh() or a key derivation).
+	Uses the measured aesBlockMicros(), or the datasheet execution time if nothing was measured yet.
+	Returns true if deriving a session key and running AES in software would finish sooner.
+*/
+
+bool ATECCX08A::aesSoftwareIsFaster(size_t length, unsigned long softwareBlockMicros, unsigned long sessionKeyMicros)
+{
+  uint64_t blocks = (length + AES_BLOCK_SIZE - 1) / AES_BLOCK_SIZE;
+  uint64_t deviceBlockMicros = _aesBlockMicros ? _aesBlockMicros : (executionTime(COMMAND_OPCODE_AES) * 1000UL); // datasheet max execution time
+
+  return ((sessionKeyMicros + blocks * softwareBlockMicros) < (blocks * deviceBlockMicros));
+}
+
+/** \brief
+
+	checkAesSlot(uint16_t slot)
+
+	Checks the slot's decoded permissions before we spend any time on the bus.
+	Returns false unless the slot holds AES keys (or slot is AES_KEYID_TEMPKEY).
+*/
+
+bool ATECCX08A::checkAesSlot(uint16_t slot)
+{
+  if (!hasFeature(ATECC_FEATURE_AES))
+  {
+    ATECC_LOG_ERROR("AES needs an ATECC608");
+    return fail(ATECC_STATUS_NOT_SUPPORTED);
+  }
+
+  if (slot == AES_KEYID_TEMPKEY)
+    return true;
+
+  if (!slotAllows(slot, SLOT_ALLOW_AES))
+  {
+    ATECC_LOG_ERROR("Slot is not an AES key");
+    return false;
+  }
+
+  return true;
+}
+
+/** \brief
+
+	aesCommand(uint8_t mode, uint16_t slot, uint8_t *input, uint8_t *output)
+
+	Sends a single AES command with a 16-byte input block, and copies the 16-byte result to output.
+	input and output may be the same buffer.
+*/
+
+bool ATECCX08A::aesCommand(uint8_t mode, uint16_t slot, uint8_t *input, uint8_t *output)
+{
+  unsigned long start = micros();
+  bool result;
+
+  beginSession();
+
+  // count + 16_data_bytes + crc[0] + crc[1]
+  result = executeCommand(COMMAND_OPCODE_AES, mode, slot, input, AES_BLOCK_SIZE);
+  if (result)
+    memcpy(output, &inputBuffer[RESPONSE_COUNT_SIZE], AES_BLOCK_SIZE);
+
+  endSession();
+
+  if (!result)
+    return false;
+
+  _aesBlockMicros = micros() - start;
+
+  return true;
+}
+
+/** \brief
+
+	aesEcb(uint8_t mode, uint16_t slot, uint8_t keyBlock, uint8_t *input, uint8_t *output, size_t length)
+
+	Runs one AES command per 16-byte block, in a single wake session.
+*/
+
+bool ATECCX08A::aesEcb(uint8_t mode, uint16_t slot, uint8_t keyBlock, uint8_t *input, uint8_t *output, size_t length)
+{
+  bool result = true;
+
+  if ((length % AES_BLOCK_SIZE) != 0)
+    return fail(ATECC_STATUS_BAD_PARAM);
+
+  if (!checkAesSlot(slot))
+    return false;
+
+  beginSession();
+
+  for (size_t offset = 0; result && (offset < length); offset += AES_BLOCK_SIZE)
+    result = aesCommand(mode | AES_MODE_KEY_BLOCK(keyBlock), slot, &input[offset], &output[offset]);
+
+  endSession();
+
+  return result;
+}
+
+/** \brief
+
+	aesCtrBlocks(ATECCX08A_AES_CTR *ctx, uint8_t *input, uint8_t *output, size_t length)
+
+	XORs length bytes with the CTR keystream, encrypting a new counter block on the IC whenever
+	the current keystream block runs out.
+*/
+
+bool ATECCX08A::aesCtrBlocks(ATECCX08A_AES_CTR *ctx, uint8_t *input, uint8_t *output, size_t length)
+{
+  for (size_t i = 0; i < length; i++)
+  {
+    if (ctx->keystreamUsed == AES_BLOCK_SIZE)
+    {
+      if (!aesCommand(AES_MODE_ENCRYPT | AES_MODE_KEY_BLOCK(ctx->keyBlock), ctx->slot, ctx->counter, ctx->keystream))
+        return false;
+
+      ctx->keystreamUsed = 0;
+
+      // increment the counter (big endian), only within its low counterSize bytes
+      for (int j = AES_BLOCK_SIZE - 1; j >= AES_BLOCK_SIZE - ctx->counterSize; j--)
+      {
+        if (++ctx->counter[j] != 0)
+          break;
+      }
+    }
+
+    output[i] = input[i] ^ ctx->keystream[ctx->keystreamUsed++];
+  }
+
+  return true;
+}
+
+/** \brief
+
+	aesGcmHash(ATECCX08A_AES_GCM *ctx, uint8_t *data, size_t length)
+
+	Adds data to the GHASH, 16 bytes at a time. A trailing partial block is kept
+	in ctx->ghashBlock until more data arrives, or aesGcmHashFlush() pads it out.
+	Each block is multiplied by H in GF(2^128) in software, with no secret-dependent branches.
+*/
+
+void ATECCX08A::aesGcmHash(ATECCX08A_AES_GCM *ctx, uint8_t *data, size_t length)
+{
+  for (size_t i = 0; i < length; i++)
+  {
+    ctx->ghashBlock[ctx->ghashBlockLength++] = data[i];
+
+    if (ctx->ghashBlockLength == AES_BLOCK_SIZE)
+    {
+      uint8_t z[AES_BLOCK_SIZE] = {0};
+      uint8_t v[AES_BLOCK_SIZE];
+
+      for (int j = 0; j < AES_BLOCK_SIZE; j++)
+        ctx->ghash[j] ^= ctx->ghashBlock[j];
+
+      memcpy(v, ctx->h, AES_BLOCK_SIZE);
+
+      for (int bit = 0; bit < 128; bit++)
+      {
+        uint8_t mask = -((ctx->ghash[bit >> 3] >> (7 - (bit & 7))) & 0x01);
+        uint8_t reduce = -(v[AES_BLOCK_SIZE - 1] & 0x01);
+
+        for (int j = 0; j < AES_BLOCK_SIZE; j++)
+          z[j] ^= v[j] & mask;
+
+        for (int j = AES_BLOCK_SIZE - 1; j > 0; j--)
+          v[j] = (v[j] >> 1) | (v[j - 1] << 7);
+        v[0] = (v[0] >> 1) ^ (0xE1 & reduce);
+      }
+
+      memcpy(ctx->ghash, z, AES_BLOCK_SIZE);
+      ctx->ghashBlockLength = 0;
+    }
+  }
+}
+
+/** \brief
+
+	aesGcmHashFlush(ATECCX08A_AES_GCM *ctx)
+
+	Zero-pads and hashes a trailing partial GHASH block, if there is one.
+*/
+
+void ATECCX08A::aesGcmHashFlush(ATECCX08A_AES_GCM *ctx)
+{
+  uint8_t padding[AES_BLOCK_SIZE] = {0};
+
+  if (ctx->ghashBlockLength != 0)
+    aesGcmHash(ctx, padding, AES_BLOCK_SIZE - ctx->ghashBlockLength);
+}
+
+/** \brief
+
+	sha256(uint8_t * plain, size_t len, uint8_t * hash)
+
+	SHA-256 of len bytes on the IC, one 64-byte block per command, all in one wake window.
+	That limits len to about 5 KB at 100kHz (more with setI2CClock()). Longer messages
+	fail with ATECC_STATUS_TOO_LONG before anything is sent, hash those with ATECCX08A_SHA256.
+*/
+
+bool ATECCX08A::sha256(uint8_t * plain, size_t len, uint8_t * hash)
+{
+	bool result;
+	size_t blocks = len / SHA_BLOCK_SIZE; // full blocks, END takes the rest (0-63 bytes)
+	unsigned long plannedMillis = commandMillis(COMMAND_OPCODE_SHA) + blocks * commandMillis(COMMAND_OPCODE_SHA, SHA_BLOCK_SIZE)
+		+ commandMillis(COMMAND_OPCODE_SHA, len % SHA_BLOCK_SIZE) + ((RESPONSE_SHA_SIZE * I2C_BITS_PER_BYTE * 1000UL) / ATECC_WAKE_CLOCK_HZ);
+
+	beginSession(); // all chunks in a single wake
+
+	// The SHA context is lost if the IC sleeps or idles, so the whole hash has to fit in one wake window.
+	// Longer messages fail here, before anything is sent (use ATECCX08A_SHA256 for those).
+	result = checkDeadline(plannedMillis) && reserveWatchdogTime(plannedMillis) && sha256Chunks(plain, len, hash);
+	_shaContext = false;
+
+	endSession();
+
+	return result;
+}
+
+bool ATECCX08A::sha256Chunks(uint8_t * plain, size_t len, uint8_t * hash)
+{
+	size_t blocks = len / SHA_BLOCK_SIZE; // END command can only accept up to 63 bytes, so a multiple of 64 ends with a "blank chunk"
+
+	if (!sha256Begin())
+		return false;
+
+	/* Divide into blocks of 64 bytes per chunk */
+	for (size_t i = 0; i < blocks; ++i)
+	{
+		if (!sha256Update(plain + i * SHA_BLOCK_SIZE))
+			return false;
+	}
+
+	/* Last chunk, there will be a remainder or 0 (and 0 is okay for an end command). Response is the digest. */
+	return sha256End(plain + blocks * SHA_BLOCK_SIZE, len % SHA_BLOCK_SIZE, hash);
+}
+
+/** \brief
+
+	hashStream(Stream &source, size_t len, uint8_t *hash)
+
+	SHA-256 on the IC of the next len bytes from source (e.g. a File on an SD card, or SPI flash
+	behind a Stream), with no buffer for the whole input. Each block is read from source while
+	the IC hashes the previous one, so a hash takes about as long as the slower of the two
+	(the reads, or the SHA commands), not their sum.
+	As with sha256(), the whole hash has to fit in one wake window, reads included: if the window
+	runs out, it fails with ATECC_STATUS_TOO_LONG. Hash longer inputs with ATECCX08A_SHA256.
+	Fails with ATECC_STATUS_SOURCE_ENDED if source gives fewer than len bytes (within its setTimeout()).
+*/
+
+bool ATECCX08A::hashStream(Stream &source, size_t len, uint8_t *hash)
+{
+	bool result;
+	size_t blocks = len / SHA_BLOCK_SIZE; // full blocks, END takes the rest (0-63 bytes)
+	size_t remainder = len % SHA_BLOCK_SIZE;
+	unsigned long endMillis = commandMillis(COMMAND_OPCODE_SHA, remainder) + ((RESPONSE_SHA_SIZE * I2C_BITS_PER_BYTE * 1000UL) / ATECC_WAKE_CLOCK_HZ);
+	unsigned long plannedMillis = commandMillis(COMMAND_OPCODE_SHA) + blocks * commandMillis(COMMAND_OPCODE_SHA, SHA_BLOCK_SIZE) + endMillis;
+	uint8_t block[SHA_BLOCK_SIZE]; // one is enough: a block is copied into the command frame when it is sent
+
+	beginSession(); // all blocks in a single wake
+
+	// the first block is read while the IC runs SHA start
+	result = checkDeadline(plannedMillis) && reserveWatchdogTime(plannedMillis)
+		&& hashStreamStep(SHA_START, NULL, 0, source, block, blocks ? SHA_BLOCK_SIZE : remainder);
+	_shaContext = result; // see reserveWatchdogTime()
+
+	for (size_t i = 0; result && (i < blocks); ++i)
+	{
+		// slow reads use up the wake window, check there is still time for this block and the end
+		if (watchdogRemaining() < (commandMillis(COMMAND_OPCODE_SHA, SHA_BLOCK_SIZE) + endMillis))
+			result = fail(ATECC_STATUS_TOO_LONG);
+		else
+			result = hashStreamStep(SHA_UPDATE, block, SHA_BLOCK_SIZE, source, block, ((i + 1) < blocks) ? SHA_BLOCK_SIZE : remainder);
+	}
+
+	if (result && (watchdogRemaining() < endMillis))
+		result = fail(ATECC_STATUS_TOO_LONG);
+
+	/* Last chunk, 0-63 bytes. Response is the digest. */
+	if (result)
+		result = executeCommand(COMMAND_OPCODE_SHA, SHA_END, remainder, block, remainder, RESPONSE_SHA_SIZE);
+
+	if (result)
+		memcpy(hash, &inputBuffer[RESPONSE_SHA_INDEX], SHA256_SIZE);
+
+	_shaContext = false;
+	endSession();
+
+	return result;
+}
+
+// starts one SHA command with data, reads the next nextLength bytes from source into next while the IC runs it, then finishes it
+bool ATECCX08A::hashStreamStep(uint8_t mode, uint8_t *data, size_t length, Stream &source, uint8_t *next, size_t nextLength)
+{
+	bool readAll;
+
+	if (!startCommand(COMMAND_OPCODE_SHA, mode, length, data, length))
+		return false;
+
+	readAll = (source.readBytes(next, nextLength) == nextLength);
+
+	// If we hear a "0x00", that means it had a successful start or load
+	if (!finishCommand())
+		return false;
+
+	if (!readAll)
+		return fail(ATECC_STATUS_SOURCE_ENDED);
+
+	return true;
+}
+
+/** \brief
+
+	sha256Begin()
+
+	Starts a SHA-256 on the IC, for data that arrives in pieces: sha256Update() for each
+	64-byte block, then sha256End() with the last 0-63 bytes.
+	The SHA context lives in the IC and is lost when it idles or sleeps, so the IC is kept
+	awake (in a session) until sha256End(), or until a step fails. The whole hash has to
+	finish inside one watchdog window (~1.3s): a step that would not fits fails with
+	ATECC_STATUS_TOO_LONG, and the hash has to be started again.
+*/
+
+bool ATECCX08A::sha256Begin()
+{
+	beginSession(); // until sha256End(), or a failed step
+
+	// If we hear a "0x00", that means it had a successful start
+	if (!executeCommand(COMMAND_OPCODE_SHA, SHA_START, 0))
+	{
+		endSession();
+		return false;
+	}
+
+	_shaContext = true; // see reserveWatchdogTime()
+
+	return true;
+}
+
+/** \brief
+
+	sha256Update(const uint8_t *block)
+
+	Hashes the next SHA_BLOCK_SIZE (64) bytes, after sha256Begin().
+	If it fails, the hash is over (the session from sha256Begin() is ended).
+*/
+
+bool ATECCX08A::sha256Update(const uint8_t *block)
+{
+	// If we hear a "0x00", that means it had a successful load
+	if (!executeCommand(COMMAND_OPCODE_SHA, SHA_UPDATE, SHA_BLOCK_SIZE, (uint8_t *)block, SHA_BLOCK_SIZE))
+	{
+		_shaContext = false;
+		endSession();
+		return false;
+	}
+
+	return true;
+}
+
+/** \brief
+
+	sha256End(const uint8_t *data, size_t length, uint8_t *hash)
+
+	Hashes the last length (0 to 63) bytes, and writes the digest (SHA256_SIZE bytes) to hash.
+	Ends the hash started with sha256Begin(), whether it worked or not.
+*/
+
+bool ATECCX08A::sha256End(const uint8_t *data, size_t length, uint8_t *hash)
+{
+	bool result = false;
+
+	if (length < SHA_BLOCK_SIZE)
+		result = executeCommand(COMMAND_OPCODE_SHA, SHA_END, length, (uint8_t *)data, length, RESPONSE_SHA_SIZE);
+	else
+		fail(ATECC_STATUS_BAD_PARAM);
+
+	/* Copy digest */
+	if (result)
+		memcpy(hash, &inputBuffer[RESPONSE_SHA_INDEX], SHA256_SIZE);
+
+	_shaContext = false;
+	endSession(); // the one from sha256Begin()
+
+	return result;
+}
+
+/** \brief
+
+	writeConfigSparkFun()
+
+	Writes the necessary configuration settings to the IC in order to work with the SparkFun Arduino Library examples.
+	For key slots 0 and 1, this enables ECC private key pairs,public key generation, and external signature verifications.
+
+	Returns true if write commands were successful.
+*/
+
+bool ATECCX08A::writeConfigSparkFun()
+{
+  uint8_t config[CONFIG_ZONE_SIZE];
+
+  if (!_configZoneLoaded && !readConfigZone())
+    return false;
+
+  memcpy(config, configZone, CONFIG_ZONE_SIZE);
+
+  // set keytype on slot 0 and 1 to 0x3300
+  // Lockable, ECC, PuInfo set (public key always allowed to be generated), contains a private Key
+  uint8_t data1[] = {0x33, 0x00, 0x33, 0x00}; // 0x3300 sets the keyconfig.keyType, see datasheet pg 20
+  memcpy(&config[CONFIG_ZONE_KEY_CONFIG], data1, sizeof(data1));
+  // set slot config on slot 0 and 1 to 0x8320
+  // EXT signatures, INT signatures, IsSecret, Write config never
+  uint8_t data2[] = {0x83, 0x20, 0x83, 0x20}; // for slot config bit definitions see datasheet pg 20
+  memcpy(&config[CONFIG_ZONE_SLOT_CONFIG], data2, sizeof(data2));
+
+  // only writes the words that are not already set
+  return writeConfig(config);
+}
+
+/** \brief
+
+	sendCommand(uint8_t command_opcode, uint8_t param1, uint16_t param2, uint8_t *data, size_t length_of_data)
+
+	Generic function for sending commands to the IC.
+
+	This function handles creating the "total transmission" to the IC.
+	This contains WORD_ADDRESS_VALUE, COUNT, OPCODE, PARAM1, PARAM2, DATA (optional), and CRCs.
+
+	Note, it calls the "wake()" function, assuming that you have let the IC fall asleep (default 1.7 sec) or idle,
+	unless the IC is still awake from the previous command of a session (see beginSession()).
+
+	Note, for anything other than a command (reset, sleep and idle), you need a different "Word Address Value",
+	So those specific transmissions are handled in unique functions.
+*/
+
+bool ATECCX08A::sendCommand(uint8_t command_opcode, uint8_t param1, uint16_t param2, uint8_t *data, size_t length_of_data)
+{
+  // build packet array (total_transmission) to send a communication to IC, with opcode COMMAND
+  // It expects to see: word address, count, command opcode, param1, param2, data (optional), CRC[0], CRC[1]
+  uint8_t transmission_without_crc_length;
+  uint8_t total_transmission_length;
+  uint8_t total_transmission[UINT8_MAX];
+
+  /* Validate no integer overflow */
+  if (length_of_data > UINT8_MAX - ATRCC508A_PROTOCOL_OVERHEAD)
+    return fail(ATECC_STATUS_BAD_PARAM);
+
+  total_transmission_length = length_of_data + ATRCC508A_PROTOCOL_OVERHEAD;
+
+  total_transmission[ATRCC508A_PROTOCOL_FIELD_COMMAND] = WORD_ADDRESS_VALUE_COMMAND;      // word address value (type command)
+  total_transmission[ATRCC508A_PROTOCOL_FIELD_LENGTH] = total_transmission_length - ATRCC508A_PROTOCOL_FIELD_SIZE_LENGTH;    // count, does not include itself, so "-1"
+  total_transmission[ATRCC508A_PROTOCOL_FIELD_OPCODE] = command_opcode;                   // command
+  total_transmission[ATRCC508A_PROTOCOL_FIELD_PARAM1] = param1;                           // param1
+  memcpy(&total_transmission[ATRCC508A_PROTOCOL_FIELD_PARAM2], &param2, sizeof(param2));  // append param2
+  if (length_of_data)
+    memcpy(&total_transmission[ATRCC508A_PROTOCOL_FIELD_DATA], &data[0], length_of_data); // append data
+
+  // update CRCs, starting at the count (index 1), in place
+  transmission_without_crc_length = total_transmission_length - (ATRCC508A_PROTOCOL_FIELD_SIZE_COMMAND + ATRCC508A_PROTOCOL_FIELD_SIZE_CRC);
+
+  atca_calculate_crc(transmission_without_crc_length, &total_transmission[ATRCC508A_PROTOCOL_FIELD_LENGTH]); // count includes crc[0] and crc[1], so we must subtract 2 before creating crc
+
+  memcpy(&total_transmission[total_transmission_length - ATRCC508A_PROTOCOL_FIELD_SIZE_CRC], crc, ATRCC508A_PROTOCOL_FIELD_SIZE_CRC);  // append crcs
+
+  return sendFrame(total_transmission, total_transmission_length);
+}
+
+/** \brief
+
+	sendFrame(uint8_t *frame, uint8_t length)
+
+	Sends a complete frame (word address, count, opcode, params, data, CRCs) to the IC,
+	waking it first if needed.
+*/
+
+bool ATECCX08A::sendFrame(uint8_t *frame, uint8_t length)
+{
+  ATECC_LOG_HEX_DEBUG("command", frame, length);
+
+  if (_started)
+  {
+    finishStarted(); // the IC is busy with it, see startCommand()
+    endSession();
+  }
+
+  _lastStatus = ATECC_STATUS_SUCCESS;
+
+  if (!keepsTempKey(frame[ATRCC508A_PROTOCOL_FIELD_OPCODE]))
+    _challengePending = false; // TempKey no longer holds the challenge from issueChallenge()
+
+  if (!checkDeadline(commandMillis(frame[ATRCC508A_PROTOCOL_FIELD_OPCODE], length - ATRCC508A_PROTOCOL_OVERHEAD)))
+    return false;
+
+  // Make sure the command finishes before the watchdog puts the IC to sleep (idles it for a fresh window if needed)
+  if (!reserveWatchdogTime(commandMillis(frame[ATRCC508A_PROTOCOL_FIELD_OPCODE], length - ATRCC508A_PROTOCOL_OVERHEAD)))
+    return false;
+
+  if (!_awake && !wakeUp())
+    return fail(ATECC_STATUS_WAKE_FAILED); // fail now, rather than after the execution delay
+
+  if (busWrite(_i2caddr, frame, length) != 0)
+    return fail(ATECC_STATUS_TX_FAILED);
+
+  _commandExecuting = true;
+  _commandSentMicros = micros();
+
+  return true;
+}
+
+/** \brief
+
+	executeCommand(uint8_t command_opcode, uint8_t param1, uint16_t param2, uint8_t *data, size_t length_of_data, uint8_t responseSize, bool debug)
+
+	Runs one complete command: sends it, waits the max execution time for this device variant,
+	reads the response, idles the IC (unless inside a session) and checks count and CRCs.
+	The response data is left at inputBuffer[RESPONSE_COUNT_SIZE].
+
+	responseSize is the number of data bytes expected back. The default (RESPONSE_SIZE_DEFAULT)
+	uses the size from the command table. When the response is a single status byte,
+	it must match the command's success code from the table.
+*/
+
+bool ATECCX08A::executeCommand(uint8_t command_opcode, uint8_t param1, uint16_t param2, uint8_t *data, size_t length_of_data, uint8_t responseSize, bool debug)
+{
+  bool result;
+
+  beginSession(); // callers copying the response out of inputBuffer[] hold their own session around this
+  result = (sendCommand(command_opcode, param1, param2, data, length_of_data) && completeCommand(command_opcode, responseSize, debug));
+  endSession();
+
+  return result;
+}
+
+/** \brief
+
+	executeCommandStatus(uint8_t command_opcode, uint8_t param1, uint16_t param2, uint8_t *data, size_t length_of_data, uint8_t responseSize)
+
+	Same as executeCommand(), but returns why it failed: a status byte from the IC
+	(e.g. ATECC_STATUS_MISCOMPARE, ATECC_STATUS_EXECUTION_ERROR), or a transport failure
+	(e.g. ATECC_STATUS_WAKE_FAILED, ATECC_STATUS_RX_CRC_ERROR). ATECC_STATUS_SUCCESS otherwise.
+*/
+
+ATECCX08A_Status ATECCX08A::executeCommandStatus(uint8_t command_opcode, uint8_t param1, uint16_t param2, uint8_t *data, size_t length_of_data, uint8_t responseSize)
+{
+  if (executeCommand(command_opcode, param1, param2, data, length_of_data, responseSize))
+    return ATECC_STATUS_SUCCESS;
+
+  return _lastStatus;
+}
+
+/** \brief
+
+	startCommand(uint8_t command_opcode, uint8_t param1, uint16_t param2, uint8_t *data, size_t length_of_data, uint8_t responseSize)
+
+	Non-blocking first half of executeCommand(): sends the command and returns right away,
+	while the IC runs it. Call finishCommand() once commandReady() is true, to read the response
+	(into your buffer, see finishCommand()). Finish it well inside the watchdog window (~1.3s),
+	the IC goes to sleep and drops the response after that.
+	The IC stays awake (and the lock, if set, stays held) until finishCommand().
+	Any other call made in the meantime first waits for the started command and finishes it,
+	its response is then lost, and finishCommand() returns false.
+*/
+
+bool ATECCX08A::startCommand(uint8_t command_opcode, uint8_t param1, uint16_t param2, uint8_t *data, size_t length_of_data, uint8_t responseSize)
+{
+  beginSession(); // held until finishCommand()
+
+  if (!sendCommand(command_opcode, param1, param2, data, length_of_data))
+  {
+    endSession();
+    return false;
+  }
+
+  _started = true;
+  _startedOpcode = command_opcode;
+  _startedResponseSize = responseSize;
+  _startedMicros = micros();
+
+  return true;
+}
+
+/** \brief
+
+	commandReady()
+
+	True once the command from startCommand() has had its max execution time,
+	so finishCommand() can read the response without waiting. False if no command was started.
+*/
+
+bool ATECCX08A::commandReady()
+{
+  return _started && ((micros() - _startedMicros) >= (executionTime(_startedOpcode) * 1000UL));
+}
+
+bool ATECCX08A::commandRunning()
+{
+  return _started;
+}
+
+/** \brief
+
+	finishCommand(uint8_t *response, size_t length, bool debug)
+
+	Second half of startCommand(): waits for whatever is left of the execution time,
+	then reads and checks the response, as executeCommand() does.
+	The first length bytes of the response are copied into response before the session
+	from startCommand() ends: once the lock is released, another thread's command can
+	overwrite inputBuffer[].
+	Returns false (ATECC_STATUS_BAD_PARAM) if no command was started, or if another call
+	finished it in the meantime.
+*/
+
+bool ATECCX08A::finishCommand(uint8_t *response, size_t length, bool debug)
+{
+  bool result;
+
+  if (!_started)
+    return fail(ATECC_STATUS_BAD_PARAM);
+
+  result = finishStarted(debug);
+  if (result && (response != NULL))
+    memcpy(response, &inputBuffer[RESPONSE_COUNT_SIZE], length);
+  endSession(); // the one from startCommand()
+
+  return result;
+}
+
+// reads the started command's response, leaves the session from startCommand() open
+bool ATECCX08A::finishStarted(bool debug)
+{
+  unsigned long waitMicros = executionTime(_startedOpcode) * 1000UL;
+  unsigned long elapsedMicros = micros() - _startedMicros;
+
+  _started = false;
+
+  if (elapsedMicros < waitMicros)
+    delay((waitMicros - elapsedMicros + 999) / 1000); // time left for IC to process command and exectute
+
+  return readResponse(_startedOpcode, _startedResponseSize, debug);
+}
+
+/** \brief
+
+	lastStatus()
+
+	Returns the status of the last command, so a caller can see why a method returned false:
+	the IC rejected it (e.g. ATECC_STATUS_EXECUTION_ERROR, slot config does not allow it),
+	a check failed (ATECC_STATUS_MISCOMPARE, signature or MAC does not match),
+	or the bus failed (e.g. ATECC_STATUS_RX_TIMEOUT). See statusRetryable().
+*/
+
+ATECCX08A_Status ATECCX08A::lastStatus()
+{
+  return _lastStatus;
+}
+
+/** \brief
+
+	statusRetryable(ATECCX08A_Status status)
+
+	Returns true for failures that can go away on their own (bus noise, the IC busy or asleep,
+	watchdog, ECC fault), false for those that will fail the same way every time
+	(bad parameters, config or lock state, a signature that does not verify).
+*/
+
+bool ATECCX08A::statusRetryable(ATECCX08A_Status status)
+{
+  switch (status)
+  {
+    case ATECC_STATUS_ECC_FAULT:
+    case ATECC_STATUS_HEALTH_TEST_ERROR:
+    case ATECC_STATUS_AFTER_WAKE:
+    case ATECC_STATUS_WATCHDOG:
+    case ATECC_STATUS_DEVICE_CRC_ERROR:
+    case ATECC_STATUS_WAKE_FAILED:
+    case ATECC_STATUS_TX_FAILED:
+    case ATECC_STATUS_RX_TIMEOUT:
+    case ATECC_STATUS_RX_COUNT_ERROR:
+    case ATECC_STATUS_RX_CRC_ERROR:
+    case ATECC_STATUS_DEADLINE:
+      return true;
+    default:
+      return false;
+  }
+}
+
+/** \brief
+
+	watchdogRemaining()
+
+	Returns how many ms are left before the watchdog puts the IC to sleep (minus a safety margin),
+	or 0 if it is not awake. The watchdog starts at wake, and stops when the IC goes to idle.
+*/
+
+unsigned long ATECCX08A::watchdogRemaining()
+{
+  unsigned long elapsed;
+
+  if (!_awake)
+    return 0;
+
+  elapsed = millis() - _wakeMillis;
+  if (elapsed >= (ATECC_WATCHDOG_TIMEOUT_MS - ATECC_WATCHDOG_MARGIN_MS))
+    return 0;
+
+  return (ATECC_WATCHDOG_TIMEOUT_MS - ATECC_WATCHDOG_MARGIN_MS) - elapsed;
+}
+
+/** \brief
+
+	reserveWatchdogTime(unsigned long ms)
+
+	Makes sure the next ms of commands run in one wake window. Call it at a safe point, before a
+	sequence of commands that depend on each other (e.g. inside a session, before loading TempKey).
+	If the current window is too short, the IC is sent to idle (TempKey and the RNG seed are kept),
+	and the next command wakes it into a fresh window.
+	Returns false (ATECC_STATUS_TOO_LONG) if ms is longer than a whole window, or if a SHA sequence
+	is in progress, since idle would lose the SHA context. Nothing is sent to the IC then.
+*/
+
+bool ATECCX08A::reserveWatchdogTime(unsigned long ms)
+{
+  if (ms > (ATECC_WATCHDOG_TIMEOUT_MS - ATECC_WATCHDOG_MARGIN_MS))
+    return fail(ATECC_STATUS_TOO_LONG); // can never finish in one window
+
+  if (!_awake || (watchdogRemaining() >= ms))
+    return true; // fits, or the next command starts a fresh window anyway
+
+  if (_shaContext)
+    return fail(ATECC_STATUS_TOO_LONG);
+
+  idleMode();
+
+  return true;
+}
+
+/** \brief
+
+	commandMillis(uint8_t command_opcode, size_t length_of_data)
+
+	Estimated time (ms) of one command with length_of_data bytes of data: its max execution time
+	on this variant, plus the I2C time of the command and its response at the data clock.
+*/
+
+unsigned long ATECCX08A::commandMillis(uint8_t command_opcode, size_t length_of_data)
+{
+  CommandDescriptor descriptor;
+  unsigned long clock = _dataClock ? _dataClock : ATECC_WAKE_CLOCK_HZ;
+  unsigned long bytes = ATRCC508A_PROTOCOL_OVERHEAD + length_of_data + RESPONSE_COUNT_SIZE + CRC_SIZE;
+
+  if (findCommandDescriptor(command_opcode, &descriptor))
+    bytes += descriptor.responseSize;
+  else
+    bytes += RESPONSE_SIGNAL_SIZE;
+
+  return executionTime(command_opcode) + ((bytes * I2C_BITS_PER_BYTE * 1000UL) + clock - 1) / clock;
 }
 
 /** \brief
 
-	write(uint8_t zone, uint16_t address, uint8_t *data, uint8_t length_of_data)
-
-    Writes data to a specific zone and address on the IC.
+	setBus(ATECCX08A_Bus *bus)
 
-	For more info on zone and address encoding, see datasheet pg 58.
+	Sends every I2C transaction through bus instead of straight to the TwoWire port,
+	e.g. an ATECCX08A_Trace to record them. Set it while no call is running.
 */
 
-bool ATECCX08A::write(uint8_t zone, uint16_t address, uint8_t *data, uint8_t length_of_data)
+void ATECCX08A::setBus(ATECCX08A_Bus *bus)
 {
-  // adjust zone as needed for whether it's 4 or 32 bytes length write
-  // bit 7 of param1 needs to be set correctly
-  // (0 = 4 Bytes are written)
-  // (1 = 32 Bytes are written)
-  if (length_of_data == 32)
-  {
-	zone |= 0b10000000; // set bit 7
-  }
-  else if (length_of_data == 4)
-  {
-	zone &= ~0b10000000; // clear bit 7
-  }
-  else
-  {
-	return false; // invalid length, abort.
-  }
+  _bus = bus;
+}
 
-  if (!sendCommand(COMMAND_OPCODE_WRITE, zone, address, data, length_of_data))
-    return false;
+static ATECCX08A_Bus directBus; // used when no bus is set
 
-  delay(26); // time for IC to process command and exectute
+uint8_t ATECCX08A::busWrite(uint8_t address, const uint8_t *data, uint8_t length)
+{
+  return (_bus ? _bus : &directBus)->write(_i2cPort, address, data, length);
+}
 
-  // Now let's read back from the IC and see if it reports back good things.
-  countGlobal = 0;
-  if (!receiveResponseData(RESPONSE_COUNT_SIZE + RESPONSE_SIGNAL_SIZE + CRC_SIZE))
-    return false;
+uint8_t ATECCX08A::busRead(uint8_t *data, uint8_t length)
+{
+  return (_bus ? _bus : &directBus)->read(_i2cPort, _i2caddr, data, length);
+}
 
-  idleMode();
+uint8_t ATECCX08A_Bus::write(TwoWire *port, uint8_t address, const uint8_t *data, uint8_t length)
+{
+  port->beginTransmission(address); // set up to write to address
+  if (length)
+    port->write(data, length);
+  return port->endTransmission(); // actually send it
+}
 
-  if (!checkCount() || !checkCrc())
-    return false;
+uint8_t ATECCX08A_Bus::read(TwoWire *port, uint8_t address, uint8_t *data, uint8_t length)
+{
+  uint8_t count = 0;
 
-  // If we hear a "0x00", that means it had a successful write
-  if (inputBuffer[RESPONSE_SIGNAL_INDEX] != ATRCC508A_SUCCESSFUL_WRITE)
-  {
-    return false;
-  }
+  port->requestFrom(address, length); // request bytes from peripheral
 
+  while (port->available() && (count < length)) // peripheral may send less than requested
+    data[count++] = port->read();
 
-  return true;
+  return count;
 }
 
 /** \brief
 
-	createSignature(uint8_t *data, uint16_t slot)
-
-    Creates a 64-byte ECC signature on 32 bytes of data.
-	Defaults to use private key located in slot 0.
-	Your signature will be available at global variable signature[].
+	setDeadline(unsigned long deadlineMicros)
 
-	Note, the IC actually needs you to store your data in a temporary memory location
-	called TempKey. This function first loads TempKey, and then signs TempKey. Then it
-	receives the signature and copies it to signature[].
+	Sets an absolute deadline (in micros()) for every following call, until clearDeadline().
+	Before each command, the library checks that the command (plus a wake, if the IC is not
+	awake) fits before the deadline, using the same max execution and bus times as the
+	watchdog planning. If it does not, the command is not sent: the IC is sent to idle,
+	and the call returns false with ATECC_STATUS_DEADLINE. A command that was started always
+	completes, so a call never runs past the deadline by more than the timing margin.
+	For a deadline in millis(), use setDeadline(micros() + ms * 1000).
 */
 
-bool ATECCX08A::createSignature(uint8_t *data, uint16_t slot)
+void ATECCX08A::setDeadline(unsigned long deadlineMicros)
 {
-  if (!loadTempKey(data) || !signTempKey(slot))
-    return false;
+  _deadlineMicros = deadlineMicros;
+  _deadlineSet = true;
+}
 
-  return true;
+void ATECCX08A::clearDeadline()
+{
+  _deadlineSet = false;
 }
 
 /** \brief
 
-	loadTempKey(uint8_t *data)
-
-	Writes 32 bytes of data to memory location "TempKey" on the IC.
-	Note, the data is provided externally by you, the user, and is included in the
-	command NONCE.
+	cancel()
 
-    We will use the NONCE command in passthrough mode to load tempKey with our data (aka message).
-    Note, the datasheet warns that this does not provide protection agains replay attacks,
-    but we will protect again this because our server (Bob) is going to send us it's own unique random TOKEN,
-    when it requests data, and this will allow us to create a unique data + signature for every communication.
+	Stops the running call at its next command (the command in progress completes first),
+	with ATECC_STATUS_CANCELLED and the IC in idle. Safe to call from another task or an ISR.
+	If no call is running, the next call is stopped before its first command.
 */
 
-bool ATECCX08A::loadTempKey(uint8_t *data)
+void ATECCX08A::cancel()
 {
-  if (!sendCommand(COMMAND_OPCODE_NONCE, NONCE_MODE_PASSTHROUGH, 0x0000, data, 32))
-    return false;
-
-  // note, param2 is 0x0000 (and param1 is PASSTHROUGH), so OutData will be just a single byte of zero upon completion.
-  // see ds pg 77 for more info
+  _cancelled = true;
+}
 
-  delay(7); // time for IC to process command and exectute
+bool ATECCX08A::checkDeadline(unsigned long ms)
+{
+  ATECCX08A_Status status = ATECC_STATUS_SUCCESS;
 
-  // Now let's read back from the IC.
-  if (!receiveResponseData(RESPONSE_COUNT_SIZE + RESPONSE_SIGNAL_SIZE + CRC_SIZE))
-    return false; // responds with "0x00" if NONCE executed properly
+  if (_cancelled)
+  {
+    _cancelled = false;
+    status = ATECC_STATUS_CANCELLED;
+  }
+  else if (_deadlineSet)
+  {
+    unsigned long needed = ms * 1000UL + (_awake ? 0 : ATECC_WAKE_MICROS);
+    long remaining = (long)(_deadlineMicros - micros()); // wrap-safe for deadlines up to ~35 minutes ahead
 
-  idleMode();
+    if ((remaining < 0) || ((unsigned long)remaining < needed))
+      status = ATECC_STATUS_DEADLINE;
+  }
 
-  if (!checkCount() || !checkCrc())
-    return false;
+  if (status == ATECC_STATUS_SUCCESS)
+    return true;
 
-  // If we hear a "0x00", that means it had a successful nonce
-  if (inputBuffer[RESPONSE_SIGNAL_INDEX] != ATRCC508A_SUCCESSFUL_TEMPKEY)
-    return false;
+  if (_awake)
+    idleMode(); // leave the IC in a known state, TempKey is kept
+  _shaContext = false;
 
-  return true;
+  return fail(status);
 }
 
 /** \brief
 
-	signTempKey(uint16_t slot)
+	setPowerPolicy(uint8_t policy, unsigned long sleepAfterMs)
+
+	Sets what the IC does at the end of each call (outside a session):
+	ATECC_POWER_IDLE (default): idle. TempKey and the RNG seed are kept, and the next
+	  wake is quick, but the IC draws the idle current (800uA) until then: the watchdog
+	  does not run in idle, so it never goes to sleep on its own.
+	ATECC_POWER_SLEEP: sleep (150nA). Best for calls far apart, but TempKey is lost between
+	  calls, so anything that keeps state in it (e.g. a challenge from issueChallenge())
+	  must run inside one session.
+	ATECC_POWER_TIMED: idle, and sleep once it has been idle for sleepAfterMs. Call
+	  powerService() from loop() for this: it is where the IC is sent to sleep.
+	Use the powerStats() and energySince() figures to pick one for your workload,
+	see Example20_PowerPolicy.
+*/
 
-	Create a 64 byte ECC signature for the contents of TempKey using the private key in Slot.
-	Default slot is 0
+void ATECCX08A::setPowerPolicy(uint8_t policy, unsigned long sleepAfterMs)
+{
+  _powerPolicy = policy;
+  _sleepAfterMs = sleepAfterMs;
+}
 
-	The response from this command (the signature) is stored in global varaible signature[].
+uint8_t ATECCX08A::powerPolicy()
+{
+  return _powerPolicy;
+}
+
+/** \brief
+
+	powerService()
+
+	With ATECC_POWER_TIMED, sends the IC to sleep once it has been idle for sleepAfterMs.
+	Call it often (e.g. from loop()), it only uses the bus when the IC goes to sleep.
+	Does nothing with the other policies, or while a call, session or started command runs.
 */
 
-bool ATECCX08A::signTempKey(uint16_t slot)
+void ATECCX08A::powerService()
 {
-  if (!sendCommand(COMMAND_OPCODE_SIGN, SIGN_MODE_TEMPKEY, slot))
-    return false;
+  if (_powerPolicy != ATECC_POWER_TIMED)
+    return;
 
-  delay(70); // time for IC to process command and exectute
+  if (_lock)
+    _lock->lock();
 
-  // Now let's read back from the IC.
-  if (!receiveResponseData(RESPONSE_COUNT_SIZE + SIGNATURE_SIZE + CRC_SIZE)) // signature (64), plus crc (2), plus count (1)
-    return false;
+  if ((_powerState == ATECC_STATE_IDLE) && !_started && (_sessionDepth == 0)
+      && ((millis() - _powerEnteredMillis) >= _sleepAfterMs))
+    enterSleep();
 
-  idleMode();
+  if (_lock)
+    _lock->unlock();
+}
 
-  // update signature[] array and print it to serial terminal nicely formatted for easy copy/pasting between sketches
-  if (!checkCount() || !checkCrc())  // check that it was a good message
-    return false;
+uint8_t ATECCX08A::powerState()
+{
+  return _powerState;
+}
 
-   // we don't need the count value (which is currently the first byte of the inputBuffer)
-  for (int i = 0 ; i < SIGNATURE_SIZE ; i++) // for loop through to grab all but the first position (which is "count" of the message)
+/** \brief
+
+	setPowerModel(const ATECCX08A_PowerModel *model)
+
+	Sets the currents (in nA) and the supply voltage used for the energy estimates.
+	The defaults (NULL) are the datasheet figures: 800uA idle, 150nA sleep, and the max
+	active current (14mA) while awake. Measure your own board for better estimates,
+	e.g. the awake current at your I2C clock.
+*/
+
+void ATECCX08A::setPowerModel(const ATECCX08A_PowerModel *model)
+{
+  if (model)
   {
-    signature[i] = inputBuffer[RESPONSE_COUNT_SIZE + i];
+    _powerModel = *model;
   }
-
-  _debugSerial->println();
-  _debugSerial->println("uint8_t signature[64] = {");
-  for (int i = 0; i < sizeof(signature) ; i++)
+  else
   {
-    _debugSerial->print("0x");
-    if ((signature[i] >> 4) == 0) _debugSerial->print("0"); // print preceeding high nibble if it's zero
-    _debugSerial->print(signature[i], HEX);
-    if (i != 63) _debugSerial->print(", ");
-    if ((63-i) % 16 == 0) _debugSerial->println();
+    _powerModel.activeNanoAmps = ATECC_CURRENT_ACTIVE_NA;
+    _powerModel.awakeNanoAmps = ATECC_CURRENT_AWAKE_NA;
+    _powerModel.idleNanoAmps = ATECC_CURRENT_IDLE_NA;
+    _powerModel.sleepNanoAmps = ATECC_CURRENT_SLEEP_NA;
+    _powerModel.milliVolts = ATECC_SUPPLY_MILLIVOLTS;
   }
-  _debugSerial->println("};");
-
-	return true;
 }
 
 /** \brief
 
-	verifySignature(uint8_t *message, uint8_t *signature, uint8_t *publicKey)
-
-	Verifies a ECC signature using the message, signature and external public key.
-	Returns true if successful.
+	powerStats(ATECCX08A_PowerStats *stats)
 
-	Note, it acutally uses loadTempKey, then uses the verify command in "external public key" mode.
+	Copies the time spent in each power state, up to now, since begin() or resetPowerStats().
+	The library tracks the state from its own calls: awake from the wake to the idle or
+	sleep command (and asleep once the watchdog would have put the IC to sleep), and
+	executing from sending each command to reading its response. So activeMicros is the
+	execution time waited for (max times, see commandMillis()), an upper bound.
+	Take a snapshot before a piece of work, and pass it to energySince() afterwards.
 */
 
-bool ATECCX08A::verifySignature(uint8_t *message, uint8_t *signature, uint8_t *publicKey)
+void ATECCX08A::powerStats(ATECCX08A_PowerStats *stats)
 {
-  uint8_t data_sigAndPub[128];
-
-  // first, let's load the message into TempKey on the device, this uses NONCE command in passthrough mode.
-  if (!loadTempKey(message))
-  {
-    _debugSerial->println("Load TempKey Failure");
-    return false;
-  }
+  if (_lock)
+    _lock->lock();
 
-  // We can only send one *single* data array to sendCommand as Param2, so we need to combine signature and public key.
-  memcpy(&data_sigAndPub[0], &signature[0], SIGNATURE_SIZE);	// append signature
-  memcpy(&data_sigAndPub[SIGNATURE_SIZE], &publicKey[0], PUBLIC_KEY_SIZE);	// append external public key
+  powerAccount();
+  *stats = _powerStats;
 
-  if (!sendCommand(COMMAND_OPCODE_VERIFY, VERIFY_MODE_EXTERNAL, VERIFY_PARAM2_KEYTYPE_ECC, data_sigAndPub, sizeof(data_sigAndPub)))
-    return false;
+  if (_lock)
+    _lock->unlock();
+}
 
-  delay(58); // time for IC to process command and exectute
+void ATECCX08A::resetPowerStats()
+{
+  powerAccount();
+  memset(&_powerStats, 0, sizeof(_powerStats));
+  memset(_commandMicros, 0, sizeof(_commandMicros));
+  memset(_commandCounts, 0, sizeof(_commandCounts));
+}
 
-  // Now let's read back from the IC.
-  if (!receiveResponseData(RESPONSE_COUNT_SIZE + RESPONSE_SIGNAL_SIZE + CRC_SIZE))
-    return false;
+/** \brief
 
-  idleMode();
+	energyMicroJoules(const ATECCX08A_PowerStats *stats)
 
-  if (!checkCount() || !checkCrc())
-    return false;
+	Energy estimate, in uJ, for the times in stats, with the power model (see setPowerModel()).
+*/
 
-  // If we hear a "0x00", that means it had a successful verify
-  if (inputBuffer[RESPONSE_SIGNAL_INDEX] != ATRCC508A_SUCCESSFUL_VERIFY)
-    return false;
+float ATECCX08A::energyMicroJoules(const ATECCX08A_PowerStats *stats)
+{
+  uint64_t waiting = (stats->awakeMicros > stats->activeMicros) ? (stats->awakeMicros - stats->activeMicros) : 0;
+  float nanoAmpMicros = (float)stats->activeMicros * _powerModel.activeNanoAmps
+                      + (float)waiting * _powerModel.awakeNanoAmps
+                      + (float)stats->idleMicros * _powerModel.idleNanoAmps
+                      + (float)stats->sleepMicros * _powerModel.sleepNanoAmps;
 
-  return true;
+  return nanoAmpMicros * _powerModel.milliVolts * 1e-12f; // nA * us * mV = 1e-18 J
 }
 
-bool ATECCX08A::sha256(uint8_t * plain, size_t len, uint8_t * hash)
+float ATECCX08A::energySince(const ATECCX08A_PowerStats *before)
 {
-	int i;
-	size_t chunks = len / SHA_BLOCK_SIZE + !!(len % SHA_BLOCK_SIZE);
-  if((len % SHA_BLOCK_SIZE) == 0) chunks += 1; // END command can only accept up to 63 bytes, so we must add a "blank chunk" for the end command
+  ATECCX08A_PowerStats stats;
 
-  // Serial.print("chunks:");
-  // Serial.println(chunks);
+  powerStats(&stats);
+  stats.awakeMicros -= before->awakeMicros;
+  stats.activeMicros -= before->activeMicros;
+  stats.idleMicros -= before->idleMicros;
+  stats.sleepMicros -= before->sleepMicros;
+  stats.wakes -= before->wakes;
+  stats.commands -= before->commands;
 
-	if (!sendCommand(COMMAND_OPCODE_SHA, SHA_START, 0))
-		return false;
+  return energyMicroJoules(&stats);
+}
 
-	/* Divide into blocks of 64 bytes per chunk */
-	for (i = 0; i < chunks; ++i)
-	{
-		size_t data_size = SHA_BLOCK_SIZE;
+unsigned long ATECCX08A::commandCount(uint8_t command_opcode)
+{
+  int8_t index = commandIndex(command_opcode);
 
-		delay(9);
+  return (index < 0) ? 0 : _commandCounts[index];
+}
 
-		if (!receiveResponseData(RESPONSE_COUNT_SIZE + RESPONSE_SIGNAL_SIZE + CRC_SIZE))
-			return false;
+unsigned long ATECCX08A::commandActiveMicros(uint8_t command_opcode)
+{
+  int8_t index = commandIndex(command_opcode);
 
-		idleMode();
+  return (index < 0) ? 0 : _commandMicros[index];
+}
 
-		if (!checkCount() || !checkCrc())
-			return false;
+// adds the time since the last call to the current state
+void ATECCX08A::powerAccount()
+{
+  unsigned long nowMicros = micros();
+  unsigned long nowMillis = millis();
+  unsigned long elapsedMillis = nowMillis - _powerAccountedMillis;
+  uint64_t elapsed;
 
-		// If we hear a "0x00", that means it had a successful load
-		if (inputBuffer[RESPONSE_SIGNAL_INDEX] != ATRCC508A_SUCCESSFUL_SHA)
-			return false;
+  if (elapsedMillis > 60000UL) // micros() wraps every ~71 minutes
+    elapsed = (uint64_t)elapsedMillis * 1000UL;
+  else
+    elapsed = nowMicros - _powerAccountedMicros;
 
-		if (i + 1 == chunks) // if we're on the last chunk, there will be a remainder or 0 (and 0 is okay for an end command)
-			data_size = len % SHA_BLOCK_SIZE;
+  _powerAccountedMicros = nowMicros;
+  _powerAccountedMillis = nowMillis;
+
+  switch (_powerState)
+  {
+    case ATECC_STATE_AWAKE:
+    {
+      // past the watchdog timeout, the IC went to sleep on its own
+      const unsigned long watchdogMicros = ATECC_WATCHDOG_TIMEOUT_MS * 1000UL;
+      uint64_t awake = (_awakeAccounted >= watchdogMicros) ? 0 : (watchdogMicros - _awakeAccounted);
+
+      if (awake > elapsed)
+        awake = elapsed;
+      _awakeAccounted += awake;
+      _powerStats.awakeMicros += awake;
+      _powerStats.sleepMicros += elapsed - awake;
+      break;
+    }
+    case ATECC_STATE_IDLE:
+      _powerStats.idleMicros += elapsed;
+      break;
+    default:
+      _powerStats.sleepMicros += elapsed;
+      break;
+  }
+}
 
-    // Serial.print("chunk:");
-    // Serial.println(i);
-    // Serial.print("data_size:");
-    // Serial.println(data_size);
-    // Serial.print("update vs end:");
-    // Serial.println((i + 1 != chunks) ? SHA_UPDATE : SHA_END);
+void ATECCX08A::powerEnter(uint8_t state)
+{
+  powerAccount();
+  if (state != _powerState)
+    _powerEnteredMillis = millis();
+  _powerState = state;
+}
 
-		/* Send next */
-		if (!sendCommand(COMMAND_OPCODE_SHA, (i + 1 != chunks) ? SHA_UPDATE : SHA_END, data_size, plain + i * SHA_BLOCK_SIZE, data_size))
-			return false;
-	}
+void ATECCX08A::powerDown()
+{
+  if ((_powerPolicy == ATECC_POWER_SLEEP) && _awake)
+    enterSleep();
+  else
+    idleMode();
+}
 
-	/* Read digest */
-	delay(9);
+// sends the IC to sleep: TempKey, the SHA context and the challenge are lost
+bool ATECCX08A::enterSleep()
+{
+  uint8_t wordAddress = WORD_ADDRESS_VALUE_SLEEP; // enter sleep command (aka word address - the first part of every communication to the IC)
 
-	if (!receiveResponseData(RESPONSE_COUNT_SIZE + RESPONSE_SHA_SIZE + CRC_SIZE))
-		return false;
+  if (!_awake)
+  {
+    if (_powerState == ATECC_STATE_SLEEP)
+      return true;
+    if (!wakeUp()) // an idle IC only takes a wake
+      return false;
+  }
 
-	idleMode();
+  _awake = false;
+  _challengePending = false;
+  _shaContext = false;
+  powerEnter(ATECC_STATE_SLEEP);
 
-	if (!checkCount() || !checkCrc())
-		return false;
+  if (busWrite(_i2caddr, &wordAddress, 1) != 0)
+    return fail(ATECC_STATUS_TX_FAILED);
 
-	/* Copy digest */
-	for (i = 0; i < SHA256_SIZE; ++i)
-	{
-		hash[i] = inputBuffer[RESPONSE_SHA_INDEX + i];
-	}
+  return true;
+}
 
-	return true;
+bool ATECCX08A::fail(ATECCX08A_Status status)
+{
+  _lastStatus = status;
+  return false;
 }
-/** \brief
 
-	writeConfigSparkFun()
+/** \brief
 
-	Writes the necessary configuration settings to the IC in order to work with the SparkFun Arduino Library examples.
-	For key slots 0 and 1, this enables ECC private key pairs,public key generation, and external signature verifications.
+	executeConstantCommand(uint8_t frame, uint8_t responseSize, bool debug)
 
-	Returns true if write commands were successful.
+	Same as executeCommand(), for the commands in the constantFrames[] table.
+	These frames (and their CRCs) are built at compile time, so they are just copied out of flash and sent.
 */
 
-bool ATECCX08A::writeConfigSparkFun()
+bool ATECCX08A::executeConstantCommand(uint8_t frame, uint8_t responseSize, bool debug)
 {
-  // keep track of our write command results.
-  bool result1;
-  bool result2;
+  uint8_t total_transmission[CONSTANT_FRAME_SIZE];
+  bool result;
 
-  // set keytype on slot 0 and 1 to 0x3300
-  // Lockable, ECC, PuInfo set (public key always allowed to be generated), contains a private Key
-  uint8_t data1[] = {0x33, 0x00, 0x33, 0x00}; // 0x3300 sets the keyconfig.keyType, see datasheet pg 20
-  result1 = write(ZONE_CONFIG, (96 / 4), data1, 4);
-  // set slot config on slot 0 and 1 to 0x8320
-  // EXT signatures, INT signatures, IsSecret, Write config never
-  uint8_t data2[] = {0x83, 0x20, 0x83, 0x20}; // for slot config bit definitions see datasheet pg 20
-  result2 = write(ZONE_CONFIG, (20 / 4), data2, 4);
+  memcpy_P(total_transmission, constantFrames[frame], CONSTANT_FRAME_SIZE);
 
-  return (result1 && result2);
+  beginSession();
+  result = (sendFrame(total_transmission, CONSTANT_FRAME_SIZE) && completeCommand(total_transmission[ATRCC508A_PROTOCOL_FIELD_OPCODE], responseSize, debug));
+  endSession();
+
+  return result;
 }
 
 /** \brief
 
-	sendCommand(uint8_t command_opcode, uint8_t param1, uint16_t param2, uint8_t *data, size_t length_of_data)
+	completeCommand(uint8_t command_opcode, uint8_t responseSize, bool debug)
 
-	Generic function for sending commands to the IC.
+	Second half of executeCommand(): everything after the command has been sent.
+*/
 
-	This function handles creating the "total transmission" to the IC.
-	This contains WORD_ADDRESS_VALUE, COUNT, OPCODE, PARAM1, PARAM2, DATA (optional), and CRCs.
+bool ATECCX08A::completeCommand(uint8_t command_opcode, uint8_t responseSize, bool debug)
+{
+  delay(executionTime(command_opcode)); // time for IC to process command and exectute
+
+  return readResponse(command_opcode, responseSize, debug);
+}
 
-	Note, it always calls the "wake()" function, assuming that you have let the IC fall asleep (default 1.7 sec)
+/** \brief
 
-	Note, for anything other than a command (reset, sleep and idle), you need a different "Word Address Value",
-	So those specific transmissions are handled in unique functions.
+	readResponse(uint8_t command_opcode, uint8_t responseSize, bool debug)
+
+	Reads and checks the response of a command that has had its execution time.
+	Used by completeCommand() and finishCommand().
 */
 
-bool ATECCX08A::sendCommand(uint8_t command_opcode, uint8_t param1, uint16_t param2, uint8_t *data, size_t length_of_data)
+bool ATECCX08A::readResponse(uint8_t command_opcode, uint8_t responseSize, bool debug)
 {
-  // build packet array (total_transmission) to send a communication to IC, with opcode COMMAND
-  // It expects to see: word address, count, command opcode, param1, param2, data (optional), CRC[0], CRC[1]
-  uint8_t transmission_without_crc_length;
-  uint8_t total_transmission_length;
-  uint8_t total_transmission[UINT8_MAX];
-  uint8_t packet_to_CRC[UINT8_MAX]; // minus word address (1) and crc (2).
+  CommandDescriptor descriptor;
+  uint8_t status;
 
-  /* Validate no integer overflow */
-  if (length_of_data > UINT8_MAX - ATRCC508A_PROTOCOL_OVERHEAD)
+  if (_commandExecuting) // the IC has been busy with it since sendFrame()
+  {
+    unsigned long active = micros() - _commandSentMicros;
+    int8_t index = commandIndex(command_opcode);
+
+    _commandExecuting = false;
+    _powerStats.activeMicros += active;
+    _powerStats.commands++;
+    if (index >= 0)
+    {
+      _commandMicros[index] += active;
+      _commandCounts[index]++;
+    }
+  }
+
+  if (!findCommandDescriptor(command_opcode, &descriptor))
+  {
+    descriptor.time508A = descriptor.time608 = EXECUTION_TIME_DEFAULT;
+    descriptor.responseSize = RESPONSE_SIGNAL_SIZE;
+    descriptor.successCode = 0x00;
+  }
+
+  if (responseSize == RESPONSE_SIZE_DEFAULT)
+    responseSize = descriptor.responseSize;
+
+  // Now let's read back from the IC. (count + data + crc[0] + crc[1])
+  if (!receiveResponseData(RESPONSE_COUNT_SIZE + responseSize + CRC_SIZE, debug))
+  {
+    idleAfterCommand();
     return false;
+  }
 
-  total_transmission_length = length_of_data + ATRCC508A_PROTOCOL_OVERHEAD;
+  idleAfterCommand();
 
-  total_transmission[ATRCC508A_PROTOCOL_FIELD_COMMAND] = WORD_ADDRESS_VALUE_COMMAND;      // word address value (type command)
-  total_transmission[ATRCC508A_PROTOCOL_FIELD_LENGTH] = total_transmission_length - ATRCC508A_PROTOCOL_FIELD_SIZE_LENGTH;    // count, does not include itself, so "-1"
-  total_transmission[ATRCC508A_PROTOCOL_FIELD_OPCODE] = command_opcode;                   // command
-  total_transmission[ATRCC508A_PROTOCOL_FIELD_PARAM1] = param1;                           // param1
-  memcpy(&total_transmission[ATRCC508A_PROTOCOL_FIELD_PARAM2], &param2, sizeof(param2));  // append param2
-  memcpy(&total_transmission[ATRCC508A_PROTOCOL_FIELD_DATA], &data[0], length_of_data);   // append data
+  // On errors, the IC sends a status packet instead of the response. Decode it rather than
+  // reporting a count error, so callers can tell e.g. a bad signature from a dead bus.
+  if ((responseSize != RESPONSE_SIGNAL_SIZE) && (countGlobal >= STATUS_PACKET_SIZE) && (inputBuffer[RESPONSE_COUNT_INDEX] == STATUS_PACKET_SIZE))
+  {
+    countGlobal = STATUS_PACKET_SIZE; // anything after the packet is padding
+    if (!checkCrc(debug))
+      return fail(ATECC_STATUS_RX_CRC_ERROR);
+    return fail(deviceStatus(inputBuffer[RESPONSE_SIGNAL_INDEX]));
+  }
+
+  if (!checkCount(debug))
+    return fail(ATECC_STATUS_RX_COUNT_ERROR);
+  if (!checkCrc(debug))
+    return fail(ATECC_STATUS_RX_CRC_ERROR);
+
+  // Status-only response: check it against the success code
+  status = inputBuffer[RESPONSE_SIGNAL_INDEX];
+  if ((responseSize == RESPONSE_SIGNAL_SIZE) && (status != descriptor.successCode))
+  {
+    ATECC_LOG_ERROR("Command status error");
+    return fail(deviceStatus(status));
+  }
+
+  return true;
+}
 
-  // update CRCs
-  transmission_without_crc_length = total_transmission_length - (ATRCC508A_PROTOCOL_FIELD_SIZE_COMMAND + ATRCC508A_PROTOCOL_FIELD_SIZE_CRC); // copy over just what we need to CRC starting at index 1
+/** \brief
 
-  memcpy(packet_to_CRC, &total_transmission[ATRCC508A_PROTOCOL_FIELD_LENGTH], transmission_without_crc_length);
+	printHexDump(const char *label, const uint8_t *data, size_t length)
 
-  //  _debugSerial->println("packet_to_CRC: ");
-  //  for (int i = 0; i < sizeof(packet_to_CRC) ; i++)
-  //  {
-  //  _debugSerial->print(packet_to_CRC[i], HEX);
-  //  _debugSerial->print(",");
-  //  }
-  //  _debugSerial->println();
+	Prints a labelled array of bytes to the debug port, formatted as a C array
+	(16 bytes per line) for easy copy/pasting between sketches.
+	Each line is built in a small local buffer and sent with a single write(),
+	instead of one print() call per byte.
+*/
 
-  atca_calculate_crc(transmission_without_crc_length, packet_to_CRC); // count includes crc[0] and crc[1], so we must subtract 2 before creating crc
-  //_debugSerial->println(crc[0], HEX);
-  //_debugSerial->println(crc[1], HEX);
+void ATECCX08A::printHexDump(const char *label, const uint8_t *data, size_t length)
+{
+  static const char hexDigits[] = "0123456789ABCDEF";
+  char line[LOG_HEX_BYTES_PER_LINE * 6 + 2]; // "0xAB, " per byte, plus CR LF
+  size_t lineLength = 0;
 
-  memcpy(&total_transmission[total_transmission_length - ATRCC508A_PROTOCOL_FIELD_SIZE_CRC], crc, ATRCC508A_PROTOCOL_FIELD_SIZE_CRC);  // append crcs
+  _debugSerial->print("uint8_t ");
+  _debugSerial->print(label);
+  _debugSerial->print("[");
+  _debugSerial->print((unsigned int)length);
+  _debugSerial->println("] = {");
 
-  wakeUp();
+  for (size_t i = 0; i < length; i++)
+  {
+    line[lineLength++] = '0';
+    line[lineLength++] = 'x';
+    line[lineLength++] = hexDigits[data[i] >> 4];
+    line[lineLength++] = hexDigits[data[i] & 0x0F];
+    if (i != (length - 1))
+    {
+      line[lineLength++] = ',';
+      line[lineLength++] = ' ';
+    }
+
+    if (((i + 1) % LOG_HEX_BYTES_PER_LINE == 0) || (i == (length - 1))) // end of line, send it
+    {
+      line[lineLength++] = '\r';
+      line[lineLength++] = '\n';
+      _debugSerial->write((const uint8_t *)line, lineLength);
+      lineLength = 0;
+    }
+  }
+
+  _debugSerial->println("};");
+}
+
+/** \brief
 
-  _i2cPort->beginTransmission(_i2caddr);
-  _i2cPort->write(total_transmission, total_transmission_length);
-  return (_i2cPort->endTransmission() == 0);
+	printLogLine(const char *message)
+
+	Prints a single log message to the debug port.
+	Called through the ATECC_LOG_* macros, which compile to nothing when their level is disabled.
+*/
+
+void ATECCX08A::printLogLine(const char *message)
+{
+  _debugSerial->print("ATECCX08A: ");
+  _debugSerial->println(message);
 }
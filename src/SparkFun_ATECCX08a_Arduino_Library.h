@@ -34,12 +34,51 @@
 
 #include "Wire.h"
 
+/* Debug logging levels, selected at compile time.
+   Set ATECCX08A_LOG_LEVEL with a build flag (e.g. -DATECCX08A_LOG_LEVEL=3) to enable library logging.
+   Disabled levels compile to nothing, so no command writes to the debug port unless you ask for it. */
+#define ATECCX08A_LOG_LEVEL_NONE  0
+#define ATECCX08A_LOG_LEVEL_ERROR 1
+#define ATECCX08A_LOG_LEVEL_INFO  2
+#define ATECCX08A_LOG_LEVEL_DEBUG 3
+
+#ifndef ATECCX08A_LOG_LEVEL
+#define ATECCX08A_LOG_LEVEL ATECCX08A_LOG_LEVEL_NONE
+#endif
+
+#if (ATECCX08A_LOG_LEVEL >= ATECCX08A_LOG_LEVEL_ERROR)
+#define ATECC_LOG_ERROR(MSG) printLogLine(MSG)
+#else
+#define ATECC_LOG_ERROR(MSG) do {} while (0)
+#endif
+
+#if (ATECCX08A_LOG_LEVEL >= ATECCX08A_LOG_LEVEL_INFO)
+#define ATECC_LOG_INFO(MSG) printLogLine(MSG)
+#else
+#define ATECC_LOG_INFO(MSG) do {} while (0)
+#endif
+
+#if (ATECCX08A_LOG_LEVEL >= ATECCX08A_LOG_LEVEL_DEBUG)
+#define ATECC_LOG_DEBUG(MSG) printLogLine(MSG)
+#define ATECC_LOG_HEX_DEBUG(LABEL, DATA, LENGTH) printHexDump(LABEL, DATA, LENGTH)
+#else
+#define ATECC_LOG_DEBUG(MSG) do {} while (0)
+#define ATECC_LOG_HEX_DEBUG(LABEL, DATA, LENGTH) do {} while (0)
+#endif
+
+#define LOG_HEX_BYTES_PER_LINE 16
+
 /* Protocol + Cryptographic defines */
 #define RESPONSE_COUNT_SIZE  1
 #define RESPONSE_SIGNAL_SIZE 1
 #define RESPONSE_SHA_SIZE    32
 #define RESPONSE_INFO_SIZE   4
 #define RESPONSE_RANDOM_SIZE 32
+#define RESPONSE_ECDH_SIZE   32
+#define RESPONSE_AES_SIZE    16
+#define RESPONSE_MAC_SIZE    32
+#define RESPONSE_COUNTER_SIZE 4
+#define RESPONSE_SIZE_DEFAULT 0xFF // executeCommand(): use the response size from the command table
 #define CRC_SIZE             2
 #define CONFIG_ZONE_SIZE     128
 #define SERIAL_NUMBER_SIZE   10
@@ -48,6 +87,7 @@
 #define SHA256_SIZE          32
 #define PUBLIC_KEY_SIZE      64
 #define SIGNATURE_SIZE       64
+#define SHARED_SECRET_SIZE   32
 #define BUFFER_SIZE          128
 
 #define DATA_ZONE_SLOTS	     16
@@ -60,6 +100,25 @@
 #define NO_MAC(SCONFIG)			(SCONFIG & 0b0000000000010000)
 #define READ_KEY(SCONFIG)		(SCONFIG & 0b0000000000001111)
 
+// Decoded slot permissions, see slotPermissions[] and slotAllows().
+// Built from SlotConfig and KeyConfig whenever the config zone is read, so an operation
+// the slot does not allow fails with ATECC_STATUS_NOT_PERMITTED before anything is sent.
+#define SLOT_ALLOW_READ				0x0001 // clear reads, once the data zone is locked (not secret, not an ECC private key)
+#define SLOT_ALLOW_WRITE			0x0002 // clear writes after the data zone is locked (WriteConfig Always)
+#define SLOT_ALLOW_SIGN				0x0004 // ECC private key, signs external messages (ReadKey bit 0)
+#define SLOT_ALLOW_SIGN_INTERNAL	0x0008 // ECC private key, signs internal messages (ReadKey bit 1)
+#define SLOT_ALLOW_GENKEY			0x0010 // GenKey may create a new private key after the data zone is locked (WriteConfig bit 1)
+#define SLOT_ALLOW_PUBLIC_KEY		0x0020 // GenKey may compute the public key (KeyConfig PubInfo)
+#define SLOT_ALLOW_ECDH				0x0040 // ECDH, shared secret returned (or copied to TempKey)
+#define SLOT_ALLOW_ECDH_SLOT		0x0080 // ECDH, shared secret written into slot|1
+#define SLOT_ALLOW_MAC				0x0100 // MAC and CheckMac with the key in this slot
+#define SLOT_ALLOW_AES				0x0200 // AES keys (ATECC608A)
+#define SLOT_ECC_PUBLIC				0x0800 // holds an ECC public key (KeyType P256, Private = 0)
+#define SLOT_ECC_PRIVATE			0x1000 // holds an ECC private key
+#define SLOT_SECRET					0x2000 // SlotConfig IsSecret
+#define SLOT_LIMITED_USE			0x4000 // SlotConfig LimitedUse
+#define SLOT_LOCKABLE				0x8000 // KeyConfig Lockable
+
 /* Response signals always come after the first count byte */
 #define RESPONSE_COUNT_INDEX 0
 #define RESPONSE_SIGNAL_INDEX RESPONSE_COUNT_SIZE
@@ -84,6 +143,7 @@
 #define ATRCC508A_PROTOCOL_FIELD_SIZE_CRC     CRC_SIZE
 
 /* Protocol overhead at sendCommand(): word address val (1) + count (1) + command opcode (1) param1 (1) + param2 (2) data (0-?) + crc (2) */
+#define CONSTANT_FRAME_SIZE 8 // word address, count, opcode, param1, param2 (2), crc (2), for commands without data
 #define ATRCC508A_PROTOCOL_OVERHEAD (ATRCC508A_PROTOCOL_FIELD_SIZE_COMMAND + ATRCC508A_PROTOCOL_FIELD_SIZE_LENGTH + ATRCC508A_PROTOCOL_FIELD_SIZE_OPCODE + ATRCC508A_PROTOCOL_FIELD_SIZE_PARAM1 + ATRCC508A_PROTOCOL_FIELD_SIZE_PARAM2 + ATRCC508A_PROTOCOL_FIELD_SIZE_CRC)
 
 /* Protocol codes */
@@ -92,8 +152,107 @@
 #define ATRCC508A_SUCCESSFUL_WRITE   0x00
 #define ATRCC508A_SUCCESSFUL_SHA     0x00
 #define ATRCC508A_SUCCESSFUL_LOCK    0x00
+#define ATRCC508A_SUCCESSFUL_ECDH    0x00
+#define ATRCC508A_SUCCESSFUL_NONCE   0x00
 #define ATRCC508A_SUCCESSFUL_WAKEUP  0x11
 #define ATRCC508A_SUCCESSFUL_GETINFO 0x50 /* Revision number */
+#define ATRCC608A_SUCCESSFUL_GETINFO 0x60 /* Revision number, ATECC608A and ATECC608B */
+
+/* Result of the last command, see lastStatus().
+   Status bytes from the IC keep their value (datasheet pg 58), host side failures start at 0xE0. */
+typedef enum {
+	ATECC_STATUS_SUCCESS			= 0x00,
+	ATECC_STATUS_MISCOMPARE			= 0x01, // CheckMac or Verify: MAC or signature does not match
+	ATECC_STATUS_PARSE_ERROR		= 0x03, // illegal opcode, parameter or length, or not allowed by the config
+	ATECC_STATUS_ECC_FAULT			= 0x05, // ECC processing failed, try again
+	ATECC_STATUS_SELFTEST_ERROR		= 0x07, // ATECC608 only
+	ATECC_STATUS_HEALTH_TEST_ERROR	= 0x08, // RNG health test failed
+	ATECC_STATUS_EXECUTION_ERROR	= 0x0F, // command could not run (e.g. zone locked, slot config, key usage)
+	ATECC_STATUS_AFTER_WAKE			= 0x11, // the IC had just woken up, the command was not run
+	ATECC_STATUS_WATCHDOG			= 0xEE, // from the IC: not enough watchdog time left to run the command
+	ATECC_STATUS_DEVICE_CRC_ERROR	= 0xFF, // the IC received a bad CRC or transmission error
+
+	ATECC_STATUS_WAKE_FAILED		= 0xE0, // no (valid) wake response
+	ATECC_STATUS_TX_FAILED			= 0xE1, // the IC did not acknowledge the command
+	ATECC_STATUS_RX_TIMEOUT			= 0xE2, // no response (IC busy, asleep or not connected)
+	ATECC_STATUS_RX_COUNT_ERROR		= 0xE3, // response shorter or longer than its count byte
+	ATECC_STATUS_RX_CRC_ERROR		= 0xE4, // response CRC does not match
+	ATECC_STATUS_BAD_PARAM			= 0xE5, // rejected by the library before anything was sent
+	ATECC_STATUS_NOT_SUPPORTED		= 0xE6, // not available on this device variant
+	ATECC_STATUS_UNKNOWN			= 0xE7, // status byte not listed above
+	ATECC_STATUS_NOT_PERMITTED		= 0xE8, // the slot's config does not allow it, rejected before anything was sent
+	ATECC_STATUS_DEADLINE			= 0xE9, // the next command would not finish before the deadline, see setDeadline()
+	ATECC_STATUS_CANCELLED			= 0xEA, // stopped by cancel()
+	ATECC_STATUS_SOURCE_ENDED		= 0xEB, // the input Stream gave fewer bytes than asked for, see hashStream()
+	ATECC_STATUS_TOO_LONG			= 0xEC, // the sequence does not fit in a wake window, rejected before anything was sent, see reserveWatchdogTime()
+	ATECC_STATUS_CONFIG_UNLOCKED	= 0xED, // the config zone is not locked, so the RNG only gives a fixed test pattern, see randomReady()
+} ATECCX08A_Status;
+
+#define STATUS_PACKET_SIZE (RESPONSE_COUNT_SIZE + RESPONSE_SIGNAL_SIZE + CRC_SIZE) // count, status, crc[0], crc[1]
+
+/* Device variants, see deviceVariant().
+   Define ATECCX08A_DEVICE_VARIANT with a build flag (e.g. -DATECCX08A_DEVICE_VARIANT=2) to pin the variant
+   at compile time. The INFO check at begin() is then skipped, and the timing/feature lookups fold to constants. */
+#define ATECC_VARIANT_UNKNOWN	0 // not detected (yet), worst case timings of all variants are used
+#define ATECC_VARIANT_508A		1
+#define ATECC_VARIANT_608A		2
+#define ATECC_VARIANT_608B		3
+
+#define ATECC608B_MIN_SILICON_REVISION 0x03 // INFO revision byte 3, ATECC608A parts report 0x01 or 0x02
+
+/* Optional features, see hasFeature() */
+#define ATECC_FEATURE_AES			0b00000001 // AES command
+#define ATECC_FEATURE_KDF			0b00000010 // KDF command
+#define ATECC_FEATURE_ECDH_TEMPKEY	0b00000100 // ECDH output to TempKey
+#define ATECC_FEATURES_608			(ATECC_FEATURE_AES | ATECC_FEATURE_KDF | ATECC_FEATURE_ECDH_TEMPKEY)
+
+/* I2C clock, see setI2CClock() */
+#define ATECC_WAKE_CLOCK_HZ		100000UL // the wake pulse (address 0x00) only holds SDA low for tWLO (60 us) at 100kHz or slower
+#define ATECC_MAX_CLOCK_HZ		1000000UL // fastest clock the IC supports for data transfers
+
+/* Watchdog: the IC falls asleep this long after wake (1.3-1.7 sec), losing TempKey */
+#define ATECC_WATCHDOG_TIMEOUT_MS 1300
+#define ATECC_WATCHDOG_MARGIN_MS 20 // wake delay, millis() resolution and polling, not covered by commandMillis()
+#define I2C_BITS_PER_BYTE 9 // 8 data bits + ACK
+#define ATECC_WAKE_MICROS 2000 // wake pulse, tWHI (1500us) and the wake response, see setDeadline()
+
+/* Power policy, see setPowerPolicy(): what the IC does between calls */
+#define ATECC_POWER_IDLE		0 // idle after every call (default): TempKey kept, idle current until the next call
+#define ATECC_POWER_SLEEP		1 // sleep after every call: sleep current, TempKey is lost between calls
+#define ATECC_POWER_TIMED		2 // idle after every call, and sleep once idle for a while (see powerService())
+
+/* Power states, as far as the library knows, see powerState() */
+#define ATECC_STATE_SLEEP		0
+#define ATECC_STATE_IDLE		1
+#define ATECC_STATE_AWAKE		2
+
+/* Default power model, see setPowerModel(). Currents in nA */
+#define ATECC_CURRENT_ACTIVE_NA	14000000UL // executing a command: active current, max (ATECC608 at full clock)
+#define ATECC_CURRENT_AWAKE_NA	14000000UL // awake between commands: no separate datasheet figure, so the active one (an upper bound)
+#define ATECC_CURRENT_IDLE_NA	800000UL // 800uA
+#define ATECC_CURRENT_SLEEP_NA	150UL // 150nA
+#define ATECC_SUPPLY_MILLIVOLTS	3300
+#define ATECC_COMMAND_TYPES		24 // opcodes in the command table, for the per command statistics
+
+/* Signature verification, see setVerifyPolicy() */
+#define VERIFY_POLICY_DEVICE		0 // always on the IC (NONCE + VERIFY)
+#define VERIFY_POLICY_SOFTWARE		1 // always in software on the host (ATECCX08A_P256)
+#define VERIFY_POLICY_AUTO			2 // whichever is expected to finish first
+#define VERIFY_BUS_MICROS			16000UL // I2C time of the NONCE and VERIFY frames at 100kHz, plus wake
+#define VERIFY_BUSY_SOFTWARE_FACTOR	4 // while the IC is busy in a session, prefer software unless it is this many times slower
+
+// Expected software verify time before one has been measured. Define your own to override.
+#if !defined(ATECCX08A_SOFTWARE_VERIFY_MICROS)
+#if defined(__AVR__)
+#define ATECCX08A_SOFTWARE_VERIFY_MICROS 4000000UL
+#elif defined(__SIZEOF_INT128__) // 64-bit hosts
+#define ATECCX08A_SOFTWARE_VERIFY_MICROS 1000UL
+#elif defined(ESP32) || defined(__ARM_ARCH_7EM__) // ESP32, Cortex-M4/M7
+#define ATECCX08A_SOFTWARE_VERIFY_MICROS 40000UL
+#else // Cortex-M0+ and others
+#define ATECCX08A_SOFTWARE_VERIFY_MICROS 400000UL
+#endif
+#endif
 
 /* Receive constants */
 #define ATRCC508A_MAX_REQUEST_SIZE 32
@@ -110,6 +269,9 @@
 #define CONFIG_ZONE_SLOTS_LOCK0   88
 #define CONFIG_ZONE_SLOTS_LOCK1   89
 #define CONFIG_ZONE_KEY_CONFIG	  96
+#define CONFIG_ZONE_WRITABLE_START 16 // bytes 0-15 (serial number, revision number) are read only
+#define CONFIG_ZONE_USER_EXTRA    84 // word 84-87 (UserExtra, Selector, lock bytes) can not be changed by Write
+#define CONFIG_ZONE_BLOCK_WORDS    8 // 4-byte words per 32-byte block
 
 
 #define ATECC508A_ADDRESS_DEFAULT 0x60 //7-bit unshifted default I2C Address
@@ -135,6 +297,20 @@
 #define COMMAND_OPCODE_NONCE 	0x16 //
 #define COMMAND_OPCODE_SIGN 	0x41 // Create an ECC signature with contents of TempKey and designated key slot
 #define COMMAND_OPCODE_VERIFY 	0x45 // takes an ECDSA <R,S> signature and verifies that it is correctly generated from a given message and public key
+#define COMMAND_OPCODE_ECDH 	0x43 // Generates an ECDH pre-master secret from the private key in a slot and an external public key
+#define COMMAND_OPCODE_AES 		0x51 // ATECC608A only: AES-128 encrypts or decrypts one 16-byte block with a key in a slot or TempKey
+#define COMMAND_OPCODE_CHECKMAC 0x28 // Verifies a MAC calculated on another device
+#define COMMAND_OPCODE_COUNTER 	0x24 // Reads or increments one of the monotonic counters
+#define COMMAND_OPCODE_DERIVEKEY 0x1C // Derives a target key value from the target or parent key
+#define COMMAND_OPCODE_GENDIG 	0x15 // Combines a stored value with TempKey using SHA-256
+#define COMMAND_OPCODE_HMAC 	0x11 // ATECC508A only: Computes an HMAC/SHA-256 digest of a key and other information
+#define COMMAND_OPCODE_KDF 		0x56 // ATECC608A only: Key derivation (PRF, HKDF or AES)
+#define COMMAND_OPCODE_MAC 		0x08 // Computes a SHA-256 digest of a key stored in the device, a challenge, and other information
+#define COMMAND_OPCODE_PAUSE 	0x01 // ATECC508A only: Selectively puts just one device on a shared bus into the idle state
+#define COMMAND_OPCODE_PRIVWRITE 0x46 // Writes an ECC private key into a slot in the data zone
+#define COMMAND_OPCODE_SECUREBOOT 0x80 // ATECC608A only: Validates code signature or code digest
+#define COMMAND_OPCODE_SELFTEST 0x77 // ATECC608A only: Runs the internal self tests
+#define COMMAND_OPCODE_UPDATEEXTRA 0x20 // Updates bytes 84 or 85 within the configuration zone after the configuration zone is locked
 
 // Lock command PARAM1 zone options (aka Mode). more info at table on datasheet page 75
 // 		? _ _ _  _ _ _ _ 	Bits 7 verify zone summary, 1 = ignore summary and write to zone!
@@ -151,6 +327,7 @@
 #define LOCK_MODE_ZONE_CONFIG 			0b10000000
 #define LOCK_MODE_ZONE_DATA_AND_OTP 	0b10000001
 #define LOCK_MODE_SLOT0					0b10000010
+#define LOCK_MODE_ZONE_CONFIG_SUMMARY	0b00000000 // config zone, only if param2 matches the CRC of the config zone
 
 #define KEY_CONFIG_OFFSET_X509ID		14
 #define KEY_CONFIG_OFFSET_RFU			13
@@ -163,18 +340,101 @@
 #define KEY_CONFIG_OFFSET_PUB_INFO		1
 #define KEY_CONFIG_OFFSET_PRIVATE		0
 #define KEY_CONFIG_SET(data, config)	((data) << (config))
+#define KEY_CONFIG_KEY_TYPE(KCONFIG)	(((KCONFIG) >> KEY_CONFIG_OFFSET_KEY_TYPE) & 0b111)
+
+#define KEY_TYPE_ECC					4 // P256 NIST ECC key
+#define KEY_TYPE_AES					6 // ATECC608A only: up to four AES-128 keys per slot
+#define KEY_TYPE_SHA					7 // SHA key or other data, e.g. a MAC key
 
 // GenKey command PARAM1 zone options (aka Mode). more info at table on datasheet page 71
 #define GENKEY_MODE_PUBLIC 			0b00000000
 #define GENKEY_MODE_NEW_PRIVATE 	0b00000100
 
 #define NONCE_MODE_PASSTHROUGH		0b00000011 // Operate in pass-through mode and Write TempKey with NumIn. datasheet pg 79
+#define NONCE_MODE_RANDOM			0b00000000 // Combine a new random number with NumIn, TempKey = SHA-256(RandOut, NumIn, 0x16, mode, 0x00). datasheet pg 79
+#define NONCE_NUMIN_SIZE			20 // NumIn size in random mode
+#define NONCE_TEMPKEY_MESSAGE_SIZE	(RESPONSE_RANDOM_SIZE + NONCE_NUMIN_SIZE + 3) // RandOut + NumIn + opcode, mode, LSB of param2
 #define SIGN_MODE_TEMPKEY			0b10000000 // The message to be signed is in TempKey. datasheet pg 85
 #define VERIFY_MODE_EXTERNAL		0b00000010 // Use an external public key for verification, pass to command as data post param2, ds pg 89
 #define VERIFY_MODE_STORED			0b00000000 // Use an internally stored public key for verification, param2 = keyID, ds pg 89
 #define VERIFY_PARAM2_KEYTYPE_ECC 	0x0004 // When verify mode external, param2 should be KeyType, ds pg 89
 #define VERIFY_PARAM2_KEYTYPE_NONECC 	0x0007 // When verify mode external, param2 should be KeyType, ds pg 89
 
+// ECDH command PARAM1 (aka Mode). datasheet pg 68
+#define ECDH_MODE_COMPATIBLE		0b00000000 // Private key from slot, output chosen by SlotConfig.ReadKey (ATECC508A behaviour)
+#define ECDH_MODE_COPY_TEMPKEY		0b00001000 // ATECC608A only: private key from slot, shared secret written to TempKey, nothing returned
+
+// For ECC private key slots, SlotConfig.ReadKey bits control ECDH. datasheet pg 20
+#define ECDH_READKEY_PERMITTED		0b0100 // ECDH operation is permitted for this key
+#define ECDH_READKEY_WRITE_SLOT		0b1000 // shared secret is written into slot N|1 instead of being returned
+
+// AES command PARAM1 (aka Mode). ATECC608A only, datasheet pg 60
+#define AES_MODE_ENCRYPT			0b00000000
+#define AES_MODE_DECRYPT			0b00000001
+#define AES_MODE_KEY_BLOCK(BLOCK)	(((BLOCK) & 0b11) << 6) // which of the four 16-byte keys in the slot to use
+#define AES_KEYID_TEMPKEY			0xFFFF // param2 to use the key in TempKey instead of a slot
+
+#define AES_BLOCK_SIZE				16
+#define AES_GCM_IV_SIZE				12 // recommended IV size, other sizes are hashed into J0
+#define AES_GCM_TAG_SIZE			16
+
+// MAC and CheckMac command PARAM1 (aka Mode). datasheet pg 77 and 64
+#define MAC_MODE_CHALLENGE			0b00000000 // key from slot, challenge from the command data, no OTP or full serial number
+#define CHECKMAC_MODE_CHALLENGE		0b00000000 // key from slot, ClientChal from the command data
+#define MAC_KEY_SIZE				32
+#define MAC_CHALLENGE_SIZE			32
+#define CHECKMAC_OTHER_DATA_SIZE	13 // MAC opcode, mode and param2, plus zeros where the MAC had no OTP or serial number bytes
+#define MAC_MESSAGE_SIZE			88 // key, challenge, opcode, mode, param2, OTP, SN[8], SN[4:7], SN[0:1], SN[2:3]
+#define MAC_SN8						0xEE // serial number bytes always included in the digest, the same on every device
+#define MAC_SN0						0x01
+#define MAC_SN1						0x23
+
+// Slot setup for a MAC key, see macSlotConfig()
+#define SLOT_CONFIG_MAC_KEY			0x8080 // IsSecret, never readable, WriteConfig never (no clear writes after the data zone is locked)
+#define KEY_CONFIG_MAC_KEY			0x003C // Lockable, KeyType SHA
+
+// KDF command PARAM1 (aka Mode). ATECC608A only, datasheet pg 70
+#define KDF_MODE_ALG_PRF			0b00000000 // TLS 1.2 PRF
+#define KDF_MODE_ALG_AES			0b00100000 // AES-ECB of a 16-byte message
+#define KDF_MODE_ALG_HKDF			0b01000000 // HMAC-SHA256(source key, message)
+#define KDF_MODE_SOURCE_TEMPKEY		0b00000000
+#define KDF_MODE_SOURCE_TEMPKEY_UP	0b00000001 // upper 32 bytes of TempKey
+#define KDF_MODE_SOURCE_SLOT		0b00000010 // KeyID bits 0-7
+#define KDF_MODE_SOURCE_ALTKEYBUF	0b00000011
+#define KDF_MODE_TARGET_TEMPKEY		0b00000000
+#define KDF_MODE_TARGET_TEMPKEY_UP	0b00000100
+#define KDF_MODE_TARGET_SLOT		0b00001000 // KeyID bits 8-15
+#define KDF_MODE_TARGET_ALTKEYBUF	0b00001100
+#define KDF_MODE_TARGET_OUTPUT		0b00010000 // returned in the clear
+#define KDF_MODE_TARGET_OUTPUT_ENC	0b00010100 // returned encrypted with the IO protection key, plus a 32-byte nonce
+#define KDF_MODE_TARGET_MASK		0b00011100 // the target field, bits 2-4
+#define KDF_KEY_ID(SOURCE, TARGET)	((uint16_t)(((TARGET) << 8) | ((SOURCE) & 0xFF)))
+#define KDF_DETAILS_SIZE			4 // sent little endian, before the message
+#define KDF_DETAILS_HKDF_MSG_INPUT	0x00000002 // message from the command data
+#define KDF_DETAILS_HKDF_ZERO_KEY	0x00000004 // all-zero key instead of the source (HKDF-Extract without salt)
+#define KDF_DETAILS_PRF_TARGET_LEN_64 0x00000100 // PRF: 64 bytes out instead of 32
+#define KDF_DETAILS_MESSAGE_LENGTH(LENGTH) ((uint32_t)(LENGTH) << 24) // PRF and HKDF, kdf() sets it
+#define KDF_MAX_MESSAGE_SIZE		128
+#define KDF_OUTPUT_SIZE				32
+#define KDF_NONCE_SIZE				32 // OutNonce, with KDF_MODE_TARGET_OUTPUT_ENC
+
+// GenDig and DeriveKey, for key derivation on the ATECC508A. datasheet pg 71 and 66
+#define GENDIG_ZONE_DATA			0x02 // key from a data slot
+#define DERIVEKEY_MODE_INPUT		0b00000100 // must match TempKey.SourceFlag, which NONCE pass-through sets
+
+// Key derivation targets, see deriveKey()
+#define KDF_KEYID_TEMPKEY			0xFFFF // source: the key in TempKey (e.g. from ecdhToTempKey())
+#define KDF_TARGET_SLOT				0 // into targetSlot
+#define KDF_TARGET_TEMPKEY			1 // into TempKey, e.g. for AES with AES_KEYID_TEMPKEY
+#define KDF_TARGET_OUTPUT			2 // returned in the clear, ATECC608A only
+#define KDF_TARGET_ENCRYPTED		3 // returned encrypted with the IO protection key, ATECC608A only
+#define KDF_MAX_INFO_SIZE			(KDF_MAX_MESSAGE_SIZE - 1) // room for the HKDF-Expand block counter
+
+// Challenge-response modes, see issueChallenge()
+#define CHALLENGE_SIZE				32
+#define CHALLENGE_MODE_RANDOM		0 // challenge comes straight from the RNG (RANDOM command)
+#define CHALLENGE_MODE_NONCE		1 // NONCE in random mode, the challenge also stays in TempKey so the IC tracks its freshness
+
 #define ZONE_CONFIG 0x00
 #define ZONE_OTP 0x01
 #define ZONE_DATA 0x02
@@ -189,6 +449,84 @@
 #define ADDRESS_CONFIG_READ_BLOCK_2 0x0010 // 00000000 00010000 // param2 (byte 0), address block bits: _ _ _ 1  0 _ _ _
 #define ADDRESS_CONFIG_READ_BLOCK_3 0x0018 // 00000000 00011000 // param2 (byte 0), address block bits: _ _ _ 1  1 _ _ _
 
+// data zone address (param2): block in bits 8-15, slot in bits 3-6, 4-byte word offset in bits 0-2
+#define DATA_ZONE_ADDRESS(SLOT, BLOCK, WORD) ((uint16_t)(((BLOCK) << 8) | ((SLOT) << 3) | (WORD)))
+#define PUBLIC_KEY_SLOT_SIZE 72 // public keys stored in slots 8-15 are padded: 4 zero bytes before X and before Y
+#define COMPRESSED_CERT_SIZE 72
+
+// Streaming state for AES-CTR, see aesCtrInit()
+typedef struct {
+	uint16_t slot; // key slot (or AES_KEYID_TEMPKEY)
+	uint8_t keyBlock; // which 16-byte key within the slot
+	uint8_t counter[AES_BLOCK_SIZE]; // next counter block to encrypt
+	uint8_t keystream[AES_BLOCK_SIZE];
+	uint8_t keystreamUsed; // bytes of keystream already used
+	uint8_t counterSize; // low bytes of counter[] that increment (16 for CTR, 4 for GCM)
+} ATECCX08A_AES_CTR;
+
+// Streaming state for AES-GCM, see aesGcmInit()
+typedef struct {
+	ATECCX08A_AES_CTR ctr;
+	uint8_t h[AES_BLOCK_SIZE]; // hash subkey, E(K, 0)
+	uint8_t tagMask[AES_BLOCK_SIZE]; // E(K, J0)
+	uint8_t ghash[AES_BLOCK_SIZE];
+	uint8_t ghashBlock[AES_BLOCK_SIZE]; // partial block waiting to be hashed
+	uint8_t ghashBlockLength;
+	uint32_t aadLength;
+	uint32_t dataLength;
+} ATECCX08A_AES_GCM;
+
+// One key derivation, see deriveKey() and deriveKeys()
+typedef struct {
+	uint16_t source; // slot with the master key, or KDF_KEYID_TEMPKEY
+	const uint8_t *info; // what makes this key different from the others, e.g. "session 42, tx"
+	uint8_t infoLength; // up to KDF_MAX_INFO_SIZE
+	uint8_t target; // KDF_TARGET_*
+	uint16_t targetSlot; // KDF_TARGET_SLOT only
+	uint8_t *output; // KDF_OUTPUT_SIZE bytes, KDF_TARGET_OUTPUT and KDF_TARGET_ENCRYPTED only
+	uint8_t *nonce; // KDF_NONCE_SIZE bytes, KDF_TARGET_ENCRYPTED only, needed to decrypt the output
+} ATECCX08A_KeyDerivation;
+
+// Currents and supply voltage for energy estimates, see setPowerModel()
+typedef struct {
+	uint32_t activeNanoAmps; // executing a command
+	uint32_t awakeNanoAmps; // awake, between commands (bus transfers, waiting for the host)
+	uint32_t idleNanoAmps;
+	uint32_t sleepNanoAmps;
+	uint16_t milliVolts;
+} ATECCX08A_PowerModel;
+
+// Time spent in each power state, see powerStats()
+typedef struct {
+	uint64_t awakeMicros; // awake, including activeMicros and the wake delays
+	uint64_t activeMicros; // executing commands (the execution time waited for, see commandMillis())
+	uint64_t idleMicros;
+	uint64_t sleepMicros;
+	uint32_t wakes;
+	uint32_t commands;
+} ATECCX08A_PowerStats;
+
+/* Lock shared by every task or thread that uses one ATECCX08A, see setLock().
+   Each library call holds it from the first command to the last copy out of the shared buffers,
+   and calls nest (a session holds it across several calls), so the lock must be recursive.
+   This base class does nothing. SparkFun_ATECCX08a_Concurrency.h has FreeRTOS and std:: locks. */
+class ATECCX08A_Lock {
+  public:
+	virtual ~ATECCX08A_Lock() {}
+	virtual void lock() {}
+	virtual void unlock() {}
+};
+
+/* I2C hook, see setBus(). Every bus transaction of the library goes through it:
+   wake, idle, sleep, commands and responses. This base class talks to the TwoWire port.
+   SparkFun_ATECCX08a_Trace.h records the transactions, and replays recorded ones. */
+class ATECCX08A_Bus {
+  public:
+	virtual ~ATECCX08A_Bus() {}
+	virtual uint8_t write(TwoWire *port, uint8_t address, const uint8_t *data, uint8_t length); // returns endTransmission()
+	virtual uint8_t read(TwoWire *port, uint8_t address, uint8_t *data, uint8_t length); // returns the bytes read (up to length)
+};
+
 class ATECCX08A {
   public:
 
@@ -208,6 +546,7 @@ class ATECCX08A {
 	bool slot0LockStatus; // pulled from configZone[88], then set according to slot (bit 0) status
 	uint16_t SlotConfig[DATA_ZONE_SLOTS];
 	uint16_t KeyConfig[DATA_ZONE_SLOTS];
+	uint16_t slotPermissions[DATA_ZONE_SLOTS]; // SLOT_ALLOW_* (and SLOT_*) bits decoded from SlotConfig and KeyConfig
 
 	byte publicKey64Bytes[PUBLIC_KEY_SIZE]; // used to store the public key returned when you (1) create a keypair, or (2) read a public key
 	uint8_t signature[SIGNATURE_SIZE];
@@ -220,9 +559,16 @@ class ATECCX08A {
 
 	bool wakeUp();
 	bool idleMode();
-	bool getInfo();
+	bool getInfo(); // also detects the device variant and silicon revision
+	uint8_t deviceVariant(); // ATECC_VARIANT_508A, ATECC_VARIANT_608A, ATECC_VARIANT_608B or ATECC_VARIANT_UNKNOWN
+	uint8_t siliconRevision(); // from the INFO command (0 if not detected)
+	bool hasFeature(uint8_t feature); // true if the detected variant supports feature (also true while the variant is unknown)
+	uint8_t executionTime(uint8_t command_opcode); // max execution time (ms) of a command on this variant
 	bool writeConfigSparkFun();
+	bool writeConfig(const uint8_t *config); // full 128-byte image, writes only the words that differ from configZone[]
+	bool provisionConfig(const uint8_t *config); // writeConfig(), then lockConfigChecked()
 	bool lockConfig(); // note, this PERMINANTLY disables changes to config zone - including changing the I2C address!
+	bool lockConfigChecked(); // same, but only locks if the device config zone matches configZone[]
 	bool lockDataAndOTP();
 	bool lockDataSlot0();
 	bool lock(uint8_t zone);
@@ -230,7 +576,8 @@ class ATECCX08A {
 
 	// Random array and fuctions
 	byte random32Bytes[32]; // used to store the complete data return (32 bytes) when we ask for a random number from chip.
-	bool updateRandom32Bytes(bool debug = false);
+	bool updateRandom32Bytes(bool debug = false, uint8_t *randomOut = NULL); // also copies the 32 bytes to randomOut
+	bool randomReady(); // false (ATECC_STATUS_CONFIG_UNLOCKED) while RANDOM only gives the test pattern
 	byte getRandomByte(bool debug = false);
 	int getRandomInt(bool debug = false);
 	long getRandomLong(bool debug = false);
@@ -239,34 +586,250 @@ class ATECCX08A {
 
 	// SHA256
 	bool sha256(uint8_t * data, size_t len, uint8_t * hash);
+	bool sha256Begin(); // in steps, in one wake: begin, a 64-byte block per update, 0-63 bytes at the end
+	bool sha256Update(const uint8_t *block);
+	bool sha256End(const uint8_t *data, size_t length, uint8_t *hash);
+	bool hashStream(Stream &source, size_t len, uint8_t *hash); // reads each block from source while the IC hashes the one before
 
 	uint8_t crc[CRC_SIZE] = {0, 0};
 	void atca_calculate_crc(uint8_t length, uint8_t *data);
 
 	// Key functions
-	bool createNewKeyPair(uint16_t slot = 0x0000);
-	bool generatePublicKey(uint16_t slot = 0x0000, bool debug = true);
+	// publicKeyOut/signatureOut: optional per-call copy of the result, safe when other tasks use the IC (see setLock())
+	bool createNewKeyPair(uint16_t slot = 0x0000, uint8_t *publicKeyOut = NULL);
+	bool generatePublicKey(uint16_t slot = 0x0000, bool debug = false, uint8_t *publicKeyOut = NULL);
+	bool readPublicKey(uint16_t slot, uint8_t *publicKeyOut = NULL); // stored (padded) public key, e.g. a signer's, into publicKey64Bytes[]
 
-	bool createSignature(uint8_t *data, uint16_t slot = 0x0000);
+	// data slot storage (length is a multiple of 4)
+	bool readSlot(uint16_t slot, uint8_t *data, uint16_t length);
+	bool writeSlot(uint16_t slot, uint8_t *data, uint16_t length);
+
+	// compressed certificates (see SparkFun_ATECCX08a_Cert.h to rebuild them)
+	bool readCompressedCert(uint16_t slot, uint8_t *compressed);
+	bool writeCompressedCert(uint16_t slot, uint8_t *compressed);
+
+	bool createSignature(uint8_t *data, uint16_t slot = 0x0000, uint8_t *signatureOut = NULL);
 	bool loadTempKey(uint8_t *data);  // load 32 bytes of data into tempKey (a temporary memory spot in the IC)
-	bool signTempKey(uint16_t slot = 0x0000); // create signature using contents of TempKey and PRIVATE KEY in slot
-	bool verifySignature(uint8_t *message, uint8_t *signature, uint8_t *publicKey); // external ECC publicKey only
+	bool signTempKey(uint16_t slot = 0x0000, uint8_t *signatureOut = NULL); // create signature using contents of TempKey and PRIVATE KEY in slot
+	bool verifySignature(uint8_t *message, uint8_t *signature, uint8_t *publicKey); // external ECC publicKey only, on the IC or in software (see setVerifyPolicy())
+	bool verifySignatureDevice(uint8_t *message, uint8_t *signature, uint8_t *publicKey); // always on the IC
+	bool verifySignatureSoftware(uint8_t *message, uint8_t *signature, uint8_t *publicKey); // always in software
+	bool verifySignatureStored(uint8_t *message, uint8_t *signature, uint16_t slot); // on the IC, with the public key stored in slot
+	void setVerifyPolicy(uint8_t policy); // VERIFY_POLICY_DEVICE, VERIFY_POLICY_SOFTWARE or VERIFY_POLICY_AUTO (default)
+	bool softwareVerifyPreferred();
+
+	// ECDH key agreement, using the private key in slot and the peer's 64-byte public key (X,Y)
+	bool ecdh(uint16_t slot, uint8_t *publicKey, uint8_t *sharedSecret); // shared secret (32 bytes) returned in the clear
+	bool ecdhToSlot(uint16_t slot, uint8_t *publicKey); // shared secret written into slot|1, never crosses the bus
+	bool ecdhToTempKey(uint16_t slot, uint8_t *publicKey); // ATECC608A only: shared secret written into TempKey
+
+	// AES-128 (ATECC608A only). The key never leaves the slot, keyBlock selects one of the four keys in the slot.
+	// Multi-block calls run in a single wake session.
+	bool aesEncrypt(uint16_t slot, uint8_t keyBlock, uint8_t *plaintext, uint8_t *ciphertext); // one 16-byte block
+	bool aesDecrypt(uint16_t slot, uint8_t keyBlock, uint8_t *ciphertext, uint8_t *plaintext); // one 16-byte block
+	bool aesEcbEncrypt(uint16_t slot, uint8_t keyBlock, uint8_t *plaintext, uint8_t *ciphertext, size_t length); // length multiple of 16
+	bool aesEcbDecrypt(uint16_t slot, uint8_t keyBlock, uint8_t *ciphertext, uint8_t *plaintext, size_t length); // length multiple of 16
+	bool aesCtrInit(ATECCX08A_AES_CTR *ctx, uint16_t slot, uint8_t keyBlock, uint8_t *counter);
+	bool aesCtrUpdate(ATECCX08A_AES_CTR *ctx, uint8_t *input, uint8_t *output, size_t length); // encrypts and decrypts
+	bool aesGcmInit(ATECCX08A_AES_GCM *ctx, uint16_t slot, uint8_t keyBlock, uint8_t *iv, size_t ivLength = AES_GCM_IV_SIZE);
+	bool aesGcmAad(ATECCX08A_AES_GCM *ctx, uint8_t *aad, size_t length); // all AAD must come before any data
+	bool aesGcmEncrypt(ATECCX08A_AES_GCM *ctx, uint8_t *plaintext, uint8_t *ciphertext, size_t length);
+	bool aesGcmDecrypt(ATECCX08A_AES_GCM *ctx, uint8_t *ciphertext, uint8_t *plaintext, size_t length);
+	void aesGcmFinish(ATECCX08A_AES_GCM *ctx, uint8_t *tag); // tag is AES_GCM_TAG_SIZE bytes
+	bool aesGcmCheckTag(ATECCX08A_AES_GCM *ctx, uint8_t *tag, size_t tagLength = AES_GCM_TAG_SIZE);
+
+	// AES throughput
+	unsigned long aesBlockMicros(); // measured time per block of the last AES command (0 = not measured yet)
+	bool aesSoftwareIsFaster(size_t length, unsigned long softwareBlockMicros, unsigned long sessionKeyMicros);
+
+	// Challenge-response authentication, each call runs in a single wake session
+	bool issueChallenge(uint8_t *challenge, uint8_t mode = CHALLENGE_MODE_RANDOM); // verifier: create a 32 byte challenge
+	bool respondToChallenge(uint8_t *challenge, uint16_t slot = 0x0000, uint8_t *signatureOut = NULL); // prover: sign the challenge, signature available at signature[]
+	bool checkResponse(uint8_t *challenge, uint8_t *signature, uint8_t *publicKey); // verifier: verify the prover's signature
+
+	// Symmetric challenge-response (MAC / CheckMac): a few ms on the IC instead of ~130 ms for SIGN + VERIFY.
+	// Both sides hold the same 32-byte key in the same slot.
+	bool mac(uint16_t slot, uint8_t *challenge, uint8_t *digest); // prover: 32-byte digest of key and challenge
+	bool checkMac(uint16_t slot, uint8_t *challenge, uint8_t *digest); // verifier: true only if digest matches
+	bool writeMacKey(uint16_t slot, uint8_t *key); // while the data zone is unlocked
+	static void macSlotConfig(uint8_t *config, uint8_t slot); // sets up a MAC key slot in a config image, for writeConfig()/provisionConfig()
+	static void calculateMac(const uint8_t *key, const uint8_t *challenge, uint16_t slot, uint8_t *digest); // same digest as mac(), in software
+
+	// Key derivation on the IC: session keys from a master key (or a shared secret in TempKey)
+	// that never crosses the bus. KDF command on the ATECC608A, GenDig/DeriveKey on the ATECC508A.
+	bool kdf(uint8_t mode, uint16_t keyId, uint32_t details, const uint8_t *message, uint8_t messageLength, uint8_t *output = NULL, uint8_t *outputNonce = NULL); // ATECC608A only, the raw command
+	bool deriveKey(ATECCX08A_KeyDerivation *derivation);
+	bool deriveKeys(ATECCX08A_KeyDerivation *derivations, uint8_t count); // all in a single wake session
+	static void calculateDerivedKey(const uint8_t *key, const uint8_t *info, uint8_t infoLength, uint8_t *derived); // the ATECC608A's deriveKey(), in software
+	static void decryptKdfOutput(const uint8_t *ioKey, const uint8_t *nonce, uint8_t *data, size_t length); // KDF_TARGET_ENCRYPTED output, in place
+
+	// Keep the IC awake across several commands (TempKey is retained, no wake/idle between commands).
+	// Sessions nest, and the IC is sent to idle by the outermost endSession().
+	// With a lock set, a session also keeps other tasks off the IC until it ends.
+	void beginSession();
+	void endSession();
+
+	// I2C speed on this IC's port: data transfers at dataClock (up to ATECC_MAX_CLOCK_HZ), the wake pulse at ATECC_WAKE_CLOCK_HZ.
+	// busClock (what other devices on the port use) is restored after each call or session, 0 = stay at dataClock.
+	// By default the clock is never changed, and the port must run at 100kHz or slower.
+	void setI2CClock(uint32_t dataClock, uint32_t busClock = 0); // after begin()
+
+	// Watchdog planning. Every command is checked against the time left since wake: if it does not fit,
+	// the IC is idled first (TempKey is kept) and the command runs in a fresh wake window, unless
+	// that would lose state a sequence depends on (the SHA context), then it fails with ATECC_STATUS_TOO_LONG.
+	unsigned long watchdogRemaining(); // ms left in the current wake window (0 = not awake)
+	bool reserveWatchdogTime(unsigned long ms); // for your own sequences, call before the first command
+	unsigned long commandMillis(uint8_t command_opcode, size_t length_of_data = 0); // estimated execution + bus time
+
+	// Bounded latency. With a deadline set, every command is checked before it is sent: one that would not
+	// finish in time (wake, execution and bus time) is not started. The call fails with ATECC_STATUS_DEADLINE,
+	// and the IC is left idle. cancel() (from another task or an ISR) stops the running call the same way,
+	// at its next command, with ATECC_STATUS_CANCELLED. A cancel() while no call runs stops the next call.
+	void setDeadline(unsigned long deadlineMicros); // absolute micros(), applies to every call until clearDeadline()
+	void clearDeadline();
+	void cancel();
+
+	// Sharing one IC between tasks/threads: every call (and every session) runs under this lock.
+	// Set it once, before other tasks start using the IC. NULL (default) = no locking.
+	void setLock(ATECCX08A_Lock *lock);
+
+	void setBus(ATECCX08A_Bus *bus); // NULL (default) = straight to the TwoWire port
+
+	// Power accounting: time awake, executing, idle and asleep, and per command, with energy estimates
+	// from a power model. The policy decides what the IC does between calls (ATECC_POWER_*).
+	void setPowerPolicy(uint8_t policy, unsigned long sleepAfterMs = 0); // sleepAfterMs for ATECC_POWER_TIMED
+	uint8_t powerPolicy();
+	void powerService(); // ATECC_POWER_TIMED: call from loop(), sleeps the IC once it has been idle for sleepAfterMs
+	uint8_t powerState(); // ATECC_STATE_*
+	void setPowerModel(const ATECCX08A_PowerModel *model); // NULL = the ATECC_CURRENT_* defaults
+	void powerStats(ATECCX08A_PowerStats *stats); // totals up to now, since begin() or resetPowerStats()
+	void resetPowerStats();
+	float energyMicroJoules(const ATECCX08A_PowerStats *stats); // estimate for a powerStats() total
+	float energySince(const ATECCX08A_PowerStats *before); // estimate from a powerStats() snapshot to now
+	unsigned long commandCount(uint8_t command_opcode);
+	unsigned long commandActiveMicros(uint8_t command_opcode); // total execution time of this command
 
 	bool read(uint8_t zone, uint16_t address, uint8_t length, bool debug = false);
 	bool read_output(uint8_t zone, uint16_t address, uint8_t length, uint8_t * output, bool debug = false);
 	bool write(uint8_t zone, uint16_t address, uint8_t *data, uint8_t length_of_data);
 
-	bool readConfigZone(bool debug = true);
+	bool readConfigZone(bool debug = false);
+	bool slotAllows(uint16_t slot, uint16_t permissions); // all of the SLOT_ALLOW_* bits, no bus traffic once the config zone is read
+	void printSlotPermissions(); // audit: one line per slot on the debug port
 	bool sendCommand(uint8_t command_opcode, uint8_t param1, uint16_t param2, uint8_t *data = NULL, size_t length_of_data = 0);
 
+	// send a command, wait for it, read and check the response (data available at inputBuffer[RESPONSE_COUNT_SIZE])
+	bool executeCommand(uint8_t command_opcode, uint8_t param1, uint16_t param2, uint8_t *data = NULL, size_t length_of_data = 0, uint8_t responseSize = RESPONSE_SIZE_DEFAULT, bool debug = false);
+	ATECCX08A_Status executeCommandStatus(uint8_t command_opcode, uint8_t param1, uint16_t param2, uint8_t *data = NULL, size_t length_of_data = 0, uint8_t responseSize = RESPONSE_SIZE_DEFAULT);
+
+	// Non-blocking: start a command, do other work while the IC runs it, then read its response
+	bool startCommand(uint8_t command_opcode, uint8_t param1, uint16_t param2, uint8_t *data = NULL, size_t length_of_data = 0, uint8_t responseSize = RESPONSE_SIZE_DEFAULT);
+	bool commandReady(); // execution time is over, finishCommand() will not wait
+	bool commandRunning(); // started and not finished yet
+	bool finishCommand(uint8_t *response = NULL, size_t length = 0, bool debug = false); // response copied while the IC is still held
+
+	// Why the last call returned false (every bool method sets it)
+	ATECCX08A_Status lastStatus();
+	static bool statusRetryable(ATECCX08A_Status status); // true if the same call may succeed when repeated
+
+	// Debug output helpers (buffered, one write() per line)
+	void printHexDump(const char *label, const uint8_t *data, size_t length);
+	void printLogLine(const char *message);
+
   private:
 
 	TwoWire *_i2cPort;
+	ATECCX08A_Bus *_bus = NULL; // see setBus()
+	uint8_t busWrite(uint8_t address, const uint8_t *data, uint8_t length);
+	uint8_t busRead(uint8_t *data, uint8_t length);
 
 	uint8_t _i2caddr;
 
 	Stream *_debugSerial; //The generic connection to user's chosen serial hardware
 
+	bool _configZoneLoaded = false; // set once readConfigZone() has filled SlotConfig[] and KeyConfig[]
+
+	uint8_t _variant = ATECC_VARIANT_UNKNOWN; // see deviceVariant()
+	uint8_t _siliconRevision = 0;
+	void setVariant(uint8_t revision, uint8_t siliconRevision);
+
+	void parseConfigZone();
+	static uint16_t decodeSlotPermissions(uint16_t slot, uint16_t slotConfig, uint16_t keyConfig);
+	bool configWordWritable(uint8_t word);
+	bool configBlockWritable(uint8_t block);
+
+	bool executeConstantCommand(uint8_t frame, uint8_t responseSize = RESPONSE_SIZE_DEFAULT, bool debug = false);
+	bool completeCommand(uint8_t command_opcode, uint8_t responseSize, bool debug);
+	bool readResponse(uint8_t command_opcode, uint8_t responseSize, bool debug);
+
+	bool _started = false; // see startCommand()
+	uint8_t _startedOpcode = 0;
+	uint8_t _startedResponseSize = RESPONSE_SIZE_DEFAULT;
+	unsigned long _startedMicros = 0;
+	bool finishStarted(bool debug = false);
+	bool sendFrame(uint8_t *frame, uint8_t length);
+	bool _shaContext = false; // between SHA start and end, the context does not survive idle or sleep
+
+	ATECCX08A_Status _lastStatus = ATECC_STATUS_SUCCESS; // see lastStatus()
+	bool fail(ATECCX08A_Status status); // records status, returns false
+
+	bool _awake = false; // set by a successful wakeUp(), cleared by idleMode() and sleep()
+	bool _deadlineSet = false; // see setDeadline()
+	unsigned long _deadlineMicros = 0;
+	volatile bool _cancelled = false; // see cancel()
+	bool checkDeadline(unsigned long ms); // before each command: ms of work left to start, false if it does not fit
+	unsigned long _wakeMillis = 0; // millis() at the last successful wakeUp(), used to stay ahead of the watchdog
+	uint8_t _sessionDepth = 0; // see beginSession()
+	ATECCX08A_Lock *_lock = NULL; // see setLock()
+
+	uint32_t _dataClock = 0; // see setI2CClock(), 0 = leave the port clock alone
+	uint32_t _busClock = 0;
+	uint32_t _portClock = 0; // last clock set on the port, 0 = unknown
+	void applyClock(uint32_t clock);
+	void idleAfterCommand(); // idles (or sleeps, see setPowerPolicy()) the IC, unless we are inside a session
+
+	uint8_t _powerPolicy = ATECC_POWER_IDLE; // see setPowerPolicy()
+	unsigned long _sleepAfterMs = 0;
+	ATECCX08A_PowerModel _powerModel = { ATECC_CURRENT_ACTIVE_NA, ATECC_CURRENT_AWAKE_NA, ATECC_CURRENT_IDLE_NA, ATECC_CURRENT_SLEEP_NA, ATECC_SUPPLY_MILLIVOLTS };
+	ATECCX08A_PowerStats _powerStats = { 0, 0, 0, 0, 0, 0 };
+	uint8_t _powerState = ATECC_STATE_SLEEP;
+	unsigned long _powerEnteredMillis = 0; // millis() when _powerState was entered, see powerService()
+	unsigned long _powerAccountedMicros = 0; // micros() and millis() up to which _powerStats is counted
+	unsigned long _powerAccountedMillis = 0;
+	unsigned long _awakeAccounted = 0; // awake micros accounted since the last wake, the watchdog sleeps the IC after ATECC_WATCHDOG_TIMEOUT_MS
+	bool _commandExecuting = false; // sent, response not read yet
+	unsigned long _commandSentMicros = 0;
+	uint32_t _commandMicros[ATECC_COMMAND_TYPES]; // per command, see commandActiveMicros()
+	uint32_t _commandCounts[ATECC_COMMAND_TYPES];
+	void powerEnter(uint8_t state); // accounts the time in the state we leave
+	void powerAccount();
+	void powerDown(); // end of a call: idle or sleep, per the policy
+	bool enterSleep();
+
+	bool _challengePending = false; // set by issueChallenge(CHALLENGE_MODE_NONCE), the challenge is still in TempKey
+	uint8_t _challengeDigest[CHALLENGE_SIZE];
+	bool verifyTempKey(uint8_t *signature, uint8_t *publicKey);
+
+	uint8_t _verifyPolicy = VERIFY_POLICY_AUTO;
+	unsigned long _softwareVerifyMicros = ATECCX08A_SOFTWARE_VERIFY_MICROS; // last measured, see softwareVerifyPreferred()
+	unsigned long _deviceVerifyMicros = 0; // last measured, 0 = not measured yet
+
+	bool sha256Chunks(uint8_t * data, size_t len, uint8_t * hash);
+	bool hashStreamStep(uint8_t mode, uint8_t *data, size_t length, Stream &source, uint8_t *next, size_t nextLength);
+
+	unsigned long _aesBlockMicros = 0; // see aesBlockMicros()
+	bool checkAesSlot(uint16_t slot);
+	bool aesCommand(uint8_t mode, uint16_t slot, uint8_t *input, uint8_t *output);
+	bool aesEcb(uint8_t mode, uint16_t slot, uint8_t keyBlock, uint8_t *input, uint8_t *output, size_t length);
+	bool aesCtrBlocks(ATECCX08A_AES_CTR *ctx, uint8_t *input, uint8_t *output, size_t length);
+	void aesGcmHash(ATECCX08A_AES_GCM *ctx, uint8_t *data, size_t length);
+	void aesGcmHashFlush(ATECCX08A_AES_GCM *ctx);
+
+	bool checkEcdhSlot(uint16_t slot, bool writeToSlot);
+	bool deriveKeyThroughTempKey(ATECCX08A_KeyDerivation *derivation); // deriveKey() on the ATECC508A
+
+	bool checkMacSlot(uint16_t slot);
+
 };
 
 
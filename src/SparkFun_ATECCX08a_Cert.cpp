@@ -0,0 +1,429 @@
+/*
+  This is a library written for the ATECCX08A Criptographic Co-Processor (QWIIC).
+
+  Compressed X.509 certificates and DER encoding.
+
+  https://github.com/sparkfun/SparkFun_ATECCX08A_Arduino_Library
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "SparkFun_ATECCX08a_Cert.h"
+#include "SparkFun_ATECCX08a_SHA256.h"
+
+// AlgorithmIdentifier ecdsa-with-SHA256 (1.2.840.10045.4.3.2)
+static const uint8_t derSignatureAlgorithm[] PROGMEM = {
+  0x30, 0x0A, 0x06, 0x08, 0x2A, 0x86, 0x48, 0xCE, 0x3D, 0x04, 0x03, 0x02
+};
+
+// SubjectPublicKeyInfo header for an uncompressed P-256 point: id-ecPublicKey, prime256v1, BIT STRING, 0x04
+static const uint8_t derPublicKeyHeader[] PROGMEM = {
+  0x30, 0x59, 0x30, 0x13, 0x06, 0x07, 0x2A, 0x86, 0x48, 0xCE, 0x3D, 0x02, 0x01,
+  0x06, 0x08, 0x2A, 0x86, 0x48, 0xCE, 0x3D, 0x03, 0x01, 0x07, 0x03, 0x42, 0x00, 0x04
+};
+
+#define CERT_WRITE_CHUNK_SIZE 32 // template bytes are copied out of flash this many at a time
+
+/* Print that fills a caller buffer, used by rebuildCertificate() */
+class CertBufferPrint : public Print {
+  public:
+	CertBufferPrint(uint8_t *buffer) : _buffer(buffer), _length(0) {}
+	using Print::write;
+	size_t write(uint8_t data) { _buffer[_length++] = data; return 1; }
+	size_t write(const uint8_t *data, size_t length) { memcpy(&_buffer[_length], data, length); _length += length; return length; }
+
+  private:
+	uint8_t *_buffer;
+	size_t _length;
+};
+
+/* Print that hashes everything written to it, used by tbsDigest() */
+class CertHashPrint : public Print {
+  public:
+	CertHashPrint() { sha.begin(); }
+	using Print::write;
+	size_t write(uint8_t data) { sha.update(&data, 1); return 1; }
+	size_t write(const uint8_t *data, size_t length) { sha.update(data, length); return length; }
+
+	ATECCX08A_SHA256 sha;
+};
+
+/** \brief
+
+	derEncodeSignature(const uint8_t *signature, uint8_t *der)
+
+	Encodes a 64-byte R||S signature as a DER ECDSA-Sig-Value (SEQUENCE of two INTEGERs),
+	the format TLS and X.509 expect. der must have room for DER_SIGNATURE_MAX_SIZE bytes.
+	Returns the encoded length.
+*/
+
+uint8_t ATECCX08A_Cert::derEncodeSignature(const uint8_t *signature, uint8_t *der)
+{
+  uint8_t length = 2; // SEQUENCE tag and length (content is never more than 70 bytes)
+
+  length += derEncodeInteger(&signature[0], &der[length]);
+  length += derEncodeInteger(&signature[32], &der[length]);
+
+  der[0] = 0x30;
+  der[1] = length - 2;
+
+  return length;
+}
+
+/** \brief
+
+	derEncodePublicKey(const uint8_t *publicKey, uint8_t *der)
+
+	Encodes a 64-byte X||Y public key as a DER SubjectPublicKeyInfo (id-ecPublicKey, prime256v1).
+	der must have room for DER_PUBLIC_KEY_SIZE bytes.
+*/
+
+uint8_t ATECCX08A_Cert::derEncodePublicKey(const uint8_t *publicKey, uint8_t *der)
+{
+  memcpy_P(der, derPublicKeyHeader, sizeof(derPublicKeyHeader));
+  memcpy(&der[sizeof(derPublicKeyHeader)], publicKey, PUBLIC_KEY_SIZE);
+
+  return DER_PUBLIC_KEY_SIZE;
+}
+
+/** \brief
+
+	compressCertificate(uint8_t *compressed, const uint8_t *signature, uint16_t year, uint8_t month, uint8_t day, uint8_t hour, uint8_t expireYears,
+		uint16_t signerId, uint8_t templateId, uint8_t chainId, uint8_t serialNumberSource)
+
+	Builds the 72-byte compressed certificate (see the top of SparkFun_ATECCX08a_Cert.h),
+	for example when a new device certificate has been signed during provisioning.
+	year is 2000-2031, expireYears 0-31 (0 keeps the expire date in the template).
+*/
+
+void ATECCX08A_Cert::compressCertificate(uint8_t *compressed, const uint8_t *signature, uint16_t year, uint8_t month, uint8_t day, uint8_t hour, uint8_t expireYears,
+	uint16_t signerId, uint8_t templateId, uint8_t chainId, uint8_t serialNumberSource)
+{
+  uint8_t yearOffset = (year - 2000) & 0x1F;
+
+  memcpy(compressed, signature, SIGNATURE_SIZE);
+
+  compressed[COMPRESSED_CERT_DATES + 0] = (yearOffset << 3) | ((month & 0x0F) >> 1);
+  compressed[COMPRESSED_CERT_DATES + 1] = ((month & 0x01) << 7) | ((day & 0x1F) << 2) | ((hour & 0x1F) >> 3);
+  compressed[COMPRESSED_CERT_DATES + 2] = ((hour & 0x07) << 5) | (expireYears & 0x1F);
+
+  compressed[COMPRESSED_CERT_SIGNER_ID + 0] = signerId >> 8;
+  compressed[COMPRESSED_CERT_SIGNER_ID + 1] = signerId & 0xFF;
+
+  compressed[COMPRESSED_CERT_TEMPLATE_ID] = (templateId << 4) | (chainId & 0x0F);
+  compressed[COMPRESSED_CERT_SN_SOURCE] = (serialNumberSource << 4) | COMPRESSED_CERT_FORMAT;
+  compressed[COMPRESSED_CERT_SIZE - 1] = 0x00;
+}
+
+/** \brief
+
+	certificateLength(const ATECCX08A_CertDef *def, const uint8_t *compressed)
+
+	Returns the length of the DER certificate that writeCertificate() will produce.
+	It depends on the signature, because the DER INTEGERs for R and S vary in length.
+*/
+
+size_t ATECCX08A_Cert::certificateLength(const ATECCX08A_CertDef *def, const uint8_t *compressed)
+{
+  uint8_t signatureDer[DER_SIGNATURE_MAX_SIZE];
+  uint8_t signatureLength = derEncodeSignature(compressed, signatureDer);
+  size_t contentLength = def->tbsLength + sizeof(derSignatureAlgorithm) + 2 + 1 + signatureLength; // BIT STRING tag, length, unused bits
+
+  return 1 + derLengthSize(contentLength) + contentLength;
+}
+
+/** \brief
+
+	writeCertificate(Print &out, const ATECCX08A_CertDef *def, const uint8_t *compressed, const uint8_t *publicKey, const uint8_t *deviceSerialNumber)
+
+	Rebuilds the full DER certificate from the template in def, the compressed certificate
+	and the 64-byte public key, and streams it to out in a single pass without allocating memory.
+	deviceSerialNumber (9 bytes, see readConfigZone()) is only needed for CERT_SN_SOURCE_DEVICE_SN.
+
+	Returns the number of bytes written, or 0 if the serial number could not be created.
+*/
+
+size_t ATECCX08A_Cert::writeCertificate(Print &out, const ATECCX08A_CertDef *def, const uint8_t *compressed, const uint8_t *publicKey, const uint8_t *deviceSerialNumber)
+{
+  uint8_t serial[CERT_SN_MAX_SIZE];
+  uint8_t signatureDer[DER_SIGNATURE_MAX_SIZE];
+  uint8_t header[1 + 3]; // tag and the longest length we use
+  uint8_t headerLength;
+  uint8_t signatureAlgorithm[sizeof(derSignatureAlgorithm)];
+  uint8_t signatureLength;
+  size_t contentLength;
+  size_t written = 0;
+
+  if (!serialNumber(serial, def, compressed, publicKey, deviceSerialNumber))
+    return 0;
+
+  signatureLength = derEncodeSignature(compressed, signatureDer);
+  contentLength = def->tbsLength + sizeof(derSignatureAlgorithm) + 2 + 1 + signatureLength;
+
+  // Certificate ::= SEQUENCE { tbsCertificate, signatureAlgorithm, signatureValue }
+  header[0] = 0x30;
+  headerLength = 1 + derWriteLength(&header[1], contentLength);
+  written += out.write(header, headerLength);
+
+  written += writeTbs(out, def, compressed, publicKey, serial);
+
+  memcpy_P(signatureAlgorithm, derSignatureAlgorithm, sizeof(derSignatureAlgorithm));
+  written += out.write(signatureAlgorithm, sizeof(signatureAlgorithm));
+
+  // signatureValue BIT STRING, no unused bits
+  header[0] = 0x03;
+  header[1] = signatureLength + 1;
+  header[2] = 0x00;
+  written += out.write(header, 3);
+  written += out.write(signatureDer, signatureLength);
+
+  return written;
+}
+
+/** \brief
+
+	rebuildCertificate(uint8_t *der, size_t maxLength, const ATECCX08A_CertDef *def, const uint8_t *compressed, const uint8_t *publicKey, const uint8_t *deviceSerialNumber)
+
+	Same as writeCertificate(), but into a buffer.
+	Returns the certificate length, or 0 if it does not fit in maxLength bytes.
+*/
+
+size_t ATECCX08A_Cert::rebuildCertificate(uint8_t *der, size_t maxLength, const ATECCX08A_CertDef *def, const uint8_t *compressed, const uint8_t *publicKey, const uint8_t *deviceSerialNumber)
+{
+  if (certificateLength(def, compressed) > maxLength)
+    return 0;
+
+  CertBufferPrint out(der);
+  return writeCertificate(out, def, compressed, publicKey, deviceSerialNumber);
+}
+
+/** \brief
+
+	tbsDigest(uint8_t *digest, const ATECCX08A_CertDef *def, const uint8_t *compressed, const uint8_t *publicKey, const uint8_t *deviceSerialNumber)
+
+	SHA-256 of the rebuilt tbsCertificate: the message the certificate signature covers.
+	Use it with createSignature() to sign a new certificate, or verifySignature() to check one.
+	The signature bytes of compressed are not used.
+*/
+
+void ATECCX08A_Cert::tbsDigest(uint8_t *digest, const ATECCX08A_CertDef *def, const uint8_t *compressed, const uint8_t *publicKey, const uint8_t *deviceSerialNumber)
+{
+  uint8_t serial[CERT_SN_MAX_SIZE];
+  CertHashPrint out;
+
+  serialNumber(serial, def, compressed, publicKey, deviceSerialNumber);
+  writeTbs(out, def, compressed, publicKey, serial);
+  out.sha.finish(digest);
+}
+
+/** \brief
+
+	writeTbs(Print &out, const ATECCX08A_CertDef *def, const uint8_t *compressed, const uint8_t *publicKey, const uint8_t *serial)
+
+	Streams the template with the device specific fields substituted,
+	copying the template out of flash CERT_WRITE_CHUNK_SIZE bytes at a time.
+*/
+
+size_t ATECCX08A_Cert::writeTbs(Print &out, const ATECCX08A_CertDef *def, const uint8_t *compressed, const uint8_t *publicKey, const uint8_t *serial)
+{
+  const uint8_t *dates = &compressed[COMPRESSED_CERT_DATES];
+  uint8_t year = dates[0] >> 3;
+  uint8_t month = ((dates[0] & 0x07) << 1) | (dates[1] >> 7);
+  uint8_t day = (dates[1] >> 2) & 0x1F;
+  uint8_t hour = ((dates[1] & 0x03) << 3) | (dates[2] >> 5);
+  uint8_t expireYears = dates[2] & 0x1F;
+  char issueDate[CERT_UTC_TIME_SIZE];
+  char expireDate[CERT_UTC_TIME_SIZE];
+  char signerId[CERT_SIGNER_ID_SIZE];
+  static const char hexDigits[] = "0123456789ABCDEF";
+  uint8_t chunk[CERT_WRITE_CHUNK_SIZE];
+  uint8_t chunkLength = 0;
+  size_t written = 0;
+
+  utcTime(issueDate, year, month, day, hour);
+  utcTime(expireDate, year + expireYears, month, day, hour);
+
+  for (uint8_t i = 0; i < CERT_SIGNER_ID_SIZE; i++)
+    signerId[i] = hexDigits[(compressed[COMPRESSED_CERT_SIGNER_ID + i / 2] >> ((i & 1) ? 0 : 4)) & 0x0F];
+
+  for (uint16_t i = 0; i < def->tbsLength; i++)
+  {
+    uint8_t data = pgm_read_byte(&def->tbsTemplate[i]);
+
+    if (def->serialNumberOffset && (i >= def->serialNumberOffset) && (i < def->serialNumberOffset + def->serialNumberLength))
+      data = serial[i - def->serialNumberOffset];
+    else if (def->issueDateOffset && (i >= def->issueDateOffset) && (i < def->issueDateOffset + CERT_UTC_TIME_SIZE))
+      data = issueDate[i - def->issueDateOffset];
+    else if (def->expireDateOffset && expireYears && (i >= def->expireDateOffset) && (i < def->expireDateOffset + CERT_UTC_TIME_SIZE))
+      data = expireDate[i - def->expireDateOffset];
+    else if (def->signerIdOffset && (i >= def->signerIdOffset) && (i < def->signerIdOffset + CERT_SIGNER_ID_SIZE))
+      data = signerId[i - def->signerIdOffset];
+    else if (def->publicKeyOffset && (i >= def->publicKeyOffset) && (i < def->publicKeyOffset + PUBLIC_KEY_SIZE))
+      data = publicKey[i - def->publicKeyOffset];
+
+    chunk[chunkLength++] = data;
+    if (chunkLength == CERT_WRITE_CHUNK_SIZE)
+    {
+      written += out.write(chunk, chunkLength);
+      chunkLength = 0;
+    }
+  }
+
+  if (chunkLength)
+    written += out.write(chunk, chunkLength);
+
+  return written;
+}
+
+/** \brief
+
+	serialNumber(uint8_t *serial, const ATECCX08A_CertDef *def, const uint8_t *compressed, const uint8_t *publicKey, const uint8_t *deviceSerialNumber)
+
+	Creates the certificate serial number from the source in the compressed certificate.
+	For CERT_SN_SOURCE_STORED the template value is kept, so serial is left untouched
+	(and not used by writeTbs()).
+*/
+
+bool ATECCX08A_Cert::serialNumber(uint8_t *serial, const ATECCX08A_CertDef *def, const uint8_t *compressed, const uint8_t *publicKey, const uint8_t *deviceSerialNumber)
+{
+  uint8_t source = compressed[COMPRESSED_CERT_SN_SOURCE] >> 4;
+  uint8_t hash[SHA256_SIZE];
+
+  if (def->serialNumberOffset == 0)
+    return true;
+
+  if (def->serialNumberLength > CERT_SN_MAX_SIZE)
+    return false;
+
+  switch (source)
+  {
+    case CERT_SN_SOURCE_STORED:
+      memcpy_P(serial, &def->tbsTemplate[def->serialNumberOffset], def->serialNumberLength);
+      return true;
+
+    case CERT_SN_SOURCE_DEVICE_SN:
+      if ((deviceSerialNumber == NULL) || (def->serialNumberLength != CERT_DEVICE_SN_SIZE))
+        return false;
+      memcpy(serial, deviceSerialNumber, CERT_DEVICE_SN_SIZE);
+      return true;
+
+    case CERT_SN_SOURCE_PUBKEY_HASH:
+    {
+      ATECCX08A_SHA256 sha;
+      sha.begin();
+      sha.update(publicKey, PUBLIC_KEY_SIZE);
+      sha.update(&compressed[COMPRESSED_CERT_DATES], 3);
+      sha.finish(hash);
+      memcpy(serial, hash, def->serialNumberLength);
+      serial[0] = (serial[0] & 0x7F) | 0x40; // positive INTEGER, and no leading zero byte to strip
+      return true;
+    }
+
+    default:
+      return false;
+  }
+}
+
+/** \brief
+
+	utcTime(char *out, uint8_t year, uint8_t month, uint8_t day, uint8_t hour)
+
+	Formats a UTCTime value, "YYMMDDHH0000Z". year is years since 2000.
+*/
+
+void ATECCX08A_Cert::utcTime(char *out, uint8_t year, uint8_t month, uint8_t day, uint8_t hour)
+{
+  uint8_t fields[4] = { (uint8_t)(year % 100), month, day, hour };
+
+  for (uint8_t i = 0; i < 4; i++)
+  {
+    out[i * 2] = '0' + fields[i] / 10;
+    out[i * 2 + 1] = '0' + fields[i] % 10;
+  }
+
+  memcpy(&out[8], "0000Z", 5);
+}
+
+/** \brief
+
+	derLengthSize(size_t length)
+
+	Returns the number of bytes derWriteLength() needs for length.
+*/
+
+uint8_t ATECCX08A_Cert::derLengthSize(size_t length)
+{
+  if (length < 0x80)
+    return 1;
+  if (length < 0x100)
+    return 2;
+  return 3;
+}
+
+/** \brief
+
+	derWriteLength(uint8_t *der, size_t length)
+
+	Writes a DER length (short form, or long form up to 65535) and returns its size.
+*/
+
+uint8_t ATECCX08A_Cert::derWriteLength(uint8_t *der, size_t length)
+{
+  uint8_t size = derLengthSize(length);
+
+  if (size == 1)
+  {
+    der[0] = length;
+  }
+  else if (size == 2)
+  {
+    der[0] = 0x81;
+    der[1] = length;
+  }
+  else
+  {
+    der[0] = 0x82;
+    der[1] = length >> 8;
+    der[2] = length & 0xFF;
+  }
+
+  return size;
+}
+
+/** \brief
+
+	derEncodeInteger(const uint8_t *value, uint8_t *der)
+
+	Encodes a 32-byte unsigned big-endian value as a DER INTEGER: leading zero bytes are removed,
+	and a zero byte is added when the top bit is set, so it stays positive. Returns the encoded length.
+*/
+
+uint8_t ATECCX08A_Cert::derEncodeInteger(const uint8_t *value, uint8_t *der)
+{
+  uint8_t start = 0;
+  uint8_t length;
+
+  while ((start < 31) && (value[start] == 0x00))
+    start++;
+
+  length = 32 - start;
+
+  der[0] = 0x02;
+  if (value[start] & 0x80)
+  {
+    der[1] = length + 1;
+    der[2] = 0x00;
+    memcpy(&der[3], &value[start], length);
+    return length + 3;
+  }
+
+  der[1] = length;
+  memcpy(&der[2], &value[start], length);
+  return length + 2;
+}
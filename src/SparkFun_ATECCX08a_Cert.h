@@ -0,0 +1,93 @@
+/*
+  This is a library written for the ATECCX08A Criptographic Co-Processor (QWIIC).
+
+  Compressed X.509 certificates and DER encoding.
+
+  A P-256 certificate is mostly constant for a given product: only the serial number,
+  dates, signer ID, public key and signature change from device to device. So instead
+  of storing the whole certificate (~500 bytes), a 72-byte "compressed certificate" is
+  kept in a data slot, and the full DER certificate is rebuilt at runtime from a
+  template (in flash), the public key and the compressed certificate.
+
+  Compressed certificate layout (72 bytes, same as Microchip's CryptoAuthLib):
+    0-63  signature R||S
+    64-66 encoded dates: issue year-2000 (5 bits), month (4), day (5), hour (5), expire years (5)
+    67-68 signer ID
+    69    template ID (high nibble), chain ID (low nibble)
+    70    serial number source (high nibble), format version (low nibble)
+    71    reserved
+
+  Rebuilding does not allocate: the certificate is streamed in one pass to any Print
+  (e.g. a TLS client), or written into a caller buffer.
+
+  https://github.com/sparkfun/SparkFun_ATECCX08A_Arduino_Library
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "SparkFun_ATECCX08a_Arduino_Library.h"
+
+#define COMPRESSED_CERT_DATES		64
+#define COMPRESSED_CERT_SIGNER_ID	67
+#define COMPRESSED_CERT_TEMPLATE_ID	69
+#define COMPRESSED_CERT_SN_SOURCE	70
+#define COMPRESSED_CERT_FORMAT		0x00
+
+#define CERT_SN_SOURCE_STORED		0x00 // serial number is in the template
+#define CERT_SN_SOURCE_DEVICE_SN	0x08 // the device's 9-byte serial number (serialNumberLength must be 9)
+#define CERT_SN_SOURCE_PUBKEY_HASH	0x0A // SHA-256(public key || encoded dates), truncated, made positive
+
+#define DER_SIGNATURE_MAX_SIZE		72 // SEQUENCE { INTEGER r, INTEGER s }, each up to 33 bytes
+#define DER_PUBLIC_KEY_SIZE			91 // SubjectPublicKeyInfo for a P-256 public key
+#define CERT_UTC_TIME_SIZE			13 // "YYMMDDHHMMSSZ"
+#define CERT_SIGNER_ID_SIZE			4 // signer ID as 4 upper case hex characters
+#define CERT_SN_MAX_SIZE			32
+#define CERT_DEVICE_SN_SIZE			9 // serialNumber[] holds 9 bytes from the config zone
+
+/* Describes where the device specific fields are in a tbsCertificate template.
+   Offsets are from the start of the template, and 0 means the field is not in the template
+   (offset 0 is always the SEQUENCE tag). The template itself holds placeholder values
+   of the right length for each field. */
+typedef struct {
+  const uint8_t *tbsTemplate; // DER of the tbsCertificate, in PROGMEM
+  uint16_t tbsLength;
+  uint16_t serialNumberOffset; // INTEGER value bytes
+  uint8_t serialNumberLength;
+  uint16_t issueDateOffset; // UTCTime value bytes
+  uint16_t expireDateOffset; // UTCTime value bytes
+  uint16_t signerIdOffset; // 4 hex characters, usually in the issuer (device cert) or subject (signer cert) CN
+  uint16_t publicKeyOffset; // the 64 bytes X||Y after the 0x04 point format byte
+} ATECCX08A_CertDef;
+
+class ATECCX08A_Cert {
+  public:
+	// DER encoders
+	static uint8_t derEncodeSignature(const uint8_t *signature, uint8_t *der); // returns length, up to DER_SIGNATURE_MAX_SIZE
+	static uint8_t derEncodePublicKey(const uint8_t *publicKey, uint8_t *der); // returns DER_PUBLIC_KEY_SIZE
+
+	// compressed certificates
+	static void compressCertificate(uint8_t *compressed, const uint8_t *signature, uint16_t year, uint8_t month, uint8_t day, uint8_t hour, uint8_t expireYears,
+		uint16_t signerId, uint8_t templateId = 0, uint8_t chainId = 0, uint8_t serialNumberSource = CERT_SN_SOURCE_STORED);
+
+	// full certificate rebuild
+	static size_t certificateLength(const ATECCX08A_CertDef *def, const uint8_t *compressed);
+	static size_t writeCertificate(Print &out, const ATECCX08A_CertDef *def, const uint8_t *compressed, const uint8_t *publicKey, const uint8_t *deviceSerialNumber = NULL);
+	static size_t rebuildCertificate(uint8_t *der, size_t maxLength, const ATECCX08A_CertDef *def, const uint8_t *compressed, const uint8_t *publicKey, const uint8_t *deviceSerialNumber = NULL);
+	static void tbsDigest(uint8_t *digest, const ATECCX08A_CertDef *def, const uint8_t *compressed, const uint8_t *publicKey, const uint8_t *deviceSerialNumber = NULL);
+
+  private:
+	static size_t writeTbs(Print &out, const ATECCX08A_CertDef *def, const uint8_t *compressed, const uint8_t *publicKey, const uint8_t *serial);
+	static bool serialNumber(uint8_t *serial, const ATECCX08A_CertDef *def, const uint8_t *compressed, const uint8_t *publicKey, const uint8_t *deviceSerialNumber);
+	static void utcTime(char *out, uint8_t year, uint8_t month, uint8_t day, uint8_t hour);
+	static uint8_t derLengthSize(size_t length);
+	static uint8_t derWriteLength(uint8_t *der, size_t length);
+	static uint8_t derEncodeInteger(const uint8_t *value, uint8_t *der);
+};
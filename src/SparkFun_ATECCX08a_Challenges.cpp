@@ -0,0 +1,348 @@
+/*
+  This is a library written for the ATECCX08A Criptographic Co-Processor (QWIIC).
+
+  Verifier side challenge table, see SparkFun_ATECCX08a_Challenges.h
+
+  https://github.com/sparkfun/SparkFun_ATECCX08A_Arduino_Library
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "SparkFun_ATECCX08a_Challenges.h"
+
+#define CHALLENGE_WHEEL_MASK		(CHALLENGE_WHEEL_SLOTS - 1)
+
+ATECCX08A_ChallengeTable::ATECCX08A_ChallengeTable(ATECCX08A &device) : _device(device)
+{
+  clear();
+}
+
+/** \brief
+
+	issue(uint32_t peer, uint8_t *challenge, unsigned long timeoutMs)
+
+	Creates a new 32-byte challenge for peer, and copies it into challenge.
+	Send it to the peer, who signs it (e.g. with respondToChallenge()), then check the
+	signature with checkResponse() within timeoutMs. An outstanding challenge for the same
+	peer is replaced. Timeouts are rounded up to whole ticks, and capped at
+	(CHALLENGE_WHEEL_SLOTS - 2) * CHALLENGE_TICK_MS.
+	Uses the IC only when the read-ahead is empty (see refill()). Returns false if the
+	table is full (CHALLENGE_TABLE_SIZE challenges outstanding), or if the RNG failed.
+*/
+
+bool ATECCX08A_ChallengeTable::issue(uint32_t peer, uint8_t *challenge, unsigned long timeoutMs)
+{
+  unsigned long ticks;
+  uint8_t index;
+
+  if ((_prefetched == 0) && !refill())
+    return false;
+
+  expire(); // after the RNG, so its wait does not come off the timeout
+
+  index = find(peer);
+  if (index != CHALLENGE_NONE)
+    remove(index);
+
+  if (_free == CHALLENGE_NONE)
+    return false;
+
+  // the current tick has partly gone already, so one more makes it at least timeoutMs
+  if (timeoutMs >= (unsigned long)(CHALLENGE_WHEEL_SLOTS - 2) * CHALLENGE_TICK_MS)
+    ticks = CHALLENGE_WHEEL_SLOTS - 1;
+  else
+    ticks = ((timeoutMs + CHALLENGE_TICK_MS - 1) / CHALLENGE_TICK_MS) + 1;
+
+  index = _free;
+  Entry *entry = &_entries[index];
+  _free = entry->hashNext;
+
+  _prefetched--;
+  memcpy(entry->challenge, _prefetch[_prefetched], CHALLENGE_SIZE);
+  memset(_prefetch[_prefetched], 0, CHALLENGE_SIZE); // handed out once only
+  memcpy(challenge, entry->challenge, CHALLENGE_SIZE);
+
+  entry->peer = peer;
+  entry->used = true;
+
+  uint8_t b = bucket(peer);
+  entry->hashNext = _buckets[b];
+  _buckets[b] = index;
+
+  // ticks < CHALLENGE_WHEEL_SLOTS, so everything in a wheel slot is due on the same tick
+  entry->wheelSlot = (_tick + ticks) & CHALLENGE_WHEEL_MASK;
+  entry->wheelPrev = CHALLENGE_NONE;
+  entry->wheelNext = _wheel[entry->wheelSlot];
+  if (entry->wheelNext != CHALLENGE_NONE)
+    _entries[entry->wheelNext].wheelPrev = index;
+  _wheel[entry->wheelSlot] = index;
+
+  _outstanding++;
+
+  return true;
+}
+
+/** \brief
+
+	checkResponse(uint32_t peer, uint8_t *signature, uint8_t *publicKey)
+
+	Checks peer's signature of its outstanding challenge, with verifySignature() and the
+	peer's 64-byte public key (X,Y). The challenge is used up either way: a second response
+	(e.g. a replay) is rejected, without using the IC. So is a response with no outstanding
+	challenge (never issued, expired, or cancelled).
+*/
+
+bool ATECCX08A_ChallengeTable::checkResponse(uint32_t peer, uint8_t *signature, uint8_t *publicKey)
+{
+  uint8_t challenge[CHALLENGE_SIZE];
+
+  if (!take(peer, challenge))
+    return false;
+
+  if (!_device.verifySignature(challenge, signature, publicKey))
+  {
+    _rejected++;
+    return false;
+  }
+
+  return true;
+}
+
+/** \brief
+
+	checkResponseStored(uint32_t peer, uint8_t *signature, uint16_t slot)
+
+	Same as checkResponse(), with the peer's public key stored in slot (see verifySignatureStored()).
+*/
+
+bool ATECCX08A_ChallengeTable::checkResponseStored(uint32_t peer, uint8_t *signature, uint16_t slot)
+{
+  uint8_t challenge[CHALLENGE_SIZE];
+
+  if (!take(peer, challenge))
+    return false;
+
+  if (!_device.verifySignatureStored(challenge, signature, slot))
+  {
+    _rejected++;
+    return false;
+  }
+
+  return true;
+}
+
+bool ATECCX08A_ChallengeTable::cancel(uint32_t peer)
+{
+  uint8_t index;
+
+  expire();
+
+  index = find(peer);
+  if (index == CHALLENGE_NONE)
+    return false;
+
+  remove(index);
+
+  return true;
+}
+
+/** \brief
+
+	refill()
+
+	Reads new challenges from the RNG (RANDOM command) until CHALLENGE_PREFETCH are ready,
+	all in a single wake. issue() calls it when none are left, but calling it from loop()
+	while the IC has nothing else to do keeps that wait out of issue().
+*/
+
+bool ATECCX08A_ChallengeTable::refill()
+{
+  bool result = true;
+
+  if (_prefetched == CHALLENGE_PREFETCH)
+    return true;
+
+  _device.beginSession();
+
+  while (_prefetched < CHALLENGE_PREFETCH)
+  {
+    if (!_device.updateRandom32Bytes(false, _prefetch[_prefetched]))
+    {
+      result = false;
+      break;
+    }
+    _prefetched++;
+  }
+
+  _device.endSession();
+
+  return result;
+}
+
+/** \brief
+
+	expire()
+
+	Moves the timer wheel up to millis(), and drops the challenges that are due: the ones
+	in each wheel slot passed. More than a whole turn of the wheel since the last call
+	means everything is due.
+*/
+
+void ATECCX08A_ChallengeTable::expire()
+{
+  unsigned long elapsed = (millis() - _tickMillis) / CHALLENGE_TICK_MS;
+
+  if (elapsed == 0)
+    return;
+
+  _tickMillis += elapsed * CHALLENGE_TICK_MS;
+
+  if (elapsed >= CHALLENGE_WHEEL_SLOTS)
+  {
+    _tick += elapsed;
+    for (uint8_t i = 0; i < CHALLENGE_TABLE_SIZE; i++)
+    {
+      if (_entries[i].used)
+      {
+        remove(i);
+        _expired++;
+      }
+    }
+    return;
+  }
+
+  while (elapsed--)
+  {
+    uint8_t slot = (++_tick) & CHALLENGE_WHEEL_MASK;
+
+    while (_wheel[slot] != CHALLENGE_NONE)
+    {
+      remove(_wheel[slot]);
+      _expired++;
+    }
+  }
+}
+
+bool ATECCX08A_ChallengeTable::pending(uint32_t peer)
+{
+  expire();
+
+  return find(peer) != CHALLENGE_NONE;
+}
+
+uint8_t ATECCX08A_ChallengeTable::outstanding()
+{
+  expire();
+
+  return _outstanding;
+}
+
+uint8_t ATECCX08A_ChallengeTable::prefetched()
+{
+  return _prefetched;
+}
+
+unsigned long ATECCX08A_ChallengeTable::expiredChallenges()
+{
+  return _expired;
+}
+
+unsigned long ATECCX08A_ChallengeTable::rejectedResponses()
+{
+  return _rejected;
+}
+
+/** \brief
+
+	clear()
+
+	Drops all outstanding challenges (not counted as expired), and resets the counters.
+	The read-ahead challenges are kept, they were never handed out.
+*/
+
+void ATECCX08A_ChallengeTable::clear()
+{
+  for (uint8_t i = 0; i < CHALLENGE_TABLE_SIZE; i++)
+  {
+    memset(_entries[i].challenge, 0, CHALLENGE_SIZE);
+    _entries[i].used = false;
+    _entries[i].hashNext = (i + 1 < CHALLENGE_TABLE_SIZE) ? (i + 1) : CHALLENGE_NONE;
+  }
+  _free = 0;
+
+  memset(_buckets, CHALLENGE_NONE, sizeof(_buckets));
+  memset(_wheel, CHALLENGE_NONE, sizeof(_wheel));
+
+  _outstanding = 0;
+  _tick = 0;
+  _tickMillis = millis();
+  _expired = 0;
+  _rejected = 0;
+}
+
+uint8_t ATECCX08A_ChallengeTable::find(uint32_t peer)
+{
+  uint8_t index = _buckets[bucket(peer)];
+
+  while ((index != CHALLENGE_NONE) && (_entries[index].peer != peer))
+    index = _entries[index].hashNext;
+
+  return index;
+}
+
+// copies peer's challenge and drops it from the table, so it can only be checked once
+bool ATECCX08A_ChallengeTable::take(uint32_t peer, uint8_t *challenge)
+{
+  uint8_t index;
+
+  expire();
+
+  index = find(peer);
+  if (index == CHALLENGE_NONE)
+  {
+    _rejected++;
+    return false;
+  }
+
+  memcpy(challenge, _entries[index].challenge, CHALLENGE_SIZE);
+  remove(index);
+
+  return true;
+}
+
+// unlinks an entry from its wheel slot and its hash bucket, and frees it
+void ATECCX08A_ChallengeTable::remove(uint8_t index)
+{
+  Entry *entry = &_entries[index];
+
+  if (entry->wheelPrev != CHALLENGE_NONE)
+    _entries[entry->wheelPrev].wheelNext = entry->wheelNext;
+  else
+    _wheel[entry->wheelSlot] = entry->wheelNext;
+  if (entry->wheelNext != CHALLENGE_NONE)
+    _entries[entry->wheelNext].wheelPrev = entry->wheelPrev;
+
+  uint8_t *link = &_buckets[bucket(entry->peer)];
+  while (*link != index)
+    link = &_entries[*link].hashNext;
+  *link = entry->hashNext;
+
+  memset(entry->challenge, 0, CHALLENGE_SIZE);
+  entry->used = false;
+  entry->hashNext = _free;
+  _free = index;
+
+  _outstanding--;
+}
+
+// Fibonacci hashing, so sequential peer ids spread over the buckets
+uint8_t ATECCX08A_ChallengeTable::bucket(uint32_t peer)
+{
+  return ((uint32_t)(peer * 2654435761UL) >> 16) & (CHALLENGE_HASH_BUCKETS - 1);
+}
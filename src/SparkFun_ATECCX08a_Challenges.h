@@ -0,0 +1,126 @@
+/*
+  This is a library written for the ATECCX08A Criptographic Co-Processor (QWIIC).
+
+  Verifier side challenge table: one outstanding challenge per peer, for many peers at once.
+
+  issue(peer, challenge) hands out a fresh 32-byte challenge for peer (any 32-bit id, e.g. a
+  node address), and checkResponse(peer, signature, publicKey) checks the peer's signature of
+  it. Each challenge answers exactly once: it is taken out of the table before the signature
+  is checked, so a replayed response (or a second try) is rejected without using the IC.
+  A new issue() for the same peer replaces its old challenge.
+
+  Challenges expire after their timeout. The table keeps them in a timer wheel of
+  CHALLENGE_WHEEL_SLOTS ticks of CHALLENGE_TICK_MS each, so expiry costs O(1) per tick and per
+  challenge, however many are outstanding. Lookups by peer go through a small hash table.
+  The RNG is read ahead, CHALLENGE_PREFETCH challenges per wake (refill()), so most issue()
+  calls do not use the IC at all.
+
+  Sizes are set at compile time, with -D for the whole build (a #define in the sketch does not
+  reach the library's .cpp, and the two would disagree on the table layout):
+    CHALLENGE_TABLE_SIZE     outstanding challenges at once, up to 254
+    CHALLENGE_HASH_BUCKETS   peer lookup buckets, a power of two up to 256
+    CHALLENGE_WHEEL_SLOTS    timer wheel ticks, a power of two up to 256; the longest timeout
+                             is (CHALLENGE_WHEEL_SLOTS - 2) * CHALLENGE_TICK_MS
+    CHALLENGE_PREFETCH       challenges read ahead from the RNG
+  With the defaults, the table takes about 1 KB of RAM.
+
+  https://github.com/sparkfun/SparkFun_ATECCX08A_Arduino_Library
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "SparkFun_ATECCX08a_Arduino_Library.h"
+
+#ifndef CHALLENGE_TABLE_SIZE
+#define CHALLENGE_TABLE_SIZE		16
+#endif
+
+#ifndef CHALLENGE_HASH_BUCKETS
+#define CHALLENGE_HASH_BUCKETS		16
+#endif
+
+#ifndef CHALLENGE_WHEEL_SLOTS
+#define CHALLENGE_WHEEL_SLOTS		64
+#endif
+
+#ifndef CHALLENGE_TICK_MS
+#define CHALLENGE_TICK_MS			50
+#endif
+
+#ifndef CHALLENGE_PREFETCH
+#define CHALLENGE_PREFETCH			4
+#endif
+
+#define CHALLENGE_TIMEOUT_MS		1000 // default time a peer has to answer
+#define CHALLENGE_NONE				0xFF // end of a list
+
+#if (CHALLENGE_TABLE_SIZE < 1) || (CHALLENGE_TABLE_SIZE >= CHALLENGE_NONE)
+#error "CHALLENGE_TABLE_SIZE must be 1 to 254"
+#endif
+#if (CHALLENGE_HASH_BUCKETS < 1) || (CHALLENGE_HASH_BUCKETS > 256) || (CHALLENGE_HASH_BUCKETS & (CHALLENGE_HASH_BUCKETS - 1))
+#error "CHALLENGE_HASH_BUCKETS must be a power of two, up to 256"
+#endif
+#if (CHALLENGE_WHEEL_SLOTS < 4) || (CHALLENGE_WHEEL_SLOTS > 256) || (CHALLENGE_WHEEL_SLOTS & (CHALLENGE_WHEEL_SLOTS - 1))
+#error "CHALLENGE_WHEEL_SLOTS must be a power of two, 4 to 256"
+#endif
+
+class ATECCX08A_ChallengeTable {
+  public:
+	ATECCX08A_ChallengeTable(ATECCX08A &device);
+
+	bool issue(uint32_t peer, uint8_t *challenge, unsigned long timeoutMs = CHALLENGE_TIMEOUT_MS);
+	bool checkResponse(uint32_t peer, uint8_t *signature, uint8_t *publicKey); // with verifySignature()
+	bool checkResponseStored(uint32_t peer, uint8_t *signature, uint16_t slot); // with verifySignatureStored()
+	bool cancel(uint32_t peer); // drops peer's challenge, if it has one
+
+	bool refill(); // tops up the RNG read-ahead, in one wake; call it when the IC would sit idle
+	void expire(); // expires what is due, also done by every other call
+
+	bool pending(uint32_t peer);
+	uint8_t outstanding(); // challenges issued, not answered and not expired yet
+	uint8_t prefetched(); // challenges ready without using the IC
+	unsigned long expiredChallenges();
+	unsigned long rejectedResponses(); // bad signatures, and responses with no challenge (expired, replayed, ...)
+	void clear();
+
+  private:
+	typedef struct {
+		uint32_t peer;
+		uint8_t challenge[CHALLENGE_SIZE];
+		uint8_t hashNext; // next in the peer's hash bucket (or in the free list)
+		uint8_t wheelPrev; // neighbours in the timer wheel slot
+		uint8_t wheelNext;
+		uint8_t wheelSlot;
+		bool used;
+	} Entry;
+
+	ATECCX08A &_device;
+
+	Entry _entries[CHALLENGE_TABLE_SIZE];
+	uint8_t _buckets[CHALLENGE_HASH_BUCKETS];
+	uint8_t _wheel[CHALLENGE_WHEEL_SLOTS];
+	uint8_t _free = CHALLENGE_NONE;
+	uint8_t _outstanding = 0;
+
+	unsigned long _tick = 0; // ticks since clear(), the wheel slot is _tick % CHALLENGE_WHEEL_SLOTS
+	unsigned long _tickMillis = 0; // millis() at the start of _tick
+
+	uint8_t _prefetch[CHALLENGE_PREFETCH][CHALLENGE_SIZE];
+	uint8_t _prefetched = 0;
+
+	unsigned long _expired = 0;
+	unsigned long _rejected = 0;
+
+	uint8_t find(uint32_t peer);
+	bool take(uint32_t peer, uint8_t *challenge); // removes peer's challenge, for a check
+	void remove(uint8_t index);
+	static uint8_t bucket(uint32_t peer);
+};
@@ -0,0 +1,120 @@
+/*
+  This is a library written for the ATECCX08A Criptographic Co-Processor (QWIIC).
+
+  Lock-free request queue for a device worker, see SparkFun_ATECCX08a_Concurrency.h
+
+  https://github.com/sparkfun/SparkFun_ATECCX08A_Arduino_Library
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "SparkFun_ATECCX08a_Concurrency.h"
+
+#if defined(ATECCX08A_HAS_ATOMIC)
+
+/* Bounded multi-producer queue (D. Vyukov). Each cell has a sequence number:
+   sequence == position means the cell is free for the producer claiming that position,
+   sequence == position + 1 means it holds a request for the consumer at that position.
+   Producers claim positions with compare-and-swap, so submit() never waits on a lock. */
+
+ATECCX08A_Queue::ATECCX08A_Queue(ATECCX08A &device) : _device(device)
+{
+  for (size_t i = 0; i < ATECCX08A_QUEUE_SIZE; i++)
+  {
+    _cells[i].sequence.store(i, std::memory_order_relaxed);
+    _cells[i].request = NULL;
+  }
+
+  _enqueuePosition.store(0, std::memory_order_relaxed);
+  _dequeuePosition.store(0, std::memory_order_relaxed);
+}
+
+/** \brief
+
+	submit(ATECCX08A_Request *request, ATECCX08A_Job job, void *context)
+
+	Queues job(device, context) for the worker and returns immediately.
+	Returns false if the queue is full (try again later) or if request is still queued.
+	Poll done(request), then read request->result and the outputs in context.
+*/
+
+bool ATECCX08A_Queue::submit(ATECCX08A_Request *request, ATECCX08A_Job job, void *context)
+{
+  Cell *cell;
+  size_t position = _enqueuePosition.load(std::memory_order_relaxed);
+
+  if (request->state.load(std::memory_order_acquire) == REQUEST_QUEUED)
+    return false;
+
+  while (true)
+  {
+    cell = &_cells[position & (ATECCX08A_QUEUE_SIZE - 1)];
+    size_t sequence = cell->sequence.load(std::memory_order_acquire);
+    intptr_t difference = (intptr_t)sequence - (intptr_t)position;
+
+    if (difference == 0)
+    {
+      if (_enqueuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+        break;
+    }
+    else if (difference < 0)
+      return false; // full
+    else
+      position = _enqueuePosition.load(std::memory_order_relaxed);
+  }
+
+  request->job = job;
+  request->context = context;
+  request->result = false;
+  request->state.store(REQUEST_QUEUED, std::memory_order_relaxed);
+
+  cell->request = request;
+  cell->sequence.store(position + 1, std::memory_order_release); // publish to the worker
+
+  return true;
+}
+
+bool ATECCX08A_Queue::done(ATECCX08A_Request *request)
+{
+  return (request->state.load(std::memory_order_acquire) == REQUEST_DONE);
+}
+
+/** \brief
+
+	process()
+
+	Call from the worker task (the only task that calls it). Runs the next request in a
+	session, so it is atomic against direct calls from other tasks when a lock is set.
+	Returns false if the queue was empty, so the worker can sleep for a while.
+*/
+
+bool ATECCX08A_Queue::process()
+{
+  size_t position = _dequeuePosition.load(std::memory_order_relaxed);
+  Cell *cell = &_cells[position & (ATECCX08A_QUEUE_SIZE - 1)];
+  size_t sequence = cell->sequence.load(std::memory_order_acquire);
+
+  if ((intptr_t)sequence - (intptr_t)(position + 1) < 0)
+    return false; // empty
+
+  ATECCX08A_Request *request = cell->request;
+
+  _dequeuePosition.store(position + 1, std::memory_order_relaxed);
+  cell->sequence.store(position + ATECCX08A_QUEUE_SIZE, std::memory_order_release); // free the cell for producers
+
+  _device.beginSession();
+  request->result = request->job(_device, request->context);
+  _device.endSession();
+
+  request->state.store(REQUEST_DONE, std::memory_order_release);
+
+  return true;
+}
+
+#endif
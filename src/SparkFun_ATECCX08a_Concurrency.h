@@ -0,0 +1,124 @@
+/*
+  This is a library written for the ATECCX08A Criptographic Co-Processor (QWIIC).
+
+  Sharing one ATECCX08A between tasks or threads.
+
+  1. Locks. ATECCX08A::setLock() makes every library call atomic against the IC:
+     ATECCX08A_FreeRTOSLock   FreeRTOS recursive mutex (ESP32, or include FreeRTOS before this file)
+     ATECCX08A_StdLock        std::recursive_mutex, define ATECCX08A_STD_MUTEX to enable (hosts, ESP32)
+     ATECCX08A_Lock           no locking (the default when no lock is set)
+
+  2. Request queue. Tasks that should not block on the IC (each command waits several ms,
+     signing ~50 ms) submit a request and carry on. A single worker task owns the IC and runs
+     the requests in order, see ATECCX08A_Queue. Submitting never blocks: the queue is a
+     bounded lock-free ring, so it can also be used from tasks with tight timing.
+
+  https://github.com/sparkfun/SparkFun_ATECCX08A_Arduino_Library
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "SparkFun_ATECCX08a_Arduino_Library.h"
+
+#if defined(ESP32)
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#define ATECCX08A_HAS_FREERTOS
+#elif defined(INC_FREERTOS_H) // FreeRTOS.h was included before this file
+#include "semphr.h"
+#define ATECCX08A_HAS_FREERTOS
+#endif
+
+#if defined(ATECCX08A_STD_MUTEX)
+#include <mutex>
+#endif
+
+// The request queue needs lock-free compare-and-swap (not on AVR or Cortex-M0)
+#if !defined(ATECCX08A_HAS_ATOMIC) && defined(__has_include)
+#if __has_include(<atomic>) && !defined(__AVR__) && !defined(__ARM_ARCH_6M__)
+#define ATECCX08A_HAS_ATOMIC
+#endif
+#endif
+
+#if defined(ATECCX08A_HAS_ATOMIC)
+#include <atomic>
+#endif
+
+#if defined(ATECCX08A_HAS_FREERTOS)
+class ATECCX08A_FreeRTOSLock : public ATECCX08A_Lock {
+  public:
+	ATECCX08A_FreeRTOSLock() { _mutex = xSemaphoreCreateRecursiveMutex(); }
+	~ATECCX08A_FreeRTOSLock() { vSemaphoreDelete(_mutex); }
+	void lock() { xSemaphoreTakeRecursive(_mutex, portMAX_DELAY); }
+	void unlock() { xSemaphoreGiveRecursive(_mutex); }
+
+  private:
+	SemaphoreHandle_t _mutex;
+};
+#endif
+
+#if defined(ATECCX08A_STD_MUTEX)
+class ATECCX08A_StdLock : public ATECCX08A_Lock {
+  public:
+	void lock() { _mutex.lock(); }
+	void unlock() { _mutex.unlock(); }
+
+  private:
+	std::recursive_mutex _mutex;
+};
+#endif
+
+#if defined(ATECCX08A_HAS_ATOMIC)
+
+#define ATECCX08A_QUEUE_SIZE 8 // requests waiting for the worker, must be a power of 2
+
+#define REQUEST_IDLE	0 // not submitted, or collected
+#define REQUEST_QUEUED	1 // waiting for (or running on) the worker
+#define REQUEST_DONE	2 // finished, result is valid
+
+// A job runs on the worker, inside a session, and returns its result.
+// context carries the job's inputs and outputs, e.g. a struct with the message and a signature buffer.
+typedef bool (*ATECCX08A_Job)(ATECCX08A &device, void *context);
+
+// Owned by the submitting task, and must stay valid until the request is done.
+struct ATECCX08A_Request {
+	ATECCX08A_Request() : job(NULL), context(NULL), result(false), state(REQUEST_IDLE) {}
+
+	ATECCX08A_Job job;
+	void *context;
+	bool result;
+	std::atomic<uint8_t> state;
+};
+
+class ATECCX08A_Queue {
+  public:
+	ATECCX08A_Queue(ATECCX08A &device);
+
+	// any task: queue a request, false if the queue is full or the request is still queued
+	bool submit(ATECCX08A_Request *request, ATECCX08A_Job job, void *context);
+	static bool done(ATECCX08A_Request *request); // true once the result is valid
+
+	// worker task: runs the next request, false if there was none
+	bool process();
+
+  private:
+	typedef struct {
+		std::atomic<size_t> sequence;
+		ATECCX08A_Request *request;
+	} Cell;
+
+	ATECCX08A &_device;
+	Cell _cells[ATECCX08A_QUEUE_SIZE];
+	std::atomic<size_t> _enqueuePosition;
+	std::atomic<size_t> _dequeuePosition;
+};
+
+#endif
@@ -0,0 +1,254 @@
+/*
+  This is a library written for the ATECCX08A Criptographic Co-Processor (QWIIC).
+
+  HMAC_DRBG (NIST SP 800-90A), see SparkFun_ATECCX08a_DRBG.h
+
+  https://github.com/sparkfun/SparkFun_ATECCX08A_Arduino_Library
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "SparkFun_ATECCX08a_DRBG.h"
+
+#define HMAC_IPAD 0x36
+#define HMAC_OPAD 0x5C
+
+// zeroes secrets in a way the compiler can not drop as a dead store
+static void drbgWipe(void *data, size_t length)
+{
+  volatile uint8_t *bytes = (volatile uint8_t *)data;
+
+  while (length--)
+    *bytes++ = 0;
+}
+
+ATECCX08A_DRBG::ATECCX08A_DRBG(ATECCX08A &device) : _device(device)
+{
+}
+
+ATECCX08A_DRBG::~ATECCX08A_DRBG()
+{
+  clear();
+}
+
+/** \brief
+
+	begin(const uint8_t *personalization, size_t length)
+
+	Instantiates the DRBG with 64 bytes from the IC's RNG (entropy input and nonce),
+	plus an optional personalization string (e.g. the device serial number).
+	Returns false if the IC did not deliver the seed, generate() fails until begin() succeeds.
+	That includes an IC with an unlocked config zone (ATECC_STATUS_CONFIG_UNLOCKED, see randomReady()):
+	its RNG gives the same test pattern on every board, which is no seed at all.
+*/
+
+bool ATECCX08A_DRBG::begin(const uint8_t *personalization, size_t length)
+{
+  if (!_device.randomReady())
+    return false;
+
+  return seed(true, personalization, length);
+}
+
+/** \brief
+
+	reseed(const uint8_t *additional, size_t length)
+
+	Mixes 32 fresh bytes from the IC's RNG (plus optional additional input) into the state.
+	generate() calls this on its own, see setReseedInterval() and setPredictionResistance().
+*/
+
+bool ATECCX08A_DRBG::reseed(const uint8_t *additional, size_t length)
+{
+  if (!_seeded)
+    return false;
+
+  return seed(false, additional, length);
+}
+
+bool ATECCX08A_DRBG::seed(bool instantiate, const uint8_t *data, size_t length)
+{
+  uint8_t entropy[DRBG_SEED_SIZE * 2];
+  size_t entropyLength = instantiate ? sizeof(entropy) : DRBG_SEED_SIZE; // the nonce only comes with the first seed
+  bool result = true;
+
+  _device.beginSession(); // all seed reads in a single wake
+  for (size_t i = 0; (i < entropyLength) && result; i += RESPONSE_RANDOM_SIZE)
+    result = _device.updateRandom32Bytes(false, &entropy[i]);
+  _device.endSession();
+
+  if (!result)
+  {
+    drbgWipe(entropy, sizeof(entropy));
+    return false;
+  }
+
+  if (instantiate)
+  {
+    memset(_key, 0x00, sizeof(_key));
+    memset(_value, 0x01, sizeof(_value));
+    setKey();
+  }
+
+  update(entropy, entropyLength, data, length); // seed_material = entropy_input || nonce || personalization_string
+  drbgWipe(entropy, sizeof(entropy));
+
+  _reseedCounter = 1;
+  _seeded = true;
+
+  return true;
+}
+
+/** \brief
+
+	generate(uint8_t *output, size_t length, const uint8_t *additional, size_t additionalLength)
+
+	Fills output with length random bytes. Reseeds from the IC first when the reseed interval
+	is up, or always with prediction resistance on, and fails (without any output) if that reseed fails.
+	Requests over DRBG_MAX_REQUEST bytes are split into several SP 800-90A requests.
+*/
+
+bool ATECCX08A_DRBG::generate(uint8_t *output, size_t length, const uint8_t *additional, size_t additionalLength)
+{
+  if (!_seeded)
+    return false;
+
+  while (length)
+  {
+    size_t size = (length < DRBG_MAX_REQUEST) ? length : DRBG_MAX_REQUEST;
+
+    if (!generateRequest(output, size, additional, additionalLength))
+      return false;
+
+    output += size;
+    length -= size;
+  }
+
+  return true;
+}
+
+bool ATECCX08A_DRBG::generateRequest(uint8_t *output, size_t length, const uint8_t *additional, size_t additionalLength)
+{
+  if (_predictionResistance || (_reseedCounter > _reseedInterval))
+  {
+    if (!reseed(additional, additionalLength))
+      return false;
+
+    additional = NULL; // already mixed in by the reseed
+    additionalLength = 0;
+  }
+
+  if (additionalLength)
+    update(additional, additionalLength);
+
+  while (length)
+  {
+    size_t size = (length < SHA256_SIZE) ? length : SHA256_SIZE;
+
+    nextValue();
+    memcpy(output, _value, size);
+
+    output += size;
+    length -= size;
+  }
+
+  update(additional, additionalLength);
+  _reseedCounter++;
+
+  return true;
+}
+
+void ATECCX08A_DRBG::clear()
+{
+  drbgWipe(_key, sizeof(_key));
+  drbgWipe(_value, sizeof(_value));
+  drbgWipe(&_inner, sizeof(_inner));
+  drbgWipe(&_outer, sizeof(_outer));
+  _seeded = false;
+  _reseedCounter = 0;
+}
+
+void ATECCX08A_DRBG::setReseedInterval(uint32_t requests)
+{
+  _reseedInterval = requests ? requests : DRBG_RESEED_INTERVAL;
+}
+
+void ATECCX08A_DRBG::setPredictionResistance(bool enabled)
+{
+  _predictionResistance = enabled;
+}
+
+uint32_t ATECCX08A_DRBG::reseedCounter()
+{
+  return _seeded ? (_reseedCounter - 1) : 0;
+}
+
+// HMAC_DRBG_Update(): K = HMAC(K, V || 0x00 || data), V = HMAC(K, V), then again with 0x01 if there is data
+void ATECCX08A_DRBG::update(const uint8_t *data1, size_t length1, const uint8_t *data2, size_t length2)
+{
+  for (uint8_t separator = 0x00; separator <= 0x01; separator++)
+  {
+    ATECCX08A_SHA256 sha = _inner;
+
+    sha.update(_value, SHA256_SIZE);
+    sha.update(&separator, 1);
+    if (length1)
+      sha.update(data1, length1);
+    if (length2)
+      sha.update(data2, length2);
+    hmacFinish(&sha, _key);
+    setKey();
+
+    nextValue();
+
+    if ((length1 + length2) == 0)
+      break;
+  }
+}
+
+// V = HMAC(K, V)
+void ATECCX08A_DRBG::nextValue()
+{
+  ATECCX08A_SHA256 sha = _inner;
+
+  sha.update(_value, SHA256_SIZE);
+  hmacFinish(&sha, _value);
+}
+
+// precomputes the padded key blocks, so an HMAC of V costs two SHA-256 blocks instead of four
+void ATECCX08A_DRBG::setKey()
+{
+  uint8_t block[SHA_BLOCK_SIZE];
+
+  memset(block, 0, sizeof(block));
+  memcpy(block, _key, SHA256_SIZE);
+
+  for (uint8_t i = 0; i < SHA_BLOCK_SIZE; i++)
+    block[i] ^= HMAC_IPAD;
+  _inner.begin();
+  _inner.update(block, SHA_BLOCK_SIZE);
+
+  for (uint8_t i = 0; i < SHA_BLOCK_SIZE; i++)
+    block[i] ^= (HMAC_IPAD ^ HMAC_OPAD);
+  _outer.begin();
+  _outer.update(block, SHA_BLOCK_SIZE);
+
+  drbgWipe(block, sizeof(block));
+}
+
+// finishes an HMAC that was started from _inner
+void ATECCX08A_DRBG::hmacFinish(ATECCX08A_SHA256 *sha, uint8_t *mac)
+{
+  uint8_t innerHash[SHA256_SIZE];
+  ATECCX08A_SHA256 outer = _outer;
+
+  sha->finish(innerHash);
+  outer.update(innerHash, SHA256_SIZE);
+  outer.finish(mac);
+}
@@ -0,0 +1,67 @@
+/*
+  This is a library written for the ATECCX08A Criptographic Co-Processor (QWIIC).
+
+  HMAC_DRBG with SHA-256 (NIST SP 800-90A, section 10.1.2), seeded from the IC's RNG.
+
+  The IC returns 32 random bytes per RANDOM command, in ~23 ms. The DRBG turns one seed
+  from the IC into as many random bytes as you need, at software SHA-256 speed
+  (two SHA-256 blocks per 32 output bytes). Every seed comes from the IC:
+    begin()     64 bytes from the IC (256-bit entropy input plus the nonce)
+    reseed()    32 fresh bytes from the IC
+  A reseed happens on its own every DRBG_RESEED_INTERVAL generate() calls (setReseedInterval()),
+  or before every generate() call with prediction resistance on (setPredictionResistance()).
+
+  https://github.com/sparkfun/SparkFun_ATECCX08A_Arduino_Library
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "SparkFun_ATECCX08a_Arduino_Library.h"
+#include "SparkFun_ATECCX08a_SHA256.h"
+
+#define DRBG_SEED_SIZE				32 // entropy input per seed (security strength 256 bits)
+#define DRBG_RESEED_INTERVAL		1024 // generate() calls between reseeds (SP 800-90A allows up to 2^48)
+#define DRBG_MAX_REQUEST			65536 // bytes per SP 800-90A request, generate() splits longer ones
+
+class ATECCX08A_DRBG {
+  public:
+	ATECCX08A_DRBG(ATECCX08A &device);
+	~ATECCX08A_DRBG();
+
+	bool begin(const uint8_t *personalization = NULL, size_t length = 0); // instantiate, seeded from the IC
+	bool reseed(const uint8_t *additional = NULL, size_t length = 0); // fresh seed from the IC
+	bool generate(uint8_t *output, size_t length, const uint8_t *additional = NULL, size_t additionalLength = 0);
+	void clear(); // wipes the state, generate() fails until the next begin()
+
+	void setReseedInterval(uint32_t requests); // generate() calls between reseeds, 0 = DRBG_RESEED_INTERVAL
+	void setPredictionResistance(bool enabled); // reseed from the IC before every generate()
+	uint32_t reseedCounter(); // generate() calls since the last (re)seed
+
+  private:
+	ATECCX08A &_device;
+
+	uint8_t _key[SHA256_SIZE]; // K
+	uint8_t _value[SHA256_SIZE]; // V
+	ATECCX08A_SHA256 _inner; // SHA-256 state after (K ^ ipad), so each HMAC starts one block in
+	ATECCX08A_SHA256 _outer; // SHA-256 state after (K ^ opad)
+
+	bool _seeded = false;
+	bool _predictionResistance = false;
+	uint32_t _reseedCounter = 0;
+	uint32_t _reseedInterval = DRBG_RESEED_INTERVAL;
+
+	void setKey();
+	void hmacFinish(ATECCX08A_SHA256 *sha, uint8_t *mac);
+	void nextValue();
+	void update(const uint8_t *data1, size_t length1, const uint8_t *data2 = NULL, size_t length2 = 0);
+	bool seed(bool instantiate, const uint8_t *data, size_t length);
+	bool generateRequest(uint8_t *output, size_t length, const uint8_t *additional, size_t additionalLength);
+};
@@ -0,0 +1,230 @@
+/*
+  This is a library written for the ATECCX08A Criptographic Co-Processor (QWIIC).
+
+  Pool of ephemeral ECC key pairs, see SparkFun_ATECCX08a_KeyPool.h
+
+  https://github.com/sparkfun/SparkFun_ATECCX08A_Arduino_Library
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "SparkFun_ATECCX08a_KeyPool.h"
+
+ATECCX08A_KeyPool::ATECCX08A_KeyPool(ATECCX08A &device) : _device(device)
+{
+}
+
+/** \brief
+
+	begin(const uint16_t *slots, uint8_t count)
+
+	Sets up the pool with count slots (up to KEYPOOL_MAX_SLOTS). The keys already in them
+	are not trusted (they may have been used before a reset), so every slot starts empty.
+	Checks the slot config (readConfigZone() first): each slot must hold an ECC private key
+	that GENKEY may replace. Returns false, with an empty pool, if one does not.
+*/
+
+bool ATECCX08A_KeyPool::begin(const uint16_t *slots, uint8_t count)
+{
+  _count = 0;
+  _generating = -1;
+
+  if (count > KEYPOOL_MAX_SLOTS)
+    return false;
+
+  for (uint8_t i = 0; i < count; i++)
+  {
+    // same rule as createNewKeyPair(): GenKey needs the WriteConfig bit once the data zone is locked
+    if (!_device.slotAllows(slots[i], SLOT_ECC_PRIVATE) || (_device.dataOTPLockStatus && !_device.slotAllows(slots[i], SLOT_ALLOW_GENKEY)))
+      return false;
+  }
+
+  for (uint8_t i = 0; i < count; i++)
+  {
+    _entries[i].slot = slots[i];
+    _entries[i].state = KEYPOOL_EMPTY;
+    _entries[i].generations = 0;
+  }
+  _count = count;
+
+  return true;
+}
+
+/** \brief
+
+	service()
+
+	Does one step of the refill, and returns right away: finishes the running GENKEY once
+	the IC is done with it, or starts a GENKEY for an empty slot. Call it from loop().
+	Returns true if it finished or started a GENKEY.
+	While a GENKEY runs, other calls to the IC first wait for it (see ATECCX08A::startCommand()),
+	so call it when the IC would otherwise sit idle.
+*/
+
+bool ATECCX08A_KeyPool::service()
+{
+  if (_generating >= 0)
+  {
+    if (_device.commandRunning() && !_device.commandReady())
+      return false;
+
+    finish();
+    return true;
+  }
+
+  int8_t next = leastUsed(KEYPOOL_EMPTY);
+  if (next < 0)
+    return false;
+
+  if (!_device.startCommand(COMMAND_OPCODE_GENKEY, GENKEY_MODE_NEW_PRIVATE, _entries[next].slot))
+    return false;
+
+  _entries[next].state = KEYPOOL_GENERATING;
+  _generating = next;
+
+  return true;
+}
+
+/** \brief
+
+	fill()
+
+	Generates a key in every empty slot, and waits for them (up to 115 ms each).
+	Returns false if a GENKEY failed (that slot stays empty).
+*/
+
+bool ATECCX08A_KeyPool::fill()
+{
+  if (_generating >= 0)
+    finish(); // a failed one is empty again, and refilled below
+
+  for (int8_t next = leastUsed(KEYPOOL_EMPTY); next >= 0; next = leastUsed(KEYPOOL_EMPTY))
+  {
+    _entries[next].state = KEYPOOL_GENERATING; // taken out of the search, even if it fails
+    _generating = next;
+
+    if (!_device.startCommand(COMMAND_OPCODE_GENKEY, GENKEY_MODE_NEW_PRIVATE, _entries[next].slot) || !finish())
+    {
+      _entries[next].state = KEYPOOL_EMPTY;
+      _generating = -1;
+      return false;
+    }
+  }
+
+  return true;
+}
+
+// reads the running GENKEY's public key, the slot is ready (or empty again if it failed)
+bool ATECCX08A_KeyPool::finish()
+{
+  Entry *entry = &_entries[_generating];
+
+  _generating = -1;
+
+  // finishCommand() fails if another call already finished it (and the response is gone)
+  if (!_device.finishCommand(entry->publicKey, PUBLIC_KEY_SIZE))
+  {
+    entry->state = KEYPOOL_EMPTY;
+    return false;
+  }
+
+  entry->generations++;
+  entry->state = KEYPOOL_READY;
+
+  return true;
+}
+
+/** \brief
+
+	take(uint8_t *publicKey)
+
+	Hands out a ready slot: its number, and its public key (64 bytes, X and Y) in publicKey.
+	No bus traffic. Returns -1 if no slot is ready (service() has not caught up).
+	The slot is in use until release(): its key stays as it is.
+*/
+
+int8_t ATECCX08A_KeyPool::take(uint8_t *publicKey)
+{
+  int8_t index = leastUsed(KEYPOOL_READY);
+
+  if (index < 0)
+    return -1;
+
+  _entries[index].state = KEYPOOL_IN_USE;
+  if (publicKey)
+    memcpy(publicKey, _entries[index].publicKey, PUBLIC_KEY_SIZE);
+
+  return _entries[index].slot;
+}
+
+/** \brief
+
+	release(uint16_t slot)
+
+	Call once the key from take() is no longer needed. service() replaces it with a new one.
+*/
+
+void ATECCX08A_KeyPool::release(uint16_t slot)
+{
+  Entry *entry = find(slot);
+
+  if (entry && (entry->state == KEYPOOL_IN_USE))
+    entry->state = KEYPOOL_EMPTY;
+}
+
+uint8_t ATECCX08A_KeyPool::ready()
+{
+  uint8_t count = 0;
+
+  for (uint8_t i = 0; i < _count; i++)
+  {
+    if (_entries[i].state == KEYPOOL_READY)
+      count++;
+  }
+
+  return count;
+}
+
+uint8_t ATECCX08A_KeyPool::state(uint16_t slot)
+{
+  Entry *entry = find(slot);
+
+  return entry ? entry->state : KEYPOOL_EMPTY;
+}
+
+unsigned long ATECCX08A_KeyPool::generations(uint16_t slot)
+{
+  Entry *entry = find(slot);
+
+  return entry ? entry->generations : 0;
+}
+
+ATECCX08A_KeyPool::Entry *ATECCX08A_KeyPool::find(uint16_t slot)
+{
+  for (uint8_t i = 0; i < _count; i++)
+  {
+    if (_entries[i].slot == slot)
+      return &_entries[i];
+  }
+
+  return NULL;
+}
+
+int8_t ATECCX08A_KeyPool::leastUsed(uint8_t state)
+{
+  int8_t best = -1;
+
+  for (uint8_t i = 0; i < _count; i++)
+  {
+    if ((_entries[i].state == state) && ((best < 0) || (_entries[i].generations < _entries[best].generations)))
+      best = i;
+  }
+
+  return best;
+}
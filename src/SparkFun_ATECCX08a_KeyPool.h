@@ -0,0 +1,82 @@
+/*
+  This is a library written for the ATECCX08A Criptographic Co-Processor (QWIIC).
+
+  Pool of ephemeral ECC key pairs, generated ahead of time.
+
+  GENKEY takes up to 115 ms. A protocol that uses a fresh key pair per session (ephemeral
+  ECDH, one-time signing keys) would pay that at the start of every handshake. The pool
+  keeps a few slots with fresh keys ready instead: take() hands out a ready slot and its
+  public key (cached in RAM) straight away, with no bus traffic. Slots that were used and
+  release()d get a new key from service(), called from loop(), which runs GENKEY through
+  the non-blocking path (ATECCX08A::startCommand()), so the sketch never waits for it.
+
+    pool.begin(slots, count);   // every slot needs a new key
+    pool.fill();                // blocking, e.g. in setup()
+    ...
+    int8_t slot = pool.take(publicKey); // ready slot, -1 if none
+    atecc.ecdh(slot, peerKey, secret);
+    pool.release(slot);         // the key gets replaced
+    ...
+    pool.service();             // every loop(), never waits for the IC
+
+  Each GENKEY writes the slot's EEPROM. take() hands out the ready slot with the fewest
+  generations, and service() refills the emptied slot with the fewest generations first,
+  so the writes are spread evenly across the pool.
+
+  The slots must hold ECC private keys that GENKEY may write after the data zone is locked
+  (KeyConfig.Private, SlotConfig.WriteConfig GenKey bit), see slotAllows().
+
+  https://github.com/sparkfun/SparkFun_ATECCX08A_Arduino_Library
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "SparkFun_ATECCX08a_Arduino_Library.h"
+
+#define KEYPOOL_MAX_SLOTS			8
+
+#define KEYPOOL_EMPTY				0 // needs a new key
+#define KEYPOOL_GENERATING			1 // GENKEY started
+#define KEYPOOL_READY				2 // fresh key, public key cached
+#define KEYPOOL_IN_USE				3 // handed out by take(), until release()
+
+class ATECCX08A_KeyPool {
+  public:
+	ATECCX08A_KeyPool(ATECCX08A &device);
+
+	bool begin(const uint16_t *slots, uint8_t count); // false if a slot can not take new keys (nothing else happens)
+	bool service(); // call often: starts or finishes one GENKEY, never waits. True if it did something
+	bool fill(); // blocking: new keys in every empty slot now
+
+	int8_t take(uint8_t *publicKey = NULL); // a ready slot (public key copied out), -1 if none is ready
+	void release(uint16_t slot); // done with the key, it gets replaced
+
+	uint8_t ready(); // slots take() can hand out right now
+	uint8_t state(uint16_t slot); // KEYPOOL_*, KEYPOOL_EMPTY for slots not in the pool
+	unsigned long generations(uint16_t slot); // keys generated in slot since begin()
+
+  private:
+	typedef struct {
+		uint16_t slot;
+		uint8_t state;
+		unsigned long generations;
+		uint8_t publicKey[PUBLIC_KEY_SIZE];
+	} Entry;
+
+	ATECCX08A &_device;
+	Entry _entries[KEYPOOL_MAX_SLOTS];
+	uint8_t _count = 0;
+	int8_t _generating = -1; // entry with a GENKEY running
+
+	Entry *find(uint16_t slot);
+	int8_t leastUsed(uint8_t state); // entry in state with the fewest generations, -1 if none
+	bool finish();
+};
@@ -0,0 +1,343 @@
+/*
+  This is a library written for the ATECCX08A Criptographic Co-Processor (QWIIC).
+
+  Framed challenge-response transport over a Stream, see SparkFun_ATECCX08a_Link.h
+
+  https://github.com/sparkfun/SparkFun_ATECCX08A_Arduino_Library
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "SparkFun_ATECCX08a_Link.h"
+
+#define LINK_FRAME_INCOMPLETE	0
+#define LINK_FRAME_VALID		1
+#define LINK_FRAME_BAD			-1
+
+// CRC-16 with the IC's polynomial (0x8005, bits in LSB first), the same algorithm as atca_calculate_crc().
+// Not that routine itself: it leaves its result in the device's crc[], which a command on another thread also uses.
+static uint16_t linkCrc(const uint8_t *data, size_t length)
+{
+  uint16_t crc_register = 0;
+
+  for (size_t counter = 0; counter < length; counter++)
+  {
+    for (uint8_t shift_register = 0x01; shift_register > 0x00; shift_register <<= 1)
+    {
+      uint8_t data_bit = (data[counter] & shift_register) ? 1 : 0;
+      uint8_t crc_bit = crc_register >> 15;
+      crc_register <<= 1;
+      if (data_bit != crc_bit)
+        crc_register ^= 0x8005;
+    }
+  }
+
+  return crc_register;
+}
+
+ATECCX08A_Link::ATECCX08A_Link(ATECCX08A &device, Stream &port) : _device(device), _port(&port)
+{
+  memset(_pending, 0, sizeof(_pending));
+}
+
+/** \brief
+
+	send(uint8_t type, uint8_t sequence, const uint8_t *payload, uint8_t length)
+
+	Sends one frame, in a single write to the port.
+	Returns false if length is over LINK_MAX_PAYLOAD, or if the port did not take the whole frame.
+*/
+
+bool ATECCX08A_Link::send(uint8_t type, uint8_t sequence, const uint8_t *payload, uint8_t length)
+{
+  uint8_t frame[LINK_FRAME_MAX_SIZE];
+
+  if (length > LINK_MAX_PAYLOAD)
+    return false;
+
+  frame[0] = LINK_SOF;
+  frame[1] = type;
+  frame[2] = sequence;
+  frame[3] = length;
+  if (length)
+    memcpy(&frame[LINK_HEADER_SIZE], payload, length);
+
+  uint16_t crc = linkCrc(&frame[1], LINK_HEADER_SIZE - 1 + length);
+  frame[LINK_HEADER_SIZE + length] = crc & 0xFF;
+  frame[LINK_HEADER_SIZE + length + 1] = crc >> 8;
+
+  size_t size = LINK_HEADER_SIZE + length + CRC_SIZE;
+  return (_port->write(frame, size) == size);
+}
+
+/** \brief
+
+	receive(ATECCX08A_LinkFrame *frame)
+
+	Call it often (e.g. every loop()). Reads the bytes that have arrived so far, and returns
+	true when a whole frame with a good CRC is in frame. Never waits for bytes.
+	Bytes after the frame stay in the port, or in the receive buffer, for the next call.
+	Also drops a frame that stopped arriving (a lost byte), and challenges that timed out.
+*/
+
+bool ATECCX08A_Link::receive(ATECCX08A_LinkFrame *frame)
+{
+  expireChallenges();
+
+  if (parse(frame)) // whole frames left over from the last call
+    return true;
+
+  if (_rxLength && ((millis() - _lastByteMillis) > LINK_BYTE_TIMEOUT_MS))
+  {
+    _droppedFrames++;
+    resync(); // a byte went missing, look for the next frame in what we have
+    if (parse(frame))
+      return true;
+  }
+
+  while (_port->available() > 0)
+  {
+    int input = _port->read();
+    if (input < 0)
+      break;
+
+    _rx[_rxLength++] = input;
+    _lastByteMillis = millis();
+
+    if (parse(frame))
+      return true;
+  }
+
+  return false;
+}
+
+// takes a frame out of _rx[] if there is a whole one, dropping bad frames on the way
+bool ATECCX08A_Link::parse(ATECCX08A_LinkFrame *frame)
+{
+  while (_rxLength)
+  {
+    int8_t state = checkFrame();
+
+    if (state == LINK_FRAME_INCOMPLETE)
+      return false;
+
+    if (state == LINK_FRAME_VALID)
+    {
+      frame->type = _rx[1];
+      frame->sequence = _rx[2];
+      frame->length = _rx[3];
+      memcpy(frame->payload, &_rx[LINK_HEADER_SIZE], frame->length);
+
+      // keep what came after it (e.g. more frames found by resync()) for the next call
+      uint8_t size = LINK_HEADER_SIZE + frame->length + CRC_SIZE;
+      _rxLength -= size;
+      memmove(_rx, &_rx[size], _rxLength);
+      return true;
+    }
+
+    if (_rx[0] == LINK_SOF)
+      _droppedFrames++; // not counting noise between frames
+    resync();
+  }
+
+  return false;
+}
+
+unsigned long ATECCX08A_Link::droppedFrames()
+{
+  return _droppedFrames;
+}
+
+// LINK_FRAME_INCOMPLETE, LINK_FRAME_VALID or LINK_FRAME_BAD for the bytes in _rx[]
+int8_t ATECCX08A_Link::checkFrame()
+{
+  if (_rx[0] != LINK_SOF)
+    return LINK_FRAME_BAD;
+
+  if (_rxLength < LINK_HEADER_SIZE)
+    return LINK_FRAME_INCOMPLETE;
+
+  if (_rx[3] > LINK_MAX_PAYLOAD)
+    return LINK_FRAME_BAD;
+
+  uint8_t size = LINK_HEADER_SIZE + _rx[3] + CRC_SIZE;
+  if (_rxLength < size)
+    return LINK_FRAME_INCOMPLETE;
+
+  uint16_t crc = linkCrc(&_rx[1], size - 1 - CRC_SIZE);
+  if ((_rx[size - 2] != (crc & 0xFF)) || (_rx[size - 1] != (crc >> 8)))
+    return LINK_FRAME_BAD;
+
+  return LINK_FRAME_VALID;
+}
+
+// drops the first byte, and everything up to the next LINK_SOF
+void ATECCX08A_Link::resync()
+{
+  uint8_t start = 1;
+
+  while ((start < _rxLength) && (_rx[start] != LINK_SOF))
+    start++;
+
+  _rxLength -= start;
+  memmove(_rx, &_rx[start], _rxLength);
+}
+
+/** \brief
+
+	sendRequest(uint8_t *sequenceOut)
+
+	Prover side: asks the verifier for a challenge, with a new sequence number.
+	The challenge comes back with the same sequence number.
+*/
+
+bool ATECCX08A_Link::sendRequest(uint8_t *sequenceOut)
+{
+  uint8_t sequence = _sequence++;
+
+  if (sequenceOut)
+    *sequenceOut = sequence;
+
+  return send(LINK_TYPE_REQUEST, sequence);
+}
+
+/** \brief
+
+	sendResponse(ATECCX08A_LinkFrame *challenge, uint16_t slot)
+
+	Prover side: signs the challenge in a LINK_TYPE_CHALLENGE frame with the private key
+	in slot (see ATECCX08A::respondToChallenge()), and sends the signature back with the
+	challenge's sequence number.
+*/
+
+bool ATECCX08A_Link::sendResponse(ATECCX08A_LinkFrame *challenge, uint16_t slot)
+{
+  uint8_t signature[SIGNATURE_SIZE];
+
+  if ((challenge->type != LINK_TYPE_CHALLENGE) || (challenge->length != CHALLENGE_SIZE))
+    return false;
+
+  if (!_device.respondToChallenge(challenge->payload, slot, signature))
+    return false;
+
+  return send(LINK_TYPE_RESPONSE, challenge->sequence, signature, SIGNATURE_SIZE);
+}
+
+/** \brief
+
+	sendChallenge(uint8_t sequence)
+
+	Verifier side: creates a new challenge on the IC, remembers it under sequence, and sends it.
+	Fails if LINK_PENDING_CHALLENGES challenges are already waiting for an answer.
+	The challenges come from the RNG (CHALLENGE_MODE_RANDOM), as TempKey can only hold one
+	at a time. They are kept here instead, and each one can be answered once, before it expires.
+*/
+
+bool ATECCX08A_Link::sendChallenge(uint8_t sequence)
+{
+  Pending *slot = NULL;
+
+  expireChallenges();
+
+  for (uint8_t i = 0; i < LINK_PENDING_CHALLENGES; i++)
+  {
+    if (_pending[i].used && (_pending[i].sequence == sequence))
+      _pending[i].used = false; // the prover asked again, the old challenge is void
+
+    if (!_pending[i].used && (slot == NULL))
+      slot = &_pending[i];
+  }
+
+  if (slot == NULL)
+    return false;
+
+  if (!_device.issueChallenge(slot->challenge, CHALLENGE_MODE_RANDOM))
+    return false;
+
+  if (!send(LINK_TYPE_CHALLENGE, sequence, slot->challenge, CHALLENGE_SIZE))
+    return false;
+
+  slot->used = true;
+  slot->sequence = sequence;
+  slot->sentMillis = millis();
+
+  return true;
+}
+
+/** \brief
+
+	checkResponse(ATECCX08A_LinkFrame *response, uint8_t *publicKey)
+
+	Verifier side: checks the signature in a LINK_TYPE_RESPONSE frame against the pending
+	challenge with the same sequence number, and the prover's public key.
+	The result goes back to the prover in a LINK_TYPE_RESULT frame.
+	A response to an unknown, expired or already answered challenge is rejected without using the IC.
+*/
+
+bool ATECCX08A_Link::checkResponse(ATECCX08A_LinkFrame *response, uint8_t *publicKey)
+{
+  bool result = false;
+
+  if (response->type != LINK_TYPE_RESPONSE)
+    return false;
+
+  expireChallenges();
+
+  if (response->length == SIGNATURE_SIZE)
+  {
+    for (uint8_t i = 0; i < LINK_PENDING_CHALLENGES; i++)
+    {
+      if (_pending[i].used && (_pending[i].sequence == response->sequence))
+      {
+        _pending[i].used = false; // each challenge is good for one answer
+        result = _device.checkResponse(_pending[i].challenge, response->payload, publicKey);
+        break;
+      }
+    }
+  }
+
+  uint8_t verified = result ? 1 : 0;
+  send(LINK_TYPE_RESULT, response->sequence, &verified, 1);
+
+  return result;
+}
+
+void ATECCX08A_Link::setChallengeTimeout(unsigned long ms)
+{
+  _challengeTimeout = ms;
+}
+
+uint8_t ATECCX08A_Link::pendingChallenges()
+{
+  uint8_t count = 0;
+
+  expireChallenges();
+
+  for (uint8_t i = 0; i < LINK_PENDING_CHALLENGES; i++)
+  {
+    if (_pending[i].used)
+      count++;
+  }
+
+  return count;
+}
+
+void ATECCX08A_Link::expireChallenges()
+{
+  for (uint8_t i = 0; i < LINK_PENDING_CHALLENGES; i++)
+  {
+    if (_pending[i].used && ((millis() - _pending[i].sentMillis) > _challengeTimeout))
+      _pending[i].used = false;
+  }
+}
+
+bool ATECCX08A_Link::sendPublicKey(uint8_t *publicKey, uint8_t sequence)
+{
+  return send(LINK_TYPE_PUBLIC_KEY, sequence, publicKey, PUBLIC_KEY_SIZE);
+}
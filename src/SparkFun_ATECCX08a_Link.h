@@ -0,0 +1,109 @@
+/*
+  This is a library written for the ATECCX08A Criptographic Co-Processor (QWIIC).
+
+  Framed transport for challenge-response authentication between two boards,
+  over any Stream (Serial1, SoftwareSerial, a TCP client, ...).
+
+  Frame layout:
+    0     LINK_SOF (0xA5)
+    1     message type, LINK_TYPE_*
+    2     sequence number, a response carries the sequence number of its challenge
+    3     payload length (0 to LINK_MAX_PAYLOAD)
+    4-    payload
+    last2 CRC-16 (same polynomial as the IC) of bytes 1 to the end of the payload, LSB first
+
+  receive() never blocks: it parses whatever bytes have arrived, and returns true once a
+  whole frame with a good CRC is in. A frame with a bad CRC (or a lost byte) is dropped,
+  and the parser picks up again at the next LINK_SOF, so a noisy link loses one exchange
+  instead of hanging the handshake. Several challenges can be in flight at once, each
+  one is matched to its response by sequence number and expires after a timeout.
+
+  Verifier (Bob)                             Prover (Alice)
+                      <-- LINK_TYPE_REQUEST    sendRequest()
+  sendChallenge()     LINK_TYPE_CHALLENGE -->
+                      <-- LINK_TYPE_RESPONSE   sendResponse(), signs with the IC
+  checkResponse()     LINK_TYPE_RESULT -->
+
+  https://github.com/sparkfun/SparkFun_ATECCX08A_Arduino_Library
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "SparkFun_ATECCX08a_Arduino_Library.h"
+
+#define LINK_SOF					0xA5
+#define LINK_HEADER_SIZE			4 // SOF, type, sequence, length
+#define LINK_MAX_PAYLOAD			64
+#define LINK_FRAME_MAX_SIZE			(LINK_HEADER_SIZE + LINK_MAX_PAYLOAD + CRC_SIZE)
+
+#define LINK_TYPE_REQUEST			0x01 // prover asks for a challenge, no payload
+#define LINK_TYPE_CHALLENGE			0x02 // 32-byte challenge
+#define LINK_TYPE_RESPONSE			0x03 // 64-byte signature of the challenge
+#define LINK_TYPE_PUBLIC_KEY		0x04 // 64-byte public key (X,Y)
+#define LINK_TYPE_RESULT			0x05 // 1 byte, 1 = response verified, 0 = not
+
+#define LINK_BYTE_TIMEOUT_MS		20 // a frame that stops arriving for this long is dropped
+#define LINK_CHALLENGE_TIMEOUT_MS	1000 // default time a prover has to answer a challenge
+#define LINK_PENDING_CHALLENGES		4 // challenges in flight at once (verifier side)
+
+typedef struct {
+  uint8_t type;
+  uint8_t sequence;
+  uint8_t length;
+  uint8_t payload[LINK_MAX_PAYLOAD];
+} ATECCX08A_LinkFrame;
+
+class ATECCX08A_Link {
+  public:
+	ATECCX08A_Link(ATECCX08A &device, Stream &port);
+
+	// frames
+	bool send(uint8_t type, uint8_t sequence, const uint8_t *payload = NULL, uint8_t length = 0);
+	bool receive(ATECCX08A_LinkFrame *frame); // non-blocking, true once a whole valid frame is in
+	unsigned long droppedFrames(); // frames lost to bad CRCs, bad lengths or byte timeouts
+
+	// prover
+	bool sendRequest(uint8_t *sequenceOut = NULL); // ask the verifier for a challenge
+	bool sendResponse(ATECCX08A_LinkFrame *challenge, uint16_t slot = 0x0000); // sign a LINK_TYPE_CHALLENGE frame, and send the signature
+
+	// verifier
+	bool sendChallenge(uint8_t sequence); // e.g. the sequence number of a LINK_TYPE_REQUEST
+	bool checkResponse(ATECCX08A_LinkFrame *response, uint8_t *publicKey); // verify a LINK_TYPE_RESPONSE frame, and send the result
+	void setChallengeTimeout(unsigned long ms);
+	uint8_t pendingChallenges(); // sent, not answered and not expired yet
+
+	bool sendPublicKey(uint8_t *publicKey, uint8_t sequence = 0);
+
+  private:
+	typedef struct {
+		bool used;
+		uint8_t sequence;
+		uint8_t challenge[CHALLENGE_SIZE];
+		unsigned long sentMillis;
+	} Pending;
+
+	ATECCX08A &_device;
+	Stream *_port;
+
+	uint8_t _rx[LINK_FRAME_MAX_SIZE];
+	uint8_t _rxLength = 0;
+	unsigned long _lastByteMillis = 0;
+	unsigned long _droppedFrames = 0;
+	bool parse(ATECCX08A_LinkFrame *frame);
+	int8_t checkFrame(); // see LINK_FRAME_* in the .cpp
+	void resync();
+
+	uint8_t _sequence = 0;
+
+	Pending _pending[LINK_PENDING_CHALLENGES];
+	unsigned long _challengeTimeout = LINK_CHALLENGE_TIMEOUT_MS;
+	void expireChallenges();
+};
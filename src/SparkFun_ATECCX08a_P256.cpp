@@ -0,0 +1,506 @@
+/*
+  This is a library written for the ATECCX08A Criptographic Co-Processor (QWIIC).
+
+  Software ECDSA P-256 signature verification (FIPS 186-4, SEC 1).
+
+  https://github.com/sparkfun/SparkFun_ATECCX08A_Arduino_Library
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "SparkFun_ATECCX08a_P256.h"
+
+// Curve constants, big-endian
+static const uint8_t p256Prime[32] PROGMEM = {
+  0xFF, 0xFF, 0xFF, 0xFF, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF
+};
+
+static const uint8_t p256Order[32] PROGMEM = {
+  0xFF, 0xFF, 0xFF, 0xFF, 0x00, 0x00, 0x00, 0x00, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+  0xBC, 0xE6, 0xFA, 0xAD, 0xA7, 0x17, 0x9E, 0x84, 0xF3, 0xB9, 0xCA, 0xC2, 0xFC, 0x63, 0x25, 0x51
+};
+
+static const uint8_t p256B[32] PROGMEM = {
+  0x5A, 0xC6, 0x35, 0xD8, 0xAA, 0x3A, 0x93, 0xE7, 0xB3, 0xEB, 0xBD, 0x55, 0x76, 0x98, 0x86, 0xBC,
+  0x65, 0x1D, 0x06, 0xB0, 0xCC, 0x53, 0xB0, 0xF6, 0x3B, 0xCE, 0x3C, 0x3E, 0x27, 0xD2, 0x60, 0x4B
+};
+
+static const uint8_t p256G[64] PROGMEM = {
+  0x6B, 0x17, 0xD1, 0xF2, 0xE1, 0x2C, 0x42, 0x47, 0xF8, 0xBC, 0xE6, 0xE5, 0x63, 0xA4, 0x40, 0xF2,
+  0x77, 0x03, 0x7D, 0x81, 0x2D, 0xEB, 0x33, 0xA0, 0xF4, 0xA1, 0x39, 0x45, 0xD8, 0x98, 0xC2, 0x96,
+  0x4F, 0xE3, 0x42, 0xE2, 0xFE, 0x1A, 0x7F, 0x9B, 0x8E, 0xE7, 0xEB, 0x4A, 0x7C, 0x0F, 0x9E, 0x16,
+  0x2B, 0xCE, 0x33, 0x57, 0x6B, 0x31, 0x5E, 0xCE, 0xCB, 0xB6, 0x40, 0x68, 0x37, 0xBF, 0x51, 0xF5
+};
+
+// R^2 mod p and R^2 mod n, R = 2^256 (the same for 32 and 64-bit limbs)
+static const uint8_t p256PrimeR2[32] PROGMEM = {
+  0x00, 0x00, 0x00, 0x04, 0xFF, 0xFF, 0xFF, 0xFD, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFE,
+  0xFF, 0xFF, 0xFF, 0xFB, 0xFF, 0xFF, 0xFF, 0xFF, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x03
+};
+
+static const uint8_t p256OrderR2[32] PROGMEM = {
+  0x66, 0xE1, 0x2D, 0x94, 0xF3, 0xD9, 0x56, 0x20, 0x28, 0x45, 0xB2, 0x39, 0x2B, 0x6B, 0xEC, 0x59,
+  0x46, 0x99, 0x79, 0x9C, 0x49, 0xBD, 0x6F, 0xA6, 0x83, 0x24, 0x4C, 0x95, 0xBE, 0x79, 0xEE, 0xA2
+};
+
+#if (256 % ATECCX08A_P256_WINDOW_BITS)
+#error "ATECCX08A_P256_WINDOW_BITS must be 1, 2 or 4"
+#endif
+
+#define P256_WINDOW_SIZE (1 << ATECCX08A_P256_WINDOW_BITS)
+#define P256_TABLE_SIZE (P256_WINDOW_SIZE * P256_WINDOW_SIZE)
+
+typedef p256_limb_t p256_fe[P256_LIMBS]; // little-endian limbs
+
+typedef struct {
+  p256_fe m;
+  p256_fe r2;
+  p256_limb_t mPrime; // -m^-1 mod 2^P256_LIMB_BITS
+} P256Modulus;
+
+typedef struct {
+  p256_fe x, y, z; // Jacobian, Montgomery form. z = 0 is the point at infinity
+} P256Point;
+
+/* Big-endian bytes to limbs */
+static void p256FromBytes(p256_fe out, const uint8_t *in)
+{
+  for (uint8_t i = 0; i < P256_LIMBS; i++)
+  {
+    p256_limb_t limb = 0;
+    for (uint8_t j = 0; j < (P256_LIMB_BITS / 8); j++)
+      limb = (limb << 8) | in[32 - (i + 1) * (P256_LIMB_BITS / 8) + j];
+    out[i] = limb;
+  }
+}
+
+static void p256FromBytes_P(p256_fe out, const uint8_t *in)
+{
+  uint8_t bytes[32];
+  memcpy_P(bytes, in, sizeof(bytes));
+  p256FromBytes(out, bytes);
+}
+
+/* Returns 1 if a < b, in constant time */
+static p256_limb_t p256Less(const p256_fe a, const p256_fe b)
+{
+  p256_limb_t borrow = 0;
+  for (uint8_t i = 0; i < P256_LIMBS; i++)
+  {
+    p256_dlimb_t d = (p256_dlimb_t)a[i] - b[i] - borrow;
+    borrow = (p256_limb_t)(d >> P256_LIMB_BITS) & 1;
+  }
+  return borrow;
+}
+
+static bool p256IsZero(const p256_fe a)
+{
+  p256_limb_t bits = 0;
+  for (uint8_t i = 0; i < P256_LIMBS; i++)
+    bits |= a[i];
+  return bits == 0;
+}
+
+static bool p256Equal(const p256_fe a, const p256_fe b)
+{
+  p256_limb_t bits = 0;
+  for (uint8_t i = 0; i < P256_LIMBS; i++)
+    bits |= a[i] ^ b[i];
+  return bits == 0;
+}
+
+/* out = mask ? a : b */
+static void p256Select(p256_fe out, p256_limb_t mask, const p256_fe a, const p256_fe b)
+{
+  for (uint8_t i = 0; i < P256_LIMBS; i++)
+    out[i] = (a[i] & mask) | (b[i] & ~mask);
+}
+
+/* out = a + b mod m (a, b < m) */
+static void p256Add(p256_fe out, const p256_fe a, const p256_fe b, const P256Modulus *mod)
+{
+  p256_fe sum, reduced;
+  p256_limb_t carry = 0, borrow = 0;
+
+  for (uint8_t i = 0; i < P256_LIMBS; i++)
+  {
+    p256_dlimb_t s = (p256_dlimb_t)a[i] + b[i] + carry;
+    sum[i] = (p256_limb_t)s;
+    carry = (p256_limb_t)(s >> P256_LIMB_BITS);
+  }
+
+  for (uint8_t i = 0; i < P256_LIMBS; i++)
+  {
+    p256_dlimb_t d = (p256_dlimb_t)sum[i] - mod->m[i] - borrow;
+    reduced[i] = (p256_limb_t)d;
+    borrow = (p256_limb_t)(d >> P256_LIMB_BITS) & 1;
+  }
+
+  // keep the reduced value if the sum overflowed, or did not borrow
+  p256Select(out, (p256_limb_t)0 - (carry | (borrow ^ 1)), reduced, sum);
+}
+
+/* out = a - b mod m (a, b < m) */
+static void p256Sub(p256_fe out, const p256_fe a, const p256_fe b, const P256Modulus *mod)
+{
+  p256_fe difference, corrected;
+  p256_limb_t borrow = 0, carry = 0;
+
+  for (uint8_t i = 0; i < P256_LIMBS; i++)
+  {
+    p256_dlimb_t d = (p256_dlimb_t)a[i] - b[i] - borrow;
+    difference[i] = (p256_limb_t)d;
+    borrow = (p256_limb_t)(d >> P256_LIMB_BITS) & 1;
+  }
+
+  for (uint8_t i = 0; i < P256_LIMBS; i++)
+  {
+    p256_dlimb_t s = (p256_dlimb_t)difference[i] + mod->m[i] + carry;
+    corrected[i] = (p256_limb_t)s;
+    carry = (p256_limb_t)(s >> P256_LIMB_BITS);
+  }
+
+  p256Select(out, (p256_limb_t)0 - borrow, corrected, difference);
+}
+
+/* out = a * b / R mod m, Montgomery multiplication (CIOS). a * b must be < m * R */
+static void p256Mul(p256_fe out, const p256_fe a, const p256_fe b, const P256Modulus *mod)
+{
+  p256_limb_t t[P256_LIMBS + 2];
+  p256_fe reduced;
+  p256_limb_t borrow = 0;
+
+  memset(t, 0, sizeof(t));
+
+  for (uint8_t i = 0; i < P256_LIMBS; i++)
+  {
+    p256_dlimb_t c = 0;
+    for (uint8_t j = 0; j < P256_LIMBS; j++)
+    {
+      c += (p256_dlimb_t)a[j] * b[i] + t[j];
+      t[j] = (p256_limb_t)c;
+      c >>= P256_LIMB_BITS;
+    }
+    c += t[P256_LIMBS];
+    t[P256_LIMBS] = (p256_limb_t)c;
+    t[P256_LIMBS + 1] = (p256_limb_t)(c >> P256_LIMB_BITS);
+
+    p256_limb_t u = t[0] * mod->mPrime;
+    c = (p256_dlimb_t)u * mod->m[0] + t[0];
+    c >>= P256_LIMB_BITS;
+    for (uint8_t j = 1; j < P256_LIMBS; j++)
+    {
+      c += (p256_dlimb_t)u * mod->m[j] + t[j];
+      t[j - 1] = (p256_limb_t)c;
+      c >>= P256_LIMB_BITS;
+    }
+    c += t[P256_LIMBS];
+    t[P256_LIMBS - 1] = (p256_limb_t)c;
+    t[P256_LIMBS] = t[P256_LIMBS + 1] + (p256_limb_t)(c >> P256_LIMB_BITS);
+  }
+
+  // t < 2m, subtract m once if needed
+  for (uint8_t i = 0; i < P256_LIMBS; i++)
+  {
+    p256_dlimb_t d = (p256_dlimb_t)t[i] - mod->m[i] - borrow;
+    reduced[i] = (p256_limb_t)d;
+    borrow = (p256_limb_t)(d >> P256_LIMB_BITS) & 1;
+  }
+
+  p256Select(out, (p256_limb_t)0 - (t[P256_LIMBS] | (borrow ^ 1)), reduced, t);
+}
+
+static void p256ToMontgomery(p256_fe out, const p256_fe a, const P256Modulus *mod)
+{
+  p256Mul(out, a, mod->r2, mod);
+}
+
+static void p256FromMontgomery(p256_fe out, const p256_fe a, const P256Modulus *mod)
+{
+  p256_fe one;
+  memset(one, 0, sizeof(one));
+  one[0] = 1;
+  p256Mul(out, a, one, mod);
+}
+
+/* out = a^-1 mod m = a^(m-2), Montgomery form in and out. The exponent is public. */
+static void p256Invert(p256_fe out, const p256_fe a, const P256Modulus *mod)
+{
+  p256_fe exponent, result;
+  bool started = false;
+
+  memcpy(exponent, mod->m, sizeof(exponent));
+  exponent[0] -= 2; // m is odd and > 2, so no borrow
+
+  for (int16_t bit = 255; bit >= 0; bit--)
+  {
+    if (started)
+      p256Mul(result, result, result, mod);
+
+    if ((exponent[bit / P256_LIMB_BITS] >> (bit % P256_LIMB_BITS)) & 1)
+    {
+      if (started)
+        p256Mul(result, result, a, mod);
+      else
+        memcpy(result, a, sizeof(result));
+      started = true;
+    }
+  }
+
+  memcpy(out, result, sizeof(result));
+}
+
+static void p256InitModulus(P256Modulus *mod, const uint8_t *modulus, const uint8_t *r2)
+{
+  p256_limb_t inverse = 1;
+
+  p256FromBytes_P(mod->m, modulus);
+  p256FromBytes_P(mod->r2, r2);
+
+  // Newton iteration for m^-1 mod 2^bits, each step doubles the correct bits
+  for (uint8_t i = 0; i < 6; i++)
+    inverse *= 2 - mod->m[0] * inverse;
+
+  mod->mPrime = (p256_limb_t)0 - inverse;
+}
+
+/* Jacobian doubling for a = -3 (dbl-2001-b) */
+static void p256Double(P256Point *out, const P256Point *in, const P256Modulus *p)
+{
+  p256_fe delta, gamma, beta, alpha, t1, t2;
+
+  if (p256IsZero(in->z))
+  {
+    *out = *in;
+    return;
+  }
+
+  p256Mul(delta, in->z, in->z, p);
+  p256Mul(gamma, in->y, in->y, p);
+  p256Mul(beta, in->x, gamma, p);
+
+  p256Sub(t1, in->x, delta, p);
+  p256Add(t2, in->x, delta, p);
+  p256Mul(alpha, t1, t2, p);
+  p256Add(t1, alpha, alpha, p);
+  p256Add(alpha, t1, alpha, p); // alpha = 3 * (x - delta) * (x + delta)
+
+  p256Add(t1, in->y, in->z, p);
+  p256Mul(t1, t1, t1, p);
+  p256Sub(t1, t1, gamma, p);
+  p256Sub(out->z, t1, delta, p); // z3 = (y + z)^2 - gamma - delta
+
+  p256Add(t1, beta, beta, p);
+  p256Add(t1, t1, t1, p); // 4 * beta
+  p256Add(t2, t1, t1, p); // 8 * beta
+  p256Mul(out->x, alpha, alpha, p);
+  p256Sub(out->x, out->x, t2, p); // x3 = alpha^2 - 8 * beta
+
+  p256Sub(t1, t1, out->x, p);
+  p256Mul(t1, alpha, t1, p);
+  p256Mul(gamma, gamma, gamma, p);
+  p256Add(gamma, gamma, gamma, p);
+  p256Add(gamma, gamma, gamma, p);
+  p256Add(gamma, gamma, gamma, p); // 8 * gamma^2
+  p256Sub(out->y, t1, gamma, p); // y3 = alpha * (4 * beta - x3) - 8 * gamma^2
+}
+
+/* Jacobian addition (add-2007-bl). out may be the same as a or b. */
+static void p256AddPoints(P256Point *out, const P256Point *a, const P256Point *b, const P256Modulus *p)
+{
+  p256_fe z1z1, z2z2, u1, u2, s1, s2, h, i, j, r, v, t;
+
+  if (p256IsZero(a->z))
+  {
+    *out = *b;
+    return;
+  }
+  if (p256IsZero(b->z))
+  {
+    *out = *a;
+    return;
+  }
+
+  p256Mul(z1z1, a->z, a->z, p);
+  p256Mul(z2z2, b->z, b->z, p);
+  p256Mul(u1, a->x, z2z2, p);
+  p256Mul(u2, b->x, z1z1, p);
+  p256Mul(s1, a->y, b->z, p);
+  p256Mul(s1, s1, z2z2, p);
+  p256Mul(s2, b->y, a->z, p);
+  p256Mul(s2, s2, z1z1, p);
+
+  p256Sub(h, u2, u1, p);
+  p256Sub(r, s2, s1, p);
+
+  if (p256IsZero(h))
+  {
+    if (p256IsZero(r))
+    {
+      p256Double(out, a, p); // same point
+      return;
+    }
+    memset(out, 0, sizeof(P256Point)); // opposite points
+    return;
+  }
+
+  p256Add(r, r, r, p); // r = 2 * (s2 - s1)
+  p256Add(i, h, h, p);
+  p256Mul(i, i, i, p); // i = (2h)^2
+  p256Mul(j, h, i, p);
+  p256Mul(v, u1, i, p);
+
+  p256Add(t, a->z, b->z, p);
+  p256Mul(t, t, t, p);
+  p256Sub(t, t, z1z1, p);
+  p256Sub(t, t, z2z2, p);
+  p256Mul(out->z, t, h, p); // z3 = ((z1 + z2)^2 - z1z1 - z2z2) * h
+
+  p256Mul(t, r, r, p);
+  p256Sub(t, t, j, p);
+  p256Sub(t, t, v, p);
+  p256Sub(out->x, t, v, p); // x3 = r^2 - j - 2v
+
+  p256Sub(t, v, out->x, p);
+  p256Mul(t, r, t, p);
+  p256Mul(s1, s1, j, p);
+  p256Add(s1, s1, s1, p);
+  p256Sub(out->y, t, s1, p); // y3 = r * (v - x3) - 2 * s1 * j
+}
+
+/* Affine big-endian X||Y to a Jacobian point in Montgomery form. Returns false if not on the curve. */
+static bool p256LoadPoint(P256Point *out, const uint8_t *xy, const P256Modulus *p)
+{
+  p256_fe x, y, b, lhs, rhs, t;
+
+  p256FromBytes(x, &xy[0]);
+  p256FromBytes(y, &xy[32]);
+  if (!p256Less(x, p->m) || !p256Less(y, p->m))
+    return false;
+
+  p256ToMontgomery(out->x, x, p);
+  p256ToMontgomery(out->y, y, p);
+  memset(t, 0, sizeof(t));
+  t[0] = 1;
+  p256ToMontgomery(out->z, t, p);
+
+  // y^2 == x^3 - 3x + b
+  p256FromBytes_P(b, p256B);
+  p256ToMontgomery(b, b, p);
+  p256Mul(lhs, out->y, out->y, p);
+  p256Mul(rhs, out->x, out->x, p);
+  p256Mul(rhs, rhs, out->x, p);
+  p256Add(t, out->x, out->x, p);
+  p256Add(t, t, out->x, p);
+  p256Sub(rhs, rhs, t, p);
+  p256Add(rhs, rhs, b, p);
+
+  return p256Equal(lhs, rhs);
+}
+
+/* Returns bits [bit, bit + ATECCX08A_P256_WINDOW_BITS) of a scalar */
+static uint8_t p256Window(const p256_fe scalar, uint16_t bit)
+{
+  return (scalar[bit / P256_LIMB_BITS] >> (bit % P256_LIMB_BITS)) & (P256_WINDOW_SIZE - 1);
+}
+
+/** \brief
+
+	validPublicKey(const uint8_t *publicKey)
+
+	Returns true if the 64-byte X||Y public key is a point on the P-256 curve.
+*/
+
+bool ATECCX08A_P256::validPublicKey(const uint8_t *publicKey)
+{
+  P256Modulus p;
+  P256Point point;
+
+  p256InitModulus(&p, p256Prime, p256PrimeR2);
+  return p256LoadPoint(&point, publicKey, &p);
+}
+
+/** \brief
+
+	verify(const uint8_t *message, const uint8_t *signature, const uint8_t *publicKey)
+
+	Verifies an ECDSA P-256 signature (R||S) of a 32-byte message digest with a 64-byte X||Y public key,
+	in software. Gives the same result as the IC's VERIFY command in external mode.
+*/
+
+bool ATECCX08A_P256::verify(const uint8_t *message, const uint8_t *signature, const uint8_t *publicKey)
+{
+  P256Modulus p, n;
+  P256Point table[P256_TABLE_SIZE]; // table[i * P256_WINDOW_SIZE + j] = i*G + j*Q
+  P256Point result;
+  p256_fe r, s, e, w, u1, u2, zInverse, x;
+  uint8_t g[64];
+
+  p256InitModulus(&p, p256Prime, p256PrimeR2);
+  p256InitModulus(&n, p256Order, p256OrderR2);
+
+  // 1 <= r, s < n
+  p256FromBytes(r, &signature[0]);
+  p256FromBytes(s, &signature[32]);
+  if (p256IsZero(r) || p256IsZero(s) || !p256Less(r, n.m) || !p256Less(s, n.m))
+    return false;
+
+  memset(&table[0], 0, sizeof(P256Point)); // infinity
+  memcpy_P(g, p256G, sizeof(g));
+  p256LoadPoint(&table[P256_WINDOW_SIZE], g, &p);
+  if (!p256LoadPoint(&table[1], publicKey, &p))
+    return false;
+
+  // multiples of G in column 0 and of Q in row 0, then every sum
+  for (uint8_t i = 2; i < P256_WINDOW_SIZE; i++)
+  {
+    p256AddPoints(&table[i * P256_WINDOW_SIZE], &table[(i - 1) * P256_WINDOW_SIZE], &table[P256_WINDOW_SIZE], &p);
+    p256AddPoints(&table[i], &table[i - 1], &table[1], &p);
+  }
+  for (uint8_t i = 1; i < P256_WINDOW_SIZE; i++)
+  {
+    for (uint8_t j = 1; j < P256_WINDOW_SIZE; j++)
+      p256AddPoints(&table[i * P256_WINDOW_SIZE + j], &table[i * P256_WINDOW_SIZE], &table[j], &p);
+  }
+
+  // w = s^-1, u1 = e * w, u2 = r * w (mod n)
+  p256FromBytes(e, message);
+  p256ToMontgomery(e, e, &n); // also reduces e mod n
+  p256ToMontgomery(w, s, &n);
+  p256Invert(w, w, &n);
+  p256ToMontgomery(u1, r, &n);
+  p256Mul(u2, u1, w, &n);
+  p256Mul(u1, e, w, &n);
+  p256FromMontgomery(u1, u1, &n);
+  p256FromMontgomery(u2, u2, &n);
+
+  // u1*G + u2*Q, ATECCX08A_P256_WINDOW_BITS bits of each scalar at a time
+  memset(&result, 0, sizeof(result));
+  for (int16_t bit = 256 - ATECCX08A_P256_WINDOW_BITS; bit >= 0; bit -= ATECCX08A_P256_WINDOW_BITS)
+  {
+    for (uint8_t i = 0; i < ATECCX08A_P256_WINDOW_BITS; i++)
+      p256Double(&result, &result, &p);
+
+    p256AddPoints(&result, &result, &table[p256Window(u1, bit) * P256_WINDOW_SIZE + p256Window(u2, bit)], &p);
+  }
+
+  if (p256IsZero(result.z))
+    return false;
+
+  // affine x = X / Z^2, then x mod n must equal r
+  p256Invert(zInverse, result.z, &p);
+  p256Mul(zInverse, zInverse, zInverse, &p);
+  p256Mul(x, result.x, zInverse, &p);
+  p256FromMontgomery(x, x, &p);
+  if (!p256Less(x, n.m))
+    p256Sub(x, x, n.m, &n); // x < p < 2n
+
+  return p256Equal(x, r);
+}
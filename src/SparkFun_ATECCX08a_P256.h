@@ -0,0 +1,59 @@
+/*
+  This is a library written for the ATECCX08A Criptographic Co-Processor (QWIIC).
+
+  Software ECDSA P-256 signature verification.
+
+  Verifying only uses public data, so it can run on the host instead of the IC.
+  On fast microcontrollers (and on 64-bit hosts) it finishes sooner than the NONCE + VERIFY
+  round trip over I2C, and it leaves the IC (and its TempKey) free for other work.
+  ATECCX08A::verifySignature() chooses between the two, see setVerifyPolicy().
+
+  Field arithmetic is Montgomery multiplication with 32-bit limbs, or 64-bit limbs where the
+  compiler has a 128-bit integer type (64-bit hosts), without data dependent branches.
+  The double scalar multiplication u1*G + u2*Q uses a fixed window of
+  ATECCX08A_P256_WINDOW_BITS bits over both scalars at once.
+
+  https://github.com/sparkfun/SparkFun_ATECCX08A_Arduino_Library
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "SparkFun_ATECCX08a_Arduino_Library.h"
+
+// Window size for u1*G + u2*Q. The table holds (2^bits)^2 points of 96 bytes each,
+// so 1 (384 bytes) on AVR, 2 (1536 bytes) elsewhere. Must be 1, 2 or 4.
+#if !defined(ATECCX08A_P256_WINDOW_BITS)
+#if defined(__AVR__)
+#define ATECCX08A_P256_WINDOW_BITS 1
+#else
+#define ATECCX08A_P256_WINDOW_BITS 2
+#endif
+#endif
+
+// Define ATECCX08A_P256_32BIT_LIMBS to use 32-bit limbs even where 64-bit limbs are available
+#if defined(__SIZEOF_INT128__) && !defined(ATECCX08A_P256_32BIT_LIMBS)
+typedef uint64_t p256_limb_t;
+typedef unsigned __int128 p256_dlimb_t;
+#define P256_LIMB_BITS 64
+#else
+typedef uint32_t p256_limb_t;
+typedef uint64_t p256_dlimb_t;
+#define P256_LIMB_BITS 32
+#endif
+
+#define P256_LIMBS (256 / P256_LIMB_BITS)
+
+class ATECCX08A_P256 {
+  public:
+	// same arguments as ATECCX08A::verifySignature(): 32-byte message digest, R||S, X||Y
+	static bool verify(const uint8_t *message, const uint8_t *signature, const uint8_t *publicKey);
+	static bool validPublicKey(const uint8_t *publicKey); // coordinates in range and on the curve
+};
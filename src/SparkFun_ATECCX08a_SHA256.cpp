@@ -0,0 +1,186 @@
+/*
+  This is a library written for the ATECCX08A Criptographic Co-Processor (QWIIC).
+
+  Software SHA-256 (FIPS 180-4).
+
+  https://github.com/sparkfun/SparkFun_ATECCX08A_Arduino_Library
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "SparkFun_ATECCX08a_SHA256.h"
+
+// round constants, kept in flash on AVR
+static const uint32_t sha256RoundConstants[64] PROGMEM = {
+  0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+  0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+  0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+  0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+  0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+  0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+  0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+  0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+
+#define SHA256_ROTR(X, N) (((X) >> (N)) | ((X) << (32 - (N))))
+
+/** \brief
+
+	begin()
+
+	Resets the hash state. Call before the first update().
+*/
+
+void ATECCX08A_SHA256::begin()
+{
+  _state[0] = 0x6a09e667;
+  _state[1] = 0xbb67ae85;
+  _state[2] = 0x3c6ef372;
+  _state[3] = 0xa54ff53a;
+  _state[4] = 0x510e527f;
+  _state[5] = 0x9b05688c;
+  _state[6] = 0x1f83d9ab;
+  _state[7] = 0x5be0cd19;
+  _blockLength = 0;
+  _totalLength = 0;
+}
+
+/** \brief
+
+	update(const uint8_t *data, size_t length)
+
+	Adds length bytes of data to the hash. Can be called as many times as needed.
+*/
+
+void ATECCX08A_SHA256::update(const uint8_t *data, size_t length)
+{
+  _totalLength += length;
+
+  while (length)
+  {
+    size_t copyLength = SHA_BLOCK_SIZE - _blockLength;
+    if (copyLength > length)
+      copyLength = length;
+
+    memcpy(&_block[_blockLength], data, copyLength);
+    _blockLength += copyLength;
+    data += copyLength;
+    length -= copyLength;
+
+    if (_blockLength == SHA_BLOCK_SIZE)
+    {
+      compress();
+      _blockLength = 0;
+    }
+  }
+}
+
+/** \brief
+
+	finish(uint8_t *hash)
+
+	Pads the message, and writes the 32-byte digest into hash.
+*/
+
+void ATECCX08A_SHA256::finish(uint8_t *hash)
+{
+  uint32_t bitLengthHigh = _totalLength >> 29;
+  uint32_t bitLengthLow = _totalLength << 3;
+
+  _block[_blockLength++] = 0x80;
+
+  if (_blockLength > (SHA_BLOCK_SIZE - 8)) // no room left for the length, pad out this block
+  {
+    memset(&_block[_blockLength], 0, SHA_BLOCK_SIZE - _blockLength);
+    compress();
+    _blockLength = 0;
+  }
+
+  memset(&_block[_blockLength], 0, (SHA_BLOCK_SIZE - 8) - _blockLength);
+
+  for (int i = 0; i < 4; i++)
+  {
+    _block[SHA_BLOCK_SIZE - 8 + i] = (uint8_t)(bitLengthHigh >> (24 - 8 * i));
+    _block[SHA_BLOCK_SIZE - 4 + i] = (uint8_t)(bitLengthLow >> (24 - 8 * i));
+  }
+  compress();
+
+  for (int i = 0; i < 8; i++)
+  {
+    hash[4 * i + 0] = (uint8_t)(_state[i] >> 24);
+    hash[4 * i + 1] = (uint8_t)(_state[i] >> 16);
+    hash[4 * i + 2] = (uint8_t)(_state[i] >> 8);
+    hash[4 * i + 3] = (uint8_t)(_state[i]);
+  }
+}
+
+/** \brief
+
+	hash(const uint8_t *data, size_t length, uint8_t *hash)
+
+	Computes the SHA-256 digest of a complete message in one call.
+*/
+
+void ATECCX08A_SHA256::hash(const uint8_t *data, size_t length, uint8_t *hash)
+{
+  ATECCX08A_SHA256 sha;
+  sha.begin();
+  sha.update(data, length);
+  sha.finish(hash);
+}
+
+/** \brief
+
+	compress()
+
+	Runs the SHA-256 compression function over the 64 bytes in _block.
+	The message schedule is kept in a rolling 16-word window to save RAM on small MCUs.
+*/
+
+void ATECCX08A_SHA256::compress()
+{
+  uint32_t w[16];
+  uint32_t a = _state[0], b = _state[1], c = _state[2], d = _state[3];
+  uint32_t e = _state[4], f = _state[5], g = _state[6], h = _state[7];
+
+  for (int i = 0; i < 16; i++)
+  {
+    w[i] = ((uint32_t)_block[4 * i] << 24) | ((uint32_t)_block[4 * i + 1] << 16) |
+           ((uint32_t)_block[4 * i + 2] << 8) | ((uint32_t)_block[4 * i + 3]);
+  }
+
+  for (int i = 0; i < 64; i++)
+  {
+    if (i >= 16)
+    {
+      uint32_t w15 = w[(i + 1) & 0x0F];
+      uint32_t w2 = w[(i + 14) & 0x0F];
+      uint32_t s0 = SHA256_ROTR(w15, 7) ^ SHA256_ROTR(w15, 18) ^ (w15 >> 3);
+      uint32_t s1 = SHA256_ROTR(w2, 17) ^ SHA256_ROTR(w2, 19) ^ (w2 >> 10);
+      w[i & 0x0F] += s0 + w[(i + 9) & 0x0F] + s1;
+    }
+
+    uint32_t t1 = h + (SHA256_ROTR(e, 6) ^ SHA256_ROTR(e, 11) ^ SHA256_ROTR(e, 25)) +
+                  ((e & f) ^ (~e & g)) + pgm_read_dword(&sha256RoundConstants[i]) + w[i & 0x0F];
+    uint32_t t2 = (SHA256_ROTR(a, 2) ^ SHA256_ROTR(a, 13) ^ SHA256_ROTR(a, 22)) +
+                  ((a & b) ^ (a & c) ^ (b & c));
+
+    h = g;
+    g = f;
+    f = e;
+    e = d + t1;
+    d = c;
+    c = b;
+    b = a;
+    a = t1 + t2;
+  }
+
+  _state[0] += a; _state[1] += b; _state[2] += c; _state[3] += d;
+  _state[4] += e; _state[5] += f; _state[6] += g; _state[7] += h;
+}
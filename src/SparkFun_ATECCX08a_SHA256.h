@@ -0,0 +1,39 @@
+/*
+  This is a library written for the ATECCX08A Criptographic Co-Processor (QWIIC).
+
+  Software SHA-256, used by the library where a digest has to be computed on the
+  host side (e.g. to mirror a TempKey value that the IC calculated internally),
+  or where the IC's own SHA engine would disturb TempKey.
+
+  https://github.com/sparkfun/SparkFun_ATECCX08A_Arduino_Library
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "SparkFun_ATECCX08a_Arduino_Library.h"
+
+class ATECCX08A_SHA256 {
+  public:
+	void begin();
+	void update(const uint8_t *data, size_t length);
+	void finish(uint8_t *hash); // writes SHA256_SIZE bytes
+
+	// one-shot helper
+	static void hash(const uint8_t *data, size_t length, uint8_t *hash);
+
+  private:
+	uint32_t _state[8];
+	uint8_t _block[SHA_BLOCK_SIZE];
+	uint8_t _blockLength;
+	uint32_t _totalLength; // bytes hashed so far (messages are limited to 4GB)
+
+	void compress();
+};
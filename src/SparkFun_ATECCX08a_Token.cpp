@@ -0,0 +1,398 @@
+/*
+  This is a library written for the ATECCX08A Criptographic Co-Processor (QWIIC).
+
+  Streamed ES256 JWT and COSE_Sign1 signing, see SparkFun_ATECCX08a_Token.h
+
+  https://github.com/sparkfun/SparkFun_ATECCX08A_Arduino_Library
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "SparkFun_ATECCX08a_Token.h"
+
+static const char base64UrlDigits[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_";
+
+// COSE_Sign1 up to the payload: tag 18, array(4), protected = bstr(A1 01 26), unprotected = {}
+static const uint8_t coseSign1Prefix[] = { COSE_SIGN1_TAG, 0x84, 0x43, 0xA1, 0x01, COSE_ALG_ES256, 0xA0 };
+
+// Sig_structure up to the payload: array(4), "Signature1", protected, external_aad = bstr(0)
+static const uint8_t coseSigStructurePrefix[] = { 0x84, 0x6A, 'S', 'i', 'g', 'n', 'a', 't', 'u', 'r', 'e', '1', 0x43, 0xA1, 0x01, COSE_ALG_ES256, 0x40 };
+
+ATECCX08A_Token::ATECCX08A_Token(ATECCX08A &device) : _device(device)
+{
+}
+
+/** \brief
+
+	beginJWT(Print &out, uint16_t slot, const char *header)
+
+	Starts a JWT signed with the private key in slot: writes base64url(header) and the "."
+	to out. Then write() or print() the claims (JSON), and end() to sign.
+	header is the JOSE header JSON, e.g. with a "kid" added; "alg" must stay "ES256".
+*/
+
+bool ATECCX08A_Token::beginJWT(Print &out, uint16_t slot, const char *header)
+{
+  abort();
+  _out = &out;
+
+  return startJWT(slot, header);
+}
+
+/** \brief
+
+	beginJWT(char *buffer, size_t size, uint16_t slot, const char *header)
+
+	Same as beginJWT(Print &out, ...), but the token goes into buffer, NUL-terminated.
+	A token that does not fit (with its 86-character signature) fails in end().
+*/
+
+bool ATECCX08A_Token::beginJWT(char *buffer, size_t size, uint16_t slot, const char *header)
+{
+  abort();
+  if (size == 0)
+    return false;
+  _buffer = (uint8_t *)buffer;
+  _size = size - 1; // room for the NUL
+
+  return startJWT(slot, header);
+}
+
+/** \brief
+
+	beginCOSE(Print &out, size_t payloadLength, uint16_t slot)
+
+	Starts a COSE_Sign1 signed with the private key in slot. CBOR needs the payload length
+	up front: write() exactly payloadLength bytes, then end() to sign.
+*/
+
+bool ATECCX08A_Token::beginCOSE(Print &out, size_t payloadLength, uint16_t slot)
+{
+  abort();
+  _out = &out;
+
+  return startCOSE(payloadLength, slot);
+}
+
+bool ATECCX08A_Token::beginCOSE(uint8_t *buffer, size_t size, size_t payloadLength, uint16_t slot)
+{
+  abort();
+  _buffer = buffer;
+  _size = size;
+
+  return startCOSE(payloadLength, slot);
+}
+
+bool ATECCX08A_Token::start(uint8_t format, uint16_t slot)
+{
+  _length = 0;
+  _blockLength = 0;
+  _pendingLength = 0;
+  _failed = false;
+
+  // fails before anything is sent or written if the slot can not sign
+  if (!_device.slotAllows(slot, SLOT_ALLOW_SIGN) || !_device.sha256Begin())
+    return false;
+
+  _format = format;
+  _slot = slot;
+
+  return true;
+}
+
+bool ATECCX08A_Token::startJWT(uint16_t slot, const char *header)
+{
+  uint8_t separator = '.';
+
+  if (!start(TOKEN_JWT, slot))
+    return false;
+
+  encode((const uint8_t *)header, strlen(header), true);
+  encodeFlush(true);
+  output(&separator, 1, true);
+
+  return !_failed;
+}
+
+bool ATECCX08A_Token::startCOSE(size_t payloadLength, uint16_t slot)
+{
+  uint8_t header[5];
+  uint8_t headerLength = bstrHeader(payloadLength, header);
+
+  if (!start(TOKEN_COSE, slot))
+    return false;
+
+  _payloadLength = payloadLength;
+  _payloadWritten = 0;
+
+  output(coseSign1Prefix, sizeof(coseSign1Prefix), false);
+  hash(coseSigStructurePrefix, sizeof(coseSigStructurePrefix));
+  output(header, headerLength, true); // the payload bstr header is in both
+
+  return !_failed;
+}
+
+/** \brief
+
+	write(const uint8_t *data, size_t length)
+
+	Adds claims (JWT) or payload bytes (COSE) to the token, written out (and hashed) right away.
+	Returns false if the token has failed (output full, a SHA command failed, or more COSE
+	payload than declared). A failed token stays failed until the next begin*(), and the IC
+	is released as soon as it fails.
+*/
+
+bool ATECCX08A_Token::write(const uint8_t *data, size_t length)
+{
+  if ((_format == TOKEN_IDLE) || _failed)
+    return false;
+
+  if (_format == TOKEN_JWT)
+  {
+    encode(data, length, true);
+  }
+  else
+  {
+    if (length > (_payloadLength - _payloadWritten))
+    {
+      fail();
+      return false;
+    }
+    _payloadWritten += length;
+    output(data, length, true);
+  }
+
+  return !_failed;
+}
+
+bool ATECCX08A_Token::print(const char *text)
+{
+  return write((const uint8_t *)text, strlen(text));
+}
+
+/** \brief
+
+	end()
+
+	Finishes the hash on the IC, signs the digest with the slot's private key (NONCE + SIGN),
+	and writes the encoded signature after the token. Returns false if anything failed,
+	the token is not valid then (part of it may have been written to out already).
+*/
+
+bool ATECCX08A_Token::end()
+{
+  uint8_t format = _format;
+  uint8_t digest[SHA256_SIZE];
+  uint8_t signature[SIGNATURE_SIZE];
+
+  if (format == TOKEN_IDLE)
+    return false;
+
+  if (format == TOKEN_JWT)
+    encodeFlush(true);
+  else if (_payloadWritten != _payloadLength)
+    fail();
+
+  if (_failed)
+    return false;
+
+  _format = TOKEN_IDLE; // sha256End() ends the hash, even if it fails
+  if (!_device.sha256End(_block, _blockLength, digest) || !_device.createSignature(digest, _slot, signature))
+    return false;
+
+  if (format == TOKEN_JWT)
+  {
+    uint8_t separator = '.';
+    output(&separator, 1, false);
+    encode(signature, SIGNATURE_SIZE, false);
+    encodeFlush(false);
+    if (_buffer && !_failed)
+      _buffer[_length] = 0; // beginJWT() kept room for it
+  }
+  else
+  {
+    uint8_t header[2] = { 0x58, SIGNATURE_SIZE }; // bstr(64)
+    output(header, sizeof(header), false);
+    output(signature, SIGNATURE_SIZE, false);
+  }
+
+  return !_failed;
+}
+
+size_t ATECCX08A_Token::length()
+{
+  return _length;
+}
+
+/** \brief
+
+	abort()
+
+	Drops the token being built, and ends the hash on the IC so it can idle.
+	Whatever was already written to out stays there.
+*/
+
+void ATECCX08A_Token::abort()
+{
+  uint8_t digest[SHA256_SIZE];
+
+  if (_format != TOKEN_IDLE) // the hash on the IC is still open
+  {
+    _format = TOKEN_IDLE;
+    _device.sha256End(_block, 0, digest); // only to close the SHA context and the session
+  }
+
+  _out = NULL;
+  _buffer = NULL;
+  _size = 0;
+}
+
+// marks the token failed, and closes the hash on the IC right away,
+// so the session (and the lock, if set) is not left open until the next begin*() or abort()
+void ATECCX08A_Token::fail()
+{
+  _failed = true;
+  abort();
+}
+
+// writes data to the output, and to the SHA engine if it is part of the signed data
+void ATECCX08A_Token::output(const uint8_t *data, size_t length, bool hashed)
+{
+  if (_failed)
+    return;
+
+  if (_buffer)
+  {
+    if (length > (_size - _length))
+    {
+      fail();
+      return;
+    }
+    memcpy(&_buffer[_length], data, length);
+  }
+  else if (_out->write(data, length) != length)
+  {
+    fail();
+    return;
+  }
+
+  _length += length;
+
+  if (hashed)
+    hash(data, length);
+}
+
+// collects bytes for the SHA engine, and sends each full 64-byte block
+void ATECCX08A_Token::hash(const uint8_t *data, size_t length)
+{
+  while (length && !_failed)
+  {
+    size_t count = SHA_BLOCK_SIZE - _blockLength;
+    if (count > length)
+      count = length;
+
+    memcpy(&_block[_blockLength], data, count);
+    _blockLength += count;
+    data += count;
+    length -= count;
+
+    if (_blockLength == SHA_BLOCK_SIZE)
+    {
+      _blockLength = 0;
+      if (!_device.sha256Update(_block)) // closes the hash on the IC if it fails
+      {
+        _format = TOKEN_IDLE;
+        fail();
+      }
+    }
+  }
+}
+
+// base64url of data, keeping the last 1-2 bytes of an incomplete group for the next call
+void ATECCX08A_Token::encode(const uint8_t *data, size_t length, bool hashed)
+{
+  char characters[64];
+  uint8_t count = 0;
+  uint8_t group[3];
+
+  while ((_pendingLength + length) >= 3)
+  {
+    uint8_t i = 0;
+    for (; i < _pendingLength; i++)
+      group[i] = _pending[i];
+    for (; i < 3; i++, length--)
+      group[i] = *data++;
+    _pendingLength = 0;
+
+    characters[count++] = base64UrlDigits[group[0] >> 2];
+    characters[count++] = base64UrlDigits[((group[0] & 0x03) << 4) | (group[1] >> 4)];
+    characters[count++] = base64UrlDigits[((group[1] & 0x0F) << 2) | (group[2] >> 6)];
+    characters[count++] = base64UrlDigits[group[2] & 0x3F];
+
+    if (count == sizeof(characters))
+    {
+      output((const uint8_t *)characters, count, hashed);
+      count = 0;
+    }
+  }
+
+  if (count)
+    output((const uint8_t *)characters, count, hashed);
+
+  while (length--)
+    _pending[_pendingLength++] = *data++;
+}
+
+// the last 1 or 2 bytes, as 2 or 3 characters (base64url has no padding)
+void ATECCX08A_Token::encodeFlush(bool hashed)
+{
+  char characters[3];
+  uint8_t count = 0;
+
+  if (_pendingLength == 0)
+    return;
+
+  uint8_t second = (_pendingLength > 1) ? _pending[1] : 0;
+  characters[count++] = base64UrlDigits[_pending[0] >> 2];
+  characters[count++] = base64UrlDigits[((_pending[0] & 0x03) << 4) | (second >> 4)];
+  if (_pendingLength > 1)
+    characters[count++] = base64UrlDigits[(second & 0x0F) << 2];
+  _pendingLength = 0;
+
+  output((const uint8_t *)characters, count, hashed);
+}
+
+// CBOR byte string header (major type 2) for length, returns its size
+uint8_t ATECCX08A_Token::bstrHeader(size_t length, uint8_t *header)
+{
+  if (length < 24)
+  {
+    header[0] = 0x40 | length;
+    return 1;
+  }
+  if (length < 0x100)
+  {
+    header[0] = 0x58;
+    header[1] = length;
+    return 2;
+  }
+  if (length < 0x10000UL)
+  {
+    header[0] = 0x59;
+    header[1] = length >> 8;
+    header[2] = length & 0xFF;
+    return 3;
+  }
+  header[0] = 0x5A;
+  header[1] = (uint32_t)length >> 24;
+  header[2] = ((uint32_t)length >> 16) & 0xFF;
+  header[3] = (length >> 8) & 0xFF;
+  header[4] = length & 0xFF;
+  return 5;
+}
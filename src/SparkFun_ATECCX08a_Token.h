@@ -0,0 +1,94 @@
+/*
+  This is a library written for the ATECCX08A Criptographic Co-Processor (QWIIC).
+
+  ES256 token signing, streamed: JWT (RFC 7519, compact JWS) and COSE_Sign1 (RFC 8152).
+
+  The token is written out as it is built, and the signed part goes through the IC's SHA
+  engine on the way (64 bytes per SHA command), so there is no buffer for the whole token,
+  and no heap. Only the last 0-63 bytes for the SHA engine and 2 bytes of base64 are kept.
+  The output goes to a Print (e.g. a WiFiClient sending the HTTP request), or into a buffer.
+
+  JWT:   base64url(header) "." base64url(claims) "." base64url(signature)
+         beginJWT(out, slot);  print("{\"iss\":\"dev1\"}");  end();
+  COSE:  COSE_Sign1 with tag 18, protected header {alg: ES256}, no unprotected header
+         beginCOSE(out, payloadLength, slot);  write(payload, payloadLength);  end();
+
+  The signature is ECDSA P-256 with the private key in slot (SIGN external mode), as raw
+  r || s, as both formats want it. The IC stays awake from begin*() to end(), as the SHA
+  context does not survive idle: the whole token has to be written within one watchdog
+  window (~1.3 s), fine for the few hundred bytes of a typical token.
+
+  https://github.com/sparkfun/SparkFun_ATECCX08A_Arduino_Library
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "SparkFun_ATECCX08a_Arduino_Library.h"
+
+#define JWT_HEADER_ES256			"{\"alg\":\"ES256\",\"typ\":\"JWT\"}"
+
+#define COSE_SIGN1_TAG				0xD2 // CBOR tag 18
+#define COSE_ALG_ES256				0x26 // -7
+
+#define TOKEN_IDLE					0
+#define TOKEN_JWT					1
+#define TOKEN_COSE					2
+
+class ATECCX08A_Token {
+  public:
+	ATECCX08A_Token(ATECCX08A &device);
+
+	bool beginJWT(Print &out, uint16_t slot = 0x0000, const char *header = JWT_HEADER_ES256);
+	bool beginJWT(char *buffer, size_t size, uint16_t slot = 0x0000, const char *header = JWT_HEADER_ES256); // NUL-terminated by end()
+	bool beginCOSE(Print &out, size_t payloadLength, uint16_t slot = 0x0000);
+	bool beginCOSE(uint8_t *buffer, size_t size, size_t payloadLength, uint16_t slot = 0x0000);
+
+	bool write(const uint8_t *data, size_t length); // JWT claims (JSON) or COSE payload, in as many pieces as you like
+	bool print(const char *text);
+	bool end(); // signs, and writes the signature
+
+	size_t length(); // bytes written out so far
+	void abort(); // drops the token, and lets the IC idle
+
+  private:
+	ATECCX08A &_device;
+
+	uint8_t _format = TOKEN_IDLE;
+	uint16_t _slot = 0;
+	bool _failed = false;
+
+	// output
+	Print *_out = NULL;
+	uint8_t *_buffer = NULL;
+	size_t _size = 0;
+	size_t _length = 0;
+	void output(const uint8_t *data, size_t length, bool hashed);
+	void fail(); // _failed, and abort()
+
+	// data for the SHA engine, sent 64 bytes at a time
+	uint8_t _block[SHA_BLOCK_SIZE];
+	uint8_t _blockLength = 0;
+	void hash(const uint8_t *data, size_t length);
+
+	// base64url, 3 bytes in, 4 characters out, no padding
+	uint8_t _pending[2];
+	uint8_t _pendingLength = 0;
+	void encode(const uint8_t *data, size_t length, bool hashed);
+	void encodeFlush(bool hashed);
+
+	size_t _payloadLength = 0; // COSE, declared in beginCOSE()
+	size_t _payloadWritten = 0;
+
+	bool start(uint8_t format, uint16_t slot);
+	bool startJWT(uint16_t slot, const char *header);
+	bool startCOSE(size_t payloadLength, uint16_t slot);
+	static uint8_t bstrHeader(size_t length, uint8_t *header);
+};
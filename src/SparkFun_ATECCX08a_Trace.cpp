@@ -0,0 +1,461 @@
+/*
+  This is a library written for the ATECCX08A Criptographic Co-Processor (QWIIC).
+
+  I2C transaction trace and replay, see SparkFun_ATECCX08a_Trace.h
+
+  https://github.com/sparkfun/SparkFun_ATECCX08A_Arduino_Library
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "SparkFun_ATECCX08a_Trace.h"
+
+ATECCX08A_Trace::ATECCX08A_Trace(uint8_t *buffer, size_t size) : _buffer(buffer), _size(size)
+{
+}
+
+/** \brief
+
+	record()
+
+	Clears the buffer and records every transaction from now on (set it with ATECCX08A::setBus()).
+	Recording costs a few us per transaction, the bytes still go to the bus as they would without it.
+	Also ends a replay.
+*/
+
+void ATECCX08A_Trace::record()
+{
+  _start = 0;
+  _used = 0;
+  _transactions = 0;
+  _dropped = 0;
+  _replay = NULL;
+  _recording = true;
+}
+
+void ATECCX08A_Trace::stop()
+{
+  _recording = false;
+  _replay = NULL;
+}
+
+size_t ATECCX08A_Trace::length()
+{
+  return _used;
+}
+
+unsigned long ATECCX08A_Trace::transactions()
+{
+  return _transactions;
+}
+
+unsigned long ATECCX08A_Trace::droppedTransactions()
+{
+  return _dropped;
+}
+
+uint8_t ATECCX08A_Trace::write(TwoWire *port, uint8_t address, const uint8_t *data, uint8_t length)
+{
+  ATECCX08A_TraceRecord record;
+  unsigned long startMicros = micros();
+
+  if (_replay)
+  {
+    if (!nextRecord(TRACE_WRITE, address, length, &record))
+      return TRACE_REPLAY_FAILED;
+
+    if ((record.length != length) || (length && (memcmp(record.data, data, length) != 0)))
+      _mismatches++;
+
+    return record.result;
+  }
+
+  uint8_t result = ATECCX08A_Bus::write(port, address, data, length);
+
+  if (_recording)
+    append(TRACE_WRITE, address, startMicros, length, result, data, length);
+
+  return result;
+}
+
+uint8_t ATECCX08A_Trace::read(TwoWire *port, uint8_t address, uint8_t *data, uint8_t length)
+{
+  ATECCX08A_TraceRecord record;
+  unsigned long startMicros = micros();
+
+  if (_replay)
+  {
+    if (!nextRecord(TRACE_READ, address, length, &record))
+      return 0;
+
+    if (record.result > length) // more bytes than requested: not this transaction, and they would not fit
+    {
+      _diverged = true;
+      return 0;
+    }
+
+    memcpy(data, record.data, record.result);
+    return record.result;
+  }
+
+  uint8_t count = ATECCX08A_Bus::read(port, address, data, length);
+
+  if (_recording)
+    append(TRACE_READ, address, startMicros, length, count, data, count);
+
+  return count;
+}
+
+void ATECCX08A_Trace::append(uint8_t type, uint8_t address, unsigned long startMicros, uint8_t length, uint8_t result, const uint8_t *data, uint8_t dataLength)
+{
+  unsigned long gap = _transactions ? (startMicros - _lastMicros) : 0;
+  size_t size = 1 + 2 + dataLength;
+
+  _lastMicros = startMicros;
+  _transactions++;
+
+  for (unsigned long t = gap; t > 0x7F; t >>= 7)
+    size++;
+  size++;
+
+  if (size > _size)
+  {
+    _dropped++; // does not fit even in an empty buffer
+    return;
+  }
+
+  while ((_size - _used) < size)
+    dropOldest();
+
+  push(type | (address & TRACE_ADDRESS_MASK));
+  while (gap > 0x7F)
+  {
+    push((gap & 0x7F) | 0x80);
+    gap >>= 7;
+  }
+  push(gap);
+  push(length);
+  push(result);
+  for (uint8_t i = 0; i < dataLength; i++)
+    push(data[i]);
+}
+
+void ATECCX08A_Trace::push(uint8_t value)
+{
+  _buffer[(_start + _used) % _size] = value;
+  _used++;
+}
+
+uint8_t ATECCX08A_Trace::peek(size_t offset)
+{
+  return _buffer[(_start + offset) % _size];
+}
+
+// size of the record at offset, which must be the start of a record
+size_t ATECCX08A_Trace::recordSize(size_t offset)
+{
+  size_t size = 1;
+
+  while (peek(offset + size) & 0x80)
+    size++;
+  size++; // last byte of the time
+
+  uint8_t type = peek(offset) & TRACE_READ;
+  uint8_t length = peek(offset + size);
+  uint8_t result = peek(offset + size + 1);
+
+  return size + 2 + ((type == TRACE_READ) ? result : length);
+}
+
+void ATECCX08A_Trace::dropOldest()
+{
+  size_t size = recordSize(0);
+
+  _start = (_start + size) % _size;
+  _used -= size;
+  _dropped++;
+}
+
+/** \brief
+
+	copy(uint8_t *output, size_t maxLength)
+
+	Copies the trace out of the ring buffer, oldest record first: the format replay() takes.
+	Returns the number of bytes copied, 0 if the trace is longer than maxLength.
+*/
+
+size_t ATECCX08A_Trace::copy(uint8_t *output, size_t maxLength)
+{
+  if (_used > maxLength)
+    return 0;
+
+  for (size_t i = 0; i < _used; i++)
+    output[i] = peek(i);
+
+  return _used;
+}
+
+void ATECCX08A_Trace::dump(Print &out)
+{
+  uint8_t chunk[32];
+  size_t count = 0;
+
+  for (size_t i = 0; i < _used; i++)
+  {
+    chunk[count++] = peek(i);
+    if ((count == sizeof(chunk)) || (i == (_used - 1)))
+    {
+      out.write(chunk, count);
+      count = 0;
+    }
+  }
+}
+
+/** \brief
+
+	print(Print &out)
+
+	One line per recorded transaction, e.g.
+	  +1500 W 60 [8] 03 07 1B 00 00 00 24 CD -> 0
+	  +23140 R 60 [35/35] 23 8E 2A ...
+	The time is micros() since the previous transaction, the write result is endTransmission()
+	(0 = ACK, 2 = address NACK), and a read shows the bytes received / requested.
+*/
+
+void ATECCX08A_Trace::print(Print &out)
+{
+  static const char hexDigits[] = "0123456789ABCDEF";
+  char line[16 * 3]; // " AB" per byte
+  size_t offset = 0;
+
+  while (offset < _used)
+  {
+    uint8_t type = peek(offset) & TRACE_READ;
+    uint8_t address = peek(offset) & TRACE_ADDRESS_MASK;
+    unsigned long gap = 0;
+    size_t i = offset + 1;
+
+    for (uint8_t shift = 0; ; shift += 7)
+    {
+      uint8_t value = peek(i++);
+      gap |= (unsigned long)(value & 0x7F) << shift;
+      if (!(value & 0x80))
+        break;
+    }
+
+    uint8_t length = peek(i++);
+    uint8_t result = peek(i++);
+    uint8_t dataLength = (type == TRACE_READ) ? result : length;
+
+    out.print("+");
+    out.print(gap);
+    out.print((type == TRACE_READ) ? " R " : " W ");
+    out.print(address, HEX);
+    out.print(" [");
+    if (type == TRACE_READ)
+    {
+      out.print(result);
+      out.print("/");
+    }
+    out.print(length);
+    out.print("]");
+
+    size_t lineLength = 0;
+    for (uint8_t j = 0; j < dataLength; j++)
+    {
+      uint8_t value = peek(i++);
+      line[lineLength++] = ' ';
+      line[lineLength++] = hexDigits[value >> 4];
+      line[lineLength++] = hexDigits[value & 0x0F];
+      if ((lineLength == sizeof(line)) || (j == (dataLength - 1)))
+      {
+        out.write((const uint8_t *)line, lineLength);
+        lineLength = 0;
+      }
+    }
+
+    if (type == TRACE_WRITE)
+    {
+      out.print(" -> ");
+      out.print(result);
+    }
+    out.println();
+
+    offset = i;
+  }
+}
+
+/** \brief
+
+	printArray(Print &out, const char *label)
+
+	Prints the trace as a C array, to paste into a sketch or a host test and replay() it there.
+*/
+
+void ATECCX08A_Trace::printArray(Print &out, const char *label)
+{
+  static const char hexDigits[] = "0123456789ABCDEF";
+  char line[16 * 6 + 2]; // "0xAB, " per byte, plus CR LF
+  size_t lineLength = 0;
+
+  out.print("const uint8_t ");
+  out.print(label);
+  out.print("[");
+  out.print((unsigned long)_used);
+  out.println("] = {");
+
+  for (size_t i = 0; i < _used; i++)
+  {
+    uint8_t value = peek(i);
+
+    line[lineLength++] = '0';
+    line[lineLength++] = 'x';
+    line[lineLength++] = hexDigits[value >> 4];
+    line[lineLength++] = hexDigits[value & 0x0F];
+    if (i != (_used - 1))
+    {
+      line[lineLength++] = ',';
+      line[lineLength++] = ' ';
+    }
+
+    if (((i + 1) % 16 == 0) || (i == (_used - 1))) // end of line, send it
+    {
+      line[lineLength++] = '\r';
+      line[lineLength++] = '\n';
+      out.write((const uint8_t *)line, lineLength);
+      lineLength = 0;
+    }
+  }
+
+  out.println("};");
+}
+
+/** \brief
+
+	parseRecord(const uint8_t *trace, size_t length, size_t *offset, ATECCX08A_TraceRecord *record)
+
+	Decodes the record at *offset in a copied trace, and moves *offset to the next one.
+	Returns false at the end of the trace, or if the record is cut short.
+	record->data points into trace.
+*/
+
+bool ATECCX08A_Trace::parseRecord(const uint8_t *trace, size_t length, size_t *offset, ATECCX08A_TraceRecord *record)
+{
+  size_t i = *offset;
+
+  if (i >= length)
+    return false;
+
+  record->type = trace[i] & TRACE_READ;
+  record->address = trace[i] & TRACE_ADDRESS_MASK;
+  i++;
+
+  record->micros = 0;
+  for (uint8_t shift = 0; ; shift += 7)
+  {
+    if ((i >= length) || (shift >= (7 * TRACE_MAX_TIME_SIZE)))
+      return false;
+    record->micros |= (unsigned long)(trace[i] & 0x7F) << shift;
+    if (!(trace[i++] & 0x80))
+      break;
+  }
+
+  if ((i + 2) > length)
+    return false;
+  record->length = trace[i++];
+  record->result = trace[i++];
+
+  uint8_t dataLength = (record->type == TRACE_READ) ? record->result : record->length;
+  if ((i + dataLength) > length)
+    return false;
+  record->data = &trace[i];
+
+  *offset = i + dataLength;
+  return true;
+}
+
+/** \brief
+
+	replay(const uint8_t *trace, size_t length)
+
+	From now on, the library's transactions are served from trace (as copy() or printArray()
+	made it) instead of the bus. Writes return the recorded endTransmission() result, reads
+	return the recorded bytes. Nothing goes to the bus.
+	If the library does a transaction that is not the next one in the trace (other direction,
+	address or read length, or a read record with more bytes than requested), the replay has
+	diverged: that and every later transaction fails.
+	Ends a recording, record() or stop() end the replay.
+*/
+
+void ATECCX08A_Trace::replay(const uint8_t *trace, size_t length)
+{
+  _recording = false;
+  _replay = trace;
+  _replayLength = length;
+  _replayOffset = 0;
+  _diverged = false;
+  _mismatches = 0;
+  _timingError = 0;
+  _timingDrift = 0;
+}
+
+// takes the next record for a transaction of type, and checks its timing
+bool ATECCX08A_Trace::nextRecord(uint8_t type, uint8_t address, uint8_t length, ATECCX08A_TraceRecord *record)
+{
+  unsigned long now = micros();
+  bool first = (_replayOffset == 0);
+
+  if (_diverged)
+    return false;
+
+  if (!parseRecord(_replay, _replayLength, &_replayOffset, record) || (record->type != type) || (record->address != address)
+    || ((type == TRACE_READ) && (record->length != length)))
+  {
+    _diverged = true;
+    return false;
+  }
+
+  if (!first) // the first record has no gap to compare
+  {
+    long difference = (long)(now - _lastMicros) - (long)record->micros;
+    unsigned long error = (difference < 0) ? -difference : difference;
+
+    _timingDrift += difference;
+    if (error > _timingError)
+      _timingError = error;
+  }
+  _lastMicros = now;
+
+  return true;
+}
+
+bool ATECCX08A_Trace::replayFinished()
+{
+  return (_replay != NULL) && (_replayOffset >= _replayLength);
+}
+
+bool ATECCX08A_Trace::diverged()
+{
+  return _diverged;
+}
+
+unsigned long ATECCX08A_Trace::mismatches()
+{
+  return _mismatches;
+}
+
+unsigned long ATECCX08A_Trace::timingError()
+{
+  return _timingError;
+}
+
+long ATECCX08A_Trace::timingDrift()
+{
+  return _timingDrift;
+}
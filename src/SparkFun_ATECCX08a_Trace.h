@@ -0,0 +1,111 @@
+/*
+  This is a library written for the ATECCX08A Criptographic Co-Processor (QWIIC).
+
+  I2C transaction trace: records every bus transaction of the library into a ring buffer,
+  and replays a recorded trace in place of the IC.
+
+  Recording: atecc.setBus(&trace) and trace.record(). Each transaction (wake, idle, sleep,
+  command, response read) is one record, the oldest records make room for new ones when
+  the buffer is full. Dump the trace with print() (readable), printArray() (a C array, to
+  paste into a sketch or a host test) or dump() (raw bytes).
+
+  Replaying: trace.replay(recorded, length) serves the library's transactions from the
+  recorded trace instead of the bus, so an intermittent count or CRC error seen in the
+  field runs through the exact same code path on the bench (or on a host, see
+  extras/host_test/trace.cpp), without the IC. Every write is compared with the recorded one, and the time
+  between transactions with the recorded time, see mismatches() and timingError().
+  The replay has to start from the same point as the recording (e.g. both before begin()).
+  A trace of a known good run also works as a timing fixture: timingDrift() shows how much
+  slower (or faster) the library runs through it than it did when it was recorded.
+
+  Record layout (all records back to back, oldest first):
+    0     TRACE_WRITE or TRACE_READ, ORed with the 7-bit address
+    1-    micros() since the previous record, 7 bits per byte, LSB first, bit 7 = more bytes
+    +0    length: bytes written, or bytes requested
+    +1    result: endTransmission() (0 = ACK) for a write, bytes received for a read
+    +2-   the bytes written, or the bytes received
+
+  https://github.com/sparkfun/SparkFun_ATECCX08A_Arduino_Library
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "SparkFun_ATECCX08a_Arduino_Library.h"
+
+#define TRACE_WRITE					0x00
+#define TRACE_READ					0x80
+#define TRACE_ADDRESS_MASK			0x7F
+#define TRACE_MAX_TIME_SIZE			5 // 32-bit micros() in 7-bit groups
+
+#define TRACE_REPLAY_FAILED			4 // endTransmission() result once a replay went off the trace ("other error")
+
+typedef struct {
+  uint8_t type; // TRACE_WRITE or TRACE_READ
+  uint8_t address;
+  unsigned long micros; // since the previous record
+  uint8_t length; // written or requested
+  uint8_t result; // endTransmission() for a write, bytes received for a read
+  const uint8_t *data; // length (write) or result (read) bytes
+} ATECCX08A_TraceRecord;
+
+class ATECCX08A_Trace : public ATECCX08A_Bus {
+  public:
+	ATECCX08A_Trace(uint8_t *buffer, size_t size); // ring buffer for recording, not used for replay
+
+	// recording
+	void record(); // starts recording into an empty buffer
+	void stop(); // transactions go straight to the bus, the trace is kept
+	size_t length(); // bytes of trace in the buffer
+	unsigned long transactions(); // recorded since record(), including dropped ones
+	unsigned long droppedTransactions(); // overwritten to make room
+	size_t copy(uint8_t *output, size_t maxLength); // the trace, oldest record first, as replay() takes it
+	void dump(Print &out); // raw bytes, as copy()
+	void print(Print &out); // one line per transaction
+	void printArray(Print &out, const char *label = "trace"); // uint8_t label[] = { ... };
+
+	// replay
+	void replay(const uint8_t *trace, size_t length); // from now on, transactions come from trace
+	bool replayFinished(); // every record was used
+	bool diverged(); // the library did a transaction the trace does not have, it failed from then on
+	unsigned long mismatches(); // writes with other bytes than recorded
+	unsigned long timingError(); // worst difference (us) between a gap in the replay and the recorded gap
+	long timingDrift(); // replay time minus recorded time (us), from the first transaction to the last
+
+	static bool parseRecord(const uint8_t *trace, size_t length, size_t *offset, ATECCX08A_TraceRecord *record);
+
+	// ATECCX08A_Bus
+	uint8_t write(TwoWire *port, uint8_t address, const uint8_t *data, uint8_t length);
+	uint8_t read(TwoWire *port, uint8_t address, uint8_t *data, uint8_t length);
+
+  private:
+	uint8_t *_buffer;
+	size_t _size;
+	size_t _start = 0; // oldest record
+	size_t _used = 0;
+	bool _recording = false;
+	unsigned long _lastMicros = 0;
+	unsigned long _transactions = 0;
+	unsigned long _dropped = 0;
+	void append(uint8_t type, uint8_t address, unsigned long startMicros, uint8_t length, uint8_t result, const uint8_t *data, uint8_t dataLength);
+	void push(uint8_t value);
+	uint8_t peek(size_t offset); // offset from the oldest record
+	size_t recordSize(size_t offset);
+	void dropOldest();
+
+	const uint8_t *_replay = NULL;
+	size_t _replayLength = 0;
+	size_t _replayOffset = 0;
+	bool _diverged = false;
+	unsigned long _mismatches = 0;
+	unsigned long _timingError = 0;
+	long _timingDrift = 0;
+	bool nextRecord(uint8_t type, uint8_t address, uint8_t length, ATECCX08A_TraceRecord *record);
+};